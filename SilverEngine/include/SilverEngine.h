@@ -11,6 +11,7 @@
 #include "core/physics3D.h"
 #include "core/particles.h"
 #include "core/event_system.h"
+#include "core/texture.h"
 
 #include "debug/console.h"
 #include "debug/editor.h"
@@ -31,6 +31,9 @@ namespace sv {
 	constexpr u32 ASSET_TYPE_EXTENSION_MAX = 7u;
 	constexpr u32 ASSET_NAME_SIZE = 20u;
 
+	// Called when the last reference of an asset is released, from any thread
+	SV_API void _asset_unreferenced(void* ptr);
+
 	struct SV_API AssetPtr {
 
 		AssetPtr() = default;
@@ -45,7 +48,7 @@ namespace sv {
 	    {
 			if (ptr) {
 				std::atomic<i32>* ref = reinterpret_cast<std::atomic<i32>*>(ptr);
-				ref->fetch_add(-1);
+				if (ref->fetch_add(-1) == 1) _asset_unreferenced(ptr);
 				ptr = nullptr;
 			}
 	    }
@@ -63,7 +66,7 @@ namespace sv {
 	    {
 			if (ptr) {
 				std::atomic<i32>* ref = reinterpret_cast<std::atomic<i32>*>(ptr);
-				ref->fetch_add(-1);
+				if (ref->fetch_add(-1) == 1) _asset_unreferenced(ptr);
 			}
 
 			ptr = other.ptr;
@@ -86,7 +89,7 @@ namespace sv {
 	    {
 			if (ptr) {
 				std::atomic<i32>* ref = reinterpret_cast<std::atomic<i32>*>(ptr);
-				ref->fetch_add(-1);
+				if (ref->fetch_add(-1) == 1) _asset_unreferenced(ptr);
 			}
 
 			ptr = other.ptr;
@@ -105,6 +108,7 @@ namespace sv {
 	void _initialize_assets();
     void _close_assets();
     void _update_assets();
+	void _wait_assets(); // Finish all the assets that are loading
 
     SV_API bool create_asset(AssetPtr& asset_ptr, const char* type, const char* name = NULL);
 	SV_API bool create_asset_from_name(AssetPtr& asset_ptr, const char* type, const char* name);
@@ -117,7 +121,9 @@ namespace sv {
 
     // Load the asset if exists and use the extension to determine how this file should be treated
     // If it is in use simply get the existing asset
-    SV_API bool load_asset_from_file(AssetPtr& asset_ptr, const char* filepath, AssetLoadingPriority priority = AssetLoadingPriority_KeepItLoading);
+	// With KeepItLoading the file is loaded in a worker thread, the content is NULL until the asset is ready.
+	// The callers that can handle it have to ask for it explicitly
+    SV_API bool load_asset_from_file(AssetPtr& asset_ptr, const char* filepath, AssetLoadingPriority priority = AssetLoadingPriority_RightNow);
 
 	SV_API bool        set_asset_name(AssetPtr& asset_ptr, const char* name);
 	SV_API const char* get_asset_name(const AssetPtr& asset_ptr);
@@ -128,11 +134,27 @@ namespace sv {
     SV_API const char* get_asset_filepath(const AssetPtr& asset_ptr);
 	SV_API const char* get_asset_type(const AssetPtr& asset_ptr);
 	SV_API bool is_asset_created_from_name(const AssetPtr& asset_ptr);
+	SV_API bool asset_is_ready(const AssetPtr& asset_ptr);
+
+	// Dispatched as "asset_loaded" when an asynchronous load finishes
+	struct AssetLoadedEvent {
+		AssetPtr    asset_ptr;
+		const char* filepath;
+		bool        success;
+	};
 
     typedef bool(*AssetCreateFn)(void* asset, const char* name);
     typedef bool(*AssetLoadFileFn)(void* asset, const char* name, const char* filepath);
     typedef bool(*AssetReloadFileFn)(void* asset, const char* name, const char* filepath);
     typedef bool(*AssetFreeFn)(void* asset, const char* name);
+	// Executed in a worker thread, returns the file data or NULL if fails
+	typedef void*(*AssetPrepareFileFn)(const char* filepath);
+	// Executed in the main thread, creates the asset from the prepared data and frees it
+	typedef bool(*AssetLoadPreparedFn)(void* asset, const char* name, const char* filepath, void* prepared);
+	// Adds the assets used by this asset, used to prefetch them
+	typedef void(*AssetDependenciesFn)(void* asset, List<AssetPtr>& dependencies);
+	// Returns the memory owned by the asset, the asset size is added by the system
+	typedef void(*AssetSizeFn)(void* asset, size_t* cpu_size, size_t* gpu_size);
 
     struct AssetTypeDesc {
 	
@@ -145,6 +167,11 @@ namespace sv {
 		AssetReloadFileFn reload_file_fn;
 		AssetFreeFn	      free_fn;
 		f32		          unused_time;
+		// Optional, used to load the asset asynchronously
+		AssetPrepareFileFn  prepare_file_fn = nullptr;
+		AssetLoadPreparedFn load_prepared_fn = nullptr;
+		AssetDependenciesFn dependencies_fn = nullptr;
+		AssetSizeFn         size_fn = nullptr;
 
     };
 
@@ -153,6 +180,68 @@ namespace sv {
     SV_API void update_asset_files();
     SV_API void free_unused_assets();
 
+	// Memory residency
+	// The budgets are in bytes, 0 means no budget. Without budget the unreferenced assets are freed after the unused time.
+	// With budget they are kept until the budget is exceeded, then the least recently used are freed
+
+	struct AssetTypeResidency {
+		const char* type_name;
+		u32         asset_count;
+		u32         unreferenced_count;
+		size_t      cpu_size;
+		size_t      gpu_size;
+		size_t      cpu_budget;
+		size_t      gpu_budget;
+	};
+
+	SV_API bool asset_type_set_budget(const char* type, size_t cpu_budget, size_t gpu_budget);
+	// Returns the number of types written
+	SV_API u32  asset_residency_report(AssetTypeResidency* report, u32 max_count);
+	SV_API void asset_residency_log();
+
+	// Telemetry
+	// The loads are measured per type and per filepath, the filepath records are kept after the asset is freed.
+	// The times are in seconds: read is the time reported by the type callbacks with asset_telemetry_read,
+	// decode is the rest of the file preparation and gpu is the creation from the prepared data in the main thread.
+	// The types without prepare function are loaded in one call, the gpu creation is included in the decode time
+
+	struct AssetTelemetry {
+		const char* type_name;
+		const char* filepath; // NULL in the type records
+		u32         load_count;
+		u32         failed_count;
+		u32         hit_count; // Requests found in the filepath table
+		u32         miss_count; // Requests that started a load
+		u32         eviction_count;
+		u64         read_bytes;
+		f64         read_time;
+		f64         decode_time;
+		f64         gpu_time;
+	};
+
+	// Called from the load and prepare callbacks, adds the time spent reading the file to the current load
+	SV_API void asset_telemetry_read(f64 time, size_t bytes);
+
+	SV_API u32  asset_telemetry_types(AssetTelemetry* telemetry, u32 max_count);
+	SV_API u32  asset_telemetry_asset_count();
+	// Sorted by total load time, the slowest first. The filepaths are valid until the next reset
+	SV_API u32  asset_telemetry_assets(AssetTelemetry* telemetry, u32 max_count);
+	SV_API void asset_telemetry_reset();
+	SV_API void asset_telemetry_log(u32 count); // Logs the types and the slowest assets
+	SV_API bool asset_telemetry_dump(const char* filepath); // The format depends on the extension: .csv or .json
+
+	// Dependency graph
+	// While recording, all the assets serialized with serialize_asset (and their dependencies) are saved.
+	// The list is serialized at the end and can be used to load all the assets in parallel
+	// before they are needed
+
+	SV_API void asset_dependencies_record_begin();
+	SV_API void asset_dependencies_record_end(Serializer& s);
+	SV_API void asset_dependency_record(const AssetPtr& asset_ptr);
+	
+	// Loads all the dependencies with KeepItLoading priority and logs the total time when they are ready
+	SV_API void asset_dependencies_prefetch(Deserializer& d, const char* name);
+
     SV_INLINE void serialize_asset(Serializer& s, const AssetPtr& asset_ptr)
     {
 		constexpr u32 VERSION = 1u;
@@ -163,6 +252,7 @@ namespace sv {
 		else {
 			
 			serialize_bool(s, true);
+			asset_dependency_record(asset_ptr);
 			
 			const char* filepath = get_asset_filepath(asset_ptr);
 
@@ -205,7 +295,38 @@ namespace sv {
 		}
     }
 
-    SV_INLINE void deserialize_asset(Deserializer& d, AssetPtr& asset_ptr, AssetLoadingPriority priority = AssetLoadingPriority_KeepItLoading)
+	// Deferred requests: while a list is bound to the calling thread, deserialize_asset records the requests
+	// instead of executing them. Used to deserialize in worker threads, then the list is executed in the main thread.
+	// The AssetPtr must stay in the same address until the requests are executed
+	
+	struct AssetRequest {
+		AssetPtr*            asset_ptr;
+		AssetLoadingPriority priority;
+		bool                 from_name; // With from_name, filepath contains the asset type
+		char                 filepath[FILEPATH_SIZE + 1u];
+		char                 name[ASSET_NAME_SIZE + 1u];
+	};
+
+	SV_API void asset_requests_bind(List<AssetRequest>* requests); // NULL to unbind
+	SV_API bool asset_request_defer(AssetPtr& asset_ptr, const char* filepath, const char* name, AssetLoadingPriority priority, bool from_name);
+	SV_API void asset_requests_execute(const AssetRequest* requests, u32 count);
+
+	// The asset is not loaded if asset_ptr is NULL
+	SV_INLINE void _deserialize_asset_from_file(AssetPtr* asset_ptr, const char* filepath, const char* name, AssetLoadingPriority priority)
+	{
+		if (asset_ptr == NULL || asset_request_defer(*asset_ptr, filepath, name, priority, false))
+			return;
+		
+		if (!load_asset_from_file(*asset_ptr, filepath, priority)) {
+			SV_LOG_ERROR("Can't load the asset '%s'", filepath);
+		}
+
+		if (name && !set_asset_name(*asset_ptr, name)) {
+			SV_LOG_ERROR("Can't set the asset name '%s'", name);
+		}
+	}
+
+    SV_INLINE void _deserialize_asset(Deserializer& d, AssetPtr* asset_ptr, AssetLoadingPriority priority)
     {
 		u32 version;
 		deserialize_u32(d, version);
@@ -227,15 +348,12 @@ namespace sv {
 
 				deserialize_string(d, filepath, FILEPATH_SIZE + 1u);
 
-				if (!load_asset_from_file(asset_ptr, filepath, priority)) {
-					SV_LOG_ERROR("Can't load the asset '%s'", filepath);
-				}
-
 				bool has_name;
 				deserialize_bool(d, has_name);
 
+				char name[ASSET_NAME_SIZE + 1u];
+
 				if (has_name) {
-					char name[ASSET_NAME_SIZE + 1u];
 
 					size_t size = deserialize_string_size(d);
 
@@ -244,11 +362,9 @@ namespace sv {
 					}
 
 					deserialize_string(d, name, ASSET_NAME_SIZE + 1u);
-
-					if (!set_asset_name(asset_ptr, name)) {
-						SV_LOG_ERROR("Can't set the asset name '%s'", name);
-					}
 				}
+
+				_deserialize_asset_from_file(asset_ptr, filepath, has_name ? name : NULL, priority);
 			}
 		}
 		else if (version == 1u) {
@@ -268,15 +384,12 @@ namespace sv {
 					char filepath[FILEPATH_SIZE + 1u];
 					deserialize_string(d, filepath, FILEPATH_SIZE + 1u);
 
-					if (!load_asset_from_file(asset_ptr, filepath, priority)) {
-						SV_LOG_ERROR("Can't load the asset '%s'", filepath);
-					}
-
 					bool has_name;
 					deserialize_bool(d, has_name);
 
+					char name[ASSET_NAME_SIZE + 1u];
+
 					if (has_name) {
-						char name[ASSET_NAME_SIZE + 1u];
 
 						size_t size = deserialize_string_size(d);
 
@@ -285,11 +398,9 @@ namespace sv {
 						}
 
 						deserialize_string(d, name, ASSET_NAME_SIZE + 1u);
-
-						if (!set_asset_name(asset_ptr, name)) {
-							SV_LOG_ERROR("Can't set the asset name '%s'", name);
-						}
 					}
+
+					_deserialize_asset_from_file(asset_ptr, filepath, has_name ? name : NULL, priority);
 				}
 				break;
 
@@ -301,7 +412,10 @@ namespace sv {
 					deserialize_string(d, name, ASSET_NAME_SIZE + 1u);
 					deserialize_string(d, type, ASSET_TYPE_NAME_SIZE + 1u);
 
-					if (!create_asset_from_name(asset_ptr, type, name)) {
+					if (asset_ptr == NULL || asset_request_defer(*asset_ptr, type, name, priority, true))
+						break;
+
+					if (!create_asset_from_name(*asset_ptr, type, name)) {
 						SV_LOG_ERROR("Can't create asset from name '%s'", name);
 					}
 				}
@@ -312,4 +426,15 @@ namespace sv {
 		}
     }
 
+    SV_INLINE void deserialize_asset(Deserializer& d, AssetPtr& asset_ptr, AssetLoadingPriority priority = AssetLoadingPriority_RightNow)
+    {
+		_deserialize_asset(d, &asset_ptr, priority);
+    }
+
+	// Reads the asset reference without loading it
+    SV_INLINE void deserialize_asset_skip(Deserializer& d)
+    {
+		_deserialize_asset(d, NULL, AssetLoadingPriority_KeepItLoading);
+    }
+
 }
@@ -56,7 +56,11 @@ namespace sv {
     void _engine_initialize_project(const char* project_path);
     void _engine_close_project();
     
-    void _engine_reset_game(const char* scene = "");
+    struct SceneSnapshot;
+
+    // The game is closed and initialized in the next frame, reloading the plugins.
+    // With snapshot the ECS is restored from it instead of loading the scene file
+    void _engine_reset_game(const char* scene = "", const SceneSnapshot* snapshot = NULL);
 #endif
     
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "platform/graphics.h"
+#include "platform/os.h"
 #include "utils/string.h"
 
 namespace sv {
@@ -9,6 +10,8 @@ namespace sv {
     constexpr u32 MATERIAL_NAME_SIZE = 100u;
 
     typedef u32 MeshIndex;
+
+	constexpr u32 MESH_LOD_MAX = 4u;
     
     struct MeshVertex {
 		v3_f32 position;
@@ -17,6 +20,14 @@ namespace sv {
 		v2_f32 texcoord;
     };
 
+	// The levels share the vertex buffer. The vertices are sorted coarse first, so a level only uses the first vertex_count vertices
+	struct MeshLod {
+		u32 index_offset; // Offset in the index buffer
+		u32 index_count;
+		u32 vertex_count;
+		f32 screen_size; // Min projected size (relative to the screen height) that uses this level
+	};
+
     struct Mesh {
 
 		List<v3_f32> positions;
@@ -26,9 +37,22 @@ namespace sv {
 
 		List<MeshIndex> indices;
 
+		// Simplified levels, the index buffer contains the lod indices (coarse first) followed by the mesh indices
+		List<MeshIndex> lod_indices;
+		MeshLod lods[MESH_LOD_MAX];
+		u32 lod_count = 0u; // The level 0 is the full mesh. If there are no levels is 0
+
+		v3_f32 bounds_center;
+		f32 bounds_radius = 0.f;
+
 		GPUBuffer* vbuffer = nullptr;
 		GPUBuffer* ibuffer = nullptr;
 
+		// Set when the buffers are created. The cpu data is empty if the mesh is created from a binary file outside the editor
+		u32 vertex_count = 0u;
+		u32 index_offset = 0u; // Full mesh range in the index buffer
+		u32 index_count = 0u;
+
 		// Info about the importation of the 3D Model
 
 		XMMATRIX model_transform_matrix = XMMatrixIdentity();
@@ -70,10 +94,16 @@ namespace sv {
     SV_API void mesh_calculate_normals(Mesh& mesh);
 	SV_API void mesh_calculate_tangents(Mesh& mesh);
 	SV_API void mesh_recalculate_normals_and_tangents(Mesh& mesh);
+	SV_API void mesh_calculate_bounds(Mesh& mesh);
+
+	// Quadric error metric simplification. Each level has about half the triangles of the previous one
+	SV_API void mesh_generate_lods(Mesh& mesh, u32 lod_count = MESH_LOD_MAX);
+	SV_API u32  mesh_select_lod(const Mesh& mesh, f32 screen_size);
 
     SV_API bool mesh_create_buffers(Mesh& mesh, ResourceUsage usage = ResourceUsage_Static);
     SV_API bool mesh_update_buffers(Mesh& mesh, CommandList cmd);
 	SV_API void mesh_destroy_buffers(Mesh& mesh);
+    SV_API bool mesh_is_resident(const Mesh& mesh); // The buffers exist and the async upload is completed
     SV_API void mesh_clear(Mesh& mesh);
 
     // Model loading
@@ -125,18 +155,55 @@ namespace sv {
 		char folderpath[FILEPATH_SIZE + 1u];
 		List<MeshInfo> meshes;
 		List<MaterialInfo> materials;
+		bool compress_meshes = false;
     };
 
-    // Load external model format
+    // Load external model format. The .obj files are parsed in parallel by chunks of lines
     SV_API bool load_model(const char* filepath, ModelInfo& model_info);
 
     // Create asset files for the engine
     SV_API bool import_model(const char* filepath, const ModelInfo& model_info);
 
-	SV_API bool save_mesh(const Mesh& mesh, const char* filepath);
+	SV_API bool save_mesh(const Mesh& mesh, const char* filepath, bool compress = false);
     SV_API bool save_material(const Material& material, const char* filepath);
 
     SV_API bool load_mesh(Mesh& mesh, const char* filepath);
     SV_API bool load_material(Material& material, const char* filepath);
+    SV_API bool load_material(Material& material, Deserializer& d); // The deserializer must be started
+
+	// Content of a material file without loading the textures, it can be read in a worker thread
+	struct MaterialFile {
+		Material material;
+		char     diffuse_map[FILEPATH_SIZE + 1u];
+		char     normal_map[FILEPATH_SIZE + 1u];
+		char     specular_map[FILEPATH_SIZE + 1u];
+		char     emissive_map[FILEPATH_SIZE + 1u];
+	};
+
+	SV_API bool read_material(MaterialFile& file, Deserializer& d);
+	SV_API void load_material_textures(Material& material, const MaterialFile& file, AssetLoadingPriority priority);
+
+	// Binary mesh file, the vertices (MeshVertex) and the indices are stored as they are uploaded to the GPU.
+	// The file is memory mapped, the blobs are copied to the GPU without any per vertex work
+	// The compressed mesh files are decompressed to an owned buffer, the rest are mapped
+	struct MeshFile {
+		FileMapping mapping;
+		u8* _decompressed = NULL;
+		const void* header;
+		const MeshVertex* vertices;
+		const MeshIndex* indices;
+		u32 vertex_count;
+		u32 index_count;
+	};
+
+	SV_API bool mesh_file_open(MeshFile& file, const char* filepath); // Returns false if the file is not a valid binary mesh
+	SV_API void mesh_file_close(MeshFile& file);
+	SV_API void mesh_file_prefetch(const MeshFile& file); // Touches the mapped pages, call it from a worker thread
+	SV_API bool mesh_create_from_file(Mesh& mesh, const MeshFile& file, const char* filepath, bool cpu_data);
+
+	SV_API bool mesh_load_benchmark(const char* folderpath); // Compares the load time of the binary and the legacy mesh formats
+	// Compares the .obj text scanning and float parsing with the legacy byte loops and atof,
+	// and validates that the parallel importer produces the same data as the serial one
+	SV_API bool model_load_benchmark(const char* filepath);
 
 }
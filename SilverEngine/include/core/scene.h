@@ -55,10 +55,24 @@ namespace sv {
     SV_API SceneData* get_scene_data();
 
     SV_API bool set_scene(const char* name);
+    // Without arguments the scene file keeps its format. The compressed scenes are written in memory, not streamed
     SV_API bool save_scene();
-    SV_API bool save_scene(const char* filepath);
+    SV_API bool save_scene(const char* filepath, bool compress = false);
     SV_API bool clear_scene();
 
+    // Logs the size and the save/load times of the scene formats, the current entities are replaced
+    SV_API void scene_serialize_benchmark(u32 entity_count);
+
+    // In memory copy of the current scene, used to reset the play mode without reading the scene file.
+    // The entity arrays, hierarchy and component pools are copied as blocks, the asset references are shared.
+    // The components that own physics, audio or GPU objects are serialized and recreated in the restore.
+    // The restore fails if the scene or the component registers changed, without scene it's restored in a new one
+    struct SceneSnapshot;
+
+    SV_API SceneSnapshot* scene_snapshot_capture();
+    SV_API bool           scene_snapshot_restore(const SceneSnapshot* snapshot);
+    SV_API void           scene_snapshot_free(SceneSnapshot* snapshot);
+
     SV_API const char* get_scene_name();
     SV_API bool there_is_scene();
 
@@ -108,6 +122,7 @@ namespace sv {
     SV_API u32	       get_entity_childs_count(Entity parent);
     SV_API void	       get_entity_childs(Entity parent, Entity const** childsArray);
     SV_API Entity      get_entity_parent(Entity entity);
+	SV_API Prefab      get_entity_prefab(Entity entity);
     SV_API u32	       get_entity_component_count(Entity entity);
 	SV_API CompRef     get_entity_component_by_index(Entity entity, u32 index);
     SV_API u32	       get_entity_count();
@@ -117,6 +132,8 @@ namespace sv {
 	SV_API bool       has_entity_component(Entity entity, CompID comp_id);
 	SV_API Component* add_entity_component(Entity entity, CompID comp_id);
 	SV_API void       remove_entity_component(Entity entity, CompID comp_id);
+	// Copies the prefab component to the entity, the entity uses its own copy until it is removed
+	SV_API Component* override_entity_component(Entity entity, CompID comp_id);
 	SV_API Component* get_entity_component(Entity entity, CompID comp_id);
 
 	SV_API bool has_entity_tag(Entity entity, Tag tag);
@@ -130,8 +147,8 @@ namespace sv {
 
 	SV_API bool   create_prefab_file(const char* name, const char* filepath);
 	SV_API Prefab load_prefab(const char* filepath);
-	SV_API bool   save_prefab(Prefab prefab);
-	SV_API bool   save_prefab(Prefab prefab, const char* filepath);
+	SV_API bool   save_prefab(Prefab prefab); // Keeps the format of the file
+	SV_API bool   save_prefab(Prefab prefab, const char* filepath, bool compress = false);
 
 	SV_API bool        prefab_exists(Prefab prefab);
 	SV_API const char* get_prefab_filepath(Prefab prefab);
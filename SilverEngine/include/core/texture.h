@@ -0,0 +1,46 @@
+#pragma once
+
+#include "platform/graphics.h"
+
+namespace sv {
+
+	// Cooked textures are GPU ready: they contain the full mip chain and can be block compressed.
+	// At runtime the data is copied directly to the image, without decoding
+
+	enum TextureCompression : u32 {
+		TextureCompression_None, // RGBA8
+		TextureCompression_BC1,  // RGB + 1 bit alpha, 4 bits per pixel
+		TextureCompression_BC3,  // RGBA, 8 bits per pixel
+		TextureCompression_BC5,  // RG, used for normal maps
+		TextureCompression_BC7,  // RGBA, 8 bits per pixel with better quality than BC3
+	};
+
+	struct TextureCookDesc {
+		TextureCompression compression = TextureCompression_None;
+		bool               mipmaps = true;
+		bool               srgb = false; // The mipmaps are filtered in linear space and the format is SRGB
+	};
+
+	struct CookedTexture {
+		Format    format;
+		u32       width;
+		u32       height;
+		u32       mip_levels;
+		u32       size;
+		const u8* data; // Points to the deserializer buffer
+	};
+
+	constexpr u32 TEXTURE_MIP_MAX = 16u;
+
+	SV_API u32 texture_mip_count(u32 width, u32 height);
+
+	// Generates the mip chain and compresses it. The levels are tightly packed, as GPUImageDesc expects
+	SV_API bool texture_cook(const void* rgba, u32 width, u32 height, const TextureCookDesc& desc, RawList& data, Format* format, u32* mip_levels);
+
+	// Loads a png, jpg... and saves the cooked texture (.tex)
+	SV_API bool texture_cook_file(const char* srcpath, const char* dstpath, const TextureCookDesc& desc);
+
+	// The deserializer must be started
+	SV_API bool texture_cooked_read(Deserializer& d, CookedTexture& texture);
+
+}
@@ -21,6 +21,7 @@ namespace sv {
     enum GraphicsAPI {
 		GraphicsAPI_Invalid,
 		GraphicsAPI_Vulkan,
+		GraphicsAPI_Null, // Headless, records a command trace instead of talking to a GPU
     };
 
     enum GraphicsLimit : u32 {
@@ -198,6 +199,8 @@ namespace sv {
 		Format_BC5_SNORM,
 		Format_B8G8R8A8_UNORM,
 		Format_B8G8R8A8_SRGB,
+		Format_BC7_UNORM,
+		Format_BC7_SRGB,
 
     };
 	
@@ -378,6 +381,7 @@ namespace sv {
 		IndexType		index_type	= IndexType_32;
 		void*			data		= nullptr;
 		Format          format      = Format_Unknown;
+		bool            async_upload = false; // The data is copied in the transfer queue, see graphics_is_resident
     };
 
     struct GPUBufferInfo {
@@ -399,6 +403,8 @@ namespace sv {
 		CPUAccessFlags		cpu_access	= CPUAccess_None;
 		u32					width;
 		u32					height;
+		u32                 mip_levels = 1u; // The data contains all the levels, from the largest to the smallest
+		bool				async_upload = false;
     };
 
     struct GPUImageInfo {
@@ -408,6 +414,7 @@ namespace sv {
 		CPUAccessFlags		CPUAccess;
 		u32					width;
 		u32					height;
+		u32                 mip_levels;
     };
 
     struct SamplerDesc {
@@ -557,6 +564,8 @@ namespace sv {
 
     bool graphics_format_has_stencil(Format format);
     constexpr u32 graphics_format_size(Format format);
+    SV_API bool graphics_format_is_compressed(Format format);
+    SV_API u32 graphics_image_level_size(Format format, u32 width, u32 height); // Supports block compressed formats
 
     // Primitives
 
@@ -579,6 +588,9 @@ namespace sv {
     void _graphics_begin();
     void _graphics_end();
 
+    // Must be called before the graphics initialization
+    void _graphics_api_request(GraphicsAPI api);
+
     SV_API GraphicsAPI graphics_api_get();
 
     SV_API void graphics_present_image(GPUImage* image, GPUImageLayout layout);
@@ -603,6 +615,9 @@ namespace sv {
     SV_API bool graphics_rasterizerstate_create(const RasterizerStateDesc* desc, RasterizerState** rasterizerState);
 
     SV_API void graphics_destroy(Primitive* primitive);
+
+    // Returns false while the initial data of a primitive created with async_upload is not in the GPU
+    SV_API bool graphics_is_resident(Primitive* primitive);
 	
     SV_API void graphics_destroy_struct(void* data, size_t size);
 
@@ -723,6 +738,26 @@ namespace sv {
     SV_API void graphics_renderpass_begin(RenderPass* renderPass, GPUImage** attachments, CommandList cmd);
     SV_API void graphics_renderpass_end(CommandList cmd);
 
+    // Pipelines
+
+    struct GraphicsPipelineDesc {
+		Shader*				vertex_shader		= nullptr;
+		Shader*				pixel_shader		= nullptr;
+		Shader*				geometry_shader		= nullptr;
+		InputLayoutState*	input_layout_state	= nullptr; // Null uses the default state
+		BlendState*			blend_state			= nullptr;
+		DepthStencilState*	depth_stencil_state = nullptr;
+		RasterizerState*	rasterizer_state	= nullptr;
+		GraphicsTopology	topology			= GraphicsTopology_Triangles;
+		RenderPass*			render_pass			= nullptr;
+    };
+
+    /*
+      Creates the pipelines before the first draw call to avoid hitches, useful during loading screens.
+      Returns the number of pipelines ready
+    */
+    SV_API u32 graphics_pipeline_prewarm(const GraphicsPipelineDesc* descs, u32 count);
+
     // Draw Calls
 
     SV_API void graphics_draw(u32 vertexCount, u32 instanceCount, u32 startVertex, u32 startInstance, CommandList cmd);
@@ -754,7 +789,16 @@ namespace sv {
 
     // Assets
 
-    SV_DEFINE_ASSET_PTR(TextureAsset, GPUImage*);
+    // Returns null until the image is resident
+    struct TextureAsset {
+		SV_INLINE GPUImage* get() const noexcept { GPUImage** ptr = reinterpret_cast<GPUImage**>(sv::get_asset_content(asset_ptr)); return (ptr && *ptr && graphics_is_resident(*ptr)) ? *ptr : nullptr; }
+		SV_INLINE const char* get_filepath() const noexcept { return sv::get_asset_filepath(asset_ptr); }
+		SV_INLINE const char* get_name() const noexcept { return sv::get_asset_name(asset_ptr); }
+		SV_INLINE void set(void* ptr) const noexcept { GPUImage** p = reinterpret_cast<GPUImage**>(sv::get_asset_content(asset_ptr)); *p = (GPUImage*)ptr; }
+		SV_INLINE operator sv::AssetPtr& () { return asset_ptr; }
+		SV_INLINE operator const sv::AssetPtr& () const { return asset_ptr; }
+		sv::AssetPtr asset_ptr;
+    };
 
     // Properties
 
@@ -766,6 +810,73 @@ namespace sv {
 
     extern GraphicsProperties graphics_properties;
 
+    // Device stats
+
+    struct GraphicsDeviceStats {
+		u32 descriptor_set_requests;
+		u32 descriptor_set_hits;
+		u32 descriptor_sets_written;
+		u32 descriptor_writes;
+		u32 descriptor_set_evictions;
+		u32 constant_uploads;
+		u64 constant_upload_bytes; // Bytes written in the constant buffer rings
+		u32 async_uploads;
+		u64 async_upload_bytes; // Bytes recorded in the transfer queue
+    };
+
+    // Returns the stats of the last finished frame
+    SV_API void graphics_device_stats(GraphicsDeviceStats* stats);
+
+    // Null device
+
+    enum GraphicsCommandType : u32 {
+		GraphicsCommandType_Draw,
+		GraphicsCommandType_DrawIndexed,
+		GraphicsCommandType_Dispatch,
+		GraphicsCommandType_RenderPassBegin,
+		GraphicsCommandType_RenderPassEnd,
+		GraphicsCommandType_BufferUpdate,
+		GraphicsCommandType_Barrier,
+		GraphicsCommandType_ImageBlit,
+		GraphicsCommandType_ImageClear,
+		GraphicsCommandType_EventBegin,
+		GraphicsCommandType_EventMark,
+		GraphicsCommandType_EventEnd,
+    };
+
+    struct GraphicsCommand {
+		GraphicsCommandType type;
+		CommandList			cmd;
+		u64					state_flags; // Pipeline state changed before a draw
+		const Primitive*	primitive;
+		u32					args[5];
+    };
+
+    struct GraphicsStats {
+		u32 draw_calls;
+		u32 dispatch_calls;
+		u64 vertex_count;
+		u64 index_count;
+		u64 instance_count;
+		u32 pipeline_changes;
+		u32 resource_changes;
+		u32 renderpass_count;
+		u32 buffer_updates;
+		u64 uploaded_bytes;
+		u32 barrier_count;
+		u32 blit_count;
+		u32 clear_count;
+		u32 commandlist_count;
+    };
+
+    /*
+      Only available with GraphicsAPI_Null.
+      The trace and the frame stats belong to the last finished frame
+    */
+    SV_API bool graphics_null_stats(GraphicsStats* last_frame, GraphicsStats* total);
+    SV_API const GraphicsCommand* graphics_null_trace(u32* count);
+    SV_API void graphics_null_trace_enable(bool enable);
+
     // DEBUG
 
 #if SV_GFX
@@ -88,8 +88,34 @@ namespace sv {
     SV_API bool file_write_binary(const char* filepath, const u8* data, size_t size, bool append = false, bool recursive = true);
     SV_API bool file_write_text(const char* filepath, const char* str, size_t size, bool append = false, bool recursive = true);
 
+    // Sequential binary writer, the file is created or truncated
+    struct FileWriter {
+		u64 _handle = 0u;
+    };
+
+    SV_API bool file_writer_open(FileWriter& writer, const char* filepath, bool recursive = true);
+    SV_API bool file_writer_write(FileWriter& writer, const void* data, size_t size);
+    // Writes at an absolute offset, the next sequential writes continue at the end
+    SV_API bool file_writer_write_at(FileWriter& writer, size_t offset, const void* data, size_t size);
+    SV_API void file_writer_close(FileWriter& writer);
+
+    // Read only memory mapped file. If the file is inside a mounted pack, points to the pack memory
+    struct FileMapping {
+		const u8* data = NULL;
+		size_t size = 0u;
+		u64 _file = 0u;
+		u64 _mapping = 0u;
+    };
+
+    SV_API bool file_map(const char* filepath, FileMapping& mapping);
+    SV_API void file_unmap(FileMapping& mapping);
+    // Touches every page, the next reads don't stall in page faults
+    SV_API void file_prefetch(const FileMapping& mapping);
+
     SV_API bool file_remove(const char* filepath);
     SV_API bool file_copy(const char* srcpath, const char* dstpath);
+    // Replaces dstpath if it exists
+    SV_API bool file_rename(const char* srcpath, const char* dstpath);
     SV_API bool file_exists(const char* filepath);
     SV_API bool folder_create(const char* filepath, bool recursive = false);
 	SV_API bool folder_remove(const char* filepath);
@@ -114,6 +140,7 @@ namespace sv {
     SV_API void folder_iterator_close(FolderIterator* iterator);
     
     SV_API bool load_image(const char* filePath, void** pdata, u32* width, u32* height);
+    SV_API bool load_image_from_memory(const void* file_data, size_t file_size, void** pdata, u32* width, u32* height);
 
     // TODO: Move to utils/serialize.h
     SV_API bool bin_read(u64 hash, RawList& data, bool system = false);
@@ -122,6 +149,25 @@ namespace sv {
     SV_API bool bin_write(u64 hash, const void* data, size_t size, bool system = false);
     SV_API bool bin_write(u64 hash, Serializer& serializer, bool system = false); // Ends the serializer
 
+    // PACK FILES
+    // Single file with a table of contents sorted by filepath hash and 4K aligned payloads.
+    // The mounted packs are memory mapped and the file functions look in them before reading loose files.
+    // Mount the packs before start loading assets, they are read from worker threads
+
+    constexpr u32 PACK_MAX = 8u;
+    constexpr u32 PACK_ALIGNMENT = 4096u;
+
+    enum PackCompression : u32 {
+		PackCompression_None,
+    };
+
+    // Packs all the files inside the folders (recursively), the filepaths are stored as they are requested, ex: "assets/textures/grass.png"
+    SV_API bool pack_build(const char* pack_filepath, const char** folders, u32 folder_count);
+    SV_API bool pack_mount(const char* pack_filepath);
+    SV_API void pack_unmount_all();
+    SV_API bool pack_find(const char* filepath, const u8** pdata, size_t* psize); // Returns a pointer to the mapped memory
+    SV_API bool pack_benchmark(const char* pack_filepath); // Logs the time to read all the files from the pack and from the loose files
+
     // MULTITHREADING STUFF
 
     struct Mutex { u64 _handle = 0u; };
@@ -142,6 +188,37 @@ namespace sv {
 
 #define SV_LOCK_GUARD(mutex, name) _LockGuard name(&mutex);
 
+    // TASK SYSTEM
+
+    constexpr u32 TASK_DATA_SIZE = 64u;
+
+    typedef void(*TaskFn)(void* data);
+
+    struct TaskContext {
+		std::atomic<u32> submitted = 0u;
+		std::atomic<u32> completed = 0u;
+    };
+
+    // Executes the task in a worker thread, the data is copied.
+    // If the queue is full the task is executed in the calling thread
+    SV_API void task_dispatch(TaskFn fn, const void* data = nullptr, u32 size = 0u, TaskContext* context = nullptr);
+    SV_API void task_wait(TaskContext& context); // Executes pending tasks while waiting
+    SV_API bool task_running(const TaskContext& context);
+    SV_API u32  task_thread_count();
+
+    bool _task_initialize();
+    void _task_close();
+
+    // FILE WATCHER
+    // Watches a folder (recursively) in a background thread and queues the files that are created or modified.
+    // The filepaths are relative to the folder and use '/'. A file is queued once until it is popped
+
+    struct FileWatcher;
+
+    SV_API FileWatcher* file_watcher_create(const char* folder);
+    SV_API void         file_watcher_destroy(FileWatcher* watcher);
+    SV_API bool         file_watcher_pop(FileWatcher* watcher, char* filepath); // Returns false when the queue is empty
+
 	// DYNAMIC LIBRARIES
 
 	typedef u64 Library;
@@ -3,6 +3,8 @@
 #include "defines.h"
 #include "debug/console.h"
 
+#include <emmintrin.h>
+
 namespace sv {
 
     ////////////////////////////////////////////////////// LIST //////////////////////////////////////////////////
@@ -465,6 +467,13 @@ namespace sv {
 			_capacity = size;
 		}
 
+		SV_INLINE void swap(RawList& other) noexcept
+		{
+			std::swap(_data, other._data);
+			std::swap(_size, other._size);
+			std::swap(_capacity, other._capacity);
+		}
+
 		SV_INLINE bool empty() const noexcept
 		{
 			return _size == 0u;
@@ -771,6 +780,333 @@ namespace sv {
 	
     };
 
+    //////////////////////////////////////// HASH MAP ///////////////////////////////////////////////////
+
+    // Defines how a key is hashed, compared and stored inside the HashMap
+    template<typename K>
+    struct HashMapKey {
+
+		typedef K Stored;
+
+		SV_INLINE static u64 hash(const K& key) { return u64(key); }
+		SV_INLINE static bool equals(const Stored& stored, const K& key) { return stored == key; }
+		SV_INLINE static Stored store(const K& key) { return key; }
+		SV_INLINE static void release(Stored& stored) {}
+    };
+
+    // The string keys are copied, the map owns them
+    template<>
+    struct HashMapKey<const char*> {
+
+		typedef char* Stored;
+
+		SV_INLINE static u64 hash(const char* key) { return u64(hash_string(key)); }
+		SV_INLINE static bool equals(const Stored& stored, const char* key) { return strcmp(stored, key) == 0; }
+		
+		SV_INLINE static Stored store(const char* key)
+		{
+			size_t size = strlen(key) + 1u;
+			char* str = (char*)SV_ALLOCATE_MEMORY(size, "HashMap");
+			memcpy(str, key, size);
+			return str;
+		}
+		
+		SV_INLINE static void release(Stored& stored)
+		{
+			SV_FREE_MEMORY(stored);
+			stored = nullptr;
+		}
+    };
+
+    // Open addressing hash map (swiss table). Each slot has a control byte (empty, deleted or the 7 low bits of the hash),
+    // lookups compare groups of 16 control bytes with SSE2 and only compare the keys of the matching slots.
+    // The values are moved when the map grows, don't keep pointers to them across insertions
+    template<typename K, typename V>
+    struct HashMap {
+
+		typedef HashMapKey<K> KeyPolicy;
+		typedef typename KeyPolicy::Stored StoredKey;
+
+		static constexpr size_t GROUP_SIZE = 16u;
+		static constexpr u8 CTRL_EMPTY = 0x80;
+		static constexpr u8 CTRL_DELETED = 0xFE;
+
+		struct Slot {
+			StoredKey key;
+			V         value;
+			u64       hash;
+		};
+
+		struct Iterator {
+			HashMap* _map;
+			size_t   _index;
+
+			void _skip() {
+				while (_index < _map->_capacity && (_map->_ctrl[_index] & 0x80))
+					++_index;
+			}
+
+			void operator++() { ++_index; _skip(); }
+
+			bool operator==(const Iterator& it) { return _index == it._index; }
+			bool operator!=(const Iterator& it) { return _index != it._index; }
+
+			V& operator*() { return _map->_slots[_index].value; }
+			V* operator->() { return &_map->_slots[_index].value; }
+
+			const StoredKey& key() const { return _map->_slots[_index].key; }
+		};
+
+		HashMap() = default;
+		HashMap(const HashMap& other) = delete;
+		HashMap& operator=(const HashMap& other) = delete;
+		
+		~HashMap()
+		{
+			free();
+		}
+
+		V& get(const K& key)
+		{
+			u64 hash = _hash(key);
+			size_t index = _find(key, hash);
+
+			if (index != size_t_max)
+				return _slots[index].value;
+
+			// Max load factor of 7/8, deleted slots included
+			if ((_size + _deleted + 1u) * 8u > _capacity * 7u) {
+
+				size_t capacity = SV_MAX(_capacity, GROUP_SIZE);
+				if ((_size + 1u) * 16u > capacity * 7u) capacity *= 2u;
+				_rehash(capacity);
+			}
+
+			index = _find_free(hash);
+
+			if (_ctrl[index] == CTRL_DELETED) --_deleted;
+			_set_ctrl(index, _h2(hash));
+
+			Slot* slot = new(_slots + index) Slot();
+			slot->key = KeyPolicy::store(key);
+			slot->hash = hash;
+			++_size;
+
+			return slot->value;
+		}
+
+		V* find(const K& key)
+		{
+			size_t index = _find(key, _hash(key));
+			return (index == size_t_max) ? nullptr : &_slots[index].value;
+		}
+
+		bool erase(const K& key)
+		{
+			size_t index = _find(key, _hash(key));
+			if (index == size_t_max) return false;
+
+			Slot& slot = _slots[index];
+			KeyPolicy::release(slot.key);
+			slot.~Slot();
+
+			_set_ctrl(index, CTRL_DELETED);
+			--_size;
+			++_deleted;
+			
+			return true;
+		}
+
+		void reserve(size_t count)
+		{
+			size_t capacity = GROUP_SIZE;
+			while (count * 8u > capacity * 7u) capacity *= 2u;
+
+			if (capacity > _capacity)
+				_rehash(capacity);
+		}
+
+		// Keeps the memory
+		void clear()
+		{
+			foreach(i, _capacity) {
+
+				if ((_ctrl[i] & 0x80) == 0u) {
+					KeyPolicy::release(_slots[i].key);
+					_slots[i].~Slot();
+				}
+			}
+
+			if (_ctrl) memset(_ctrl, CTRL_EMPTY, _capacity + GROUP_SIZE - 1u);
+			_size = 0u;
+			_deleted = 0u;
+		}
+
+		void free()
+		{
+			clear();
+
+			if (_ctrl) {
+				SV_FREE_MEMORY(_ctrl);
+				SV_FREE_MEMORY(_slots);
+			}
+
+			_ctrl = nullptr;
+			_slots = nullptr;
+			_capacity = 0u;
+		}
+
+		V& operator[](const K& key) {
+			return get(key);
+		}
+
+		SV_INLINE size_t size() const { return _size; }
+		SV_INLINE bool empty() const { return _size == 0u; }
+		SV_INLINE size_t capacity() const { return _capacity; }
+
+		Iterator begin() {
+			Iterator it;
+			it._map = this;
+			it._index = 0u;
+			it._skip();
+			return it;
+		}
+
+		Iterator end() {
+			Iterator it;
+			it._map = this;
+			it._index = _capacity;
+			return it;
+		}
+
+		SV_INLINE static u64 _hash(const K& key)
+		{
+			// Finalizer of murmur3, the control bytes need good low bits
+			u64 h = KeyPolicy::hash(key);
+			h ^= h >> 33u;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33u;
+			h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33u;
+			return h;
+		}
+
+		SV_INLINE static size_t _h1(u64 hash) { return size_t(hash >> 7u); }
+		SV_INLINE static u8 _h2(u64 hash) { return u8(hash & 0x7Fu); }
+
+		SV_INLINE static u32 _first_bit(u32 mask)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return u32(index);
+#else
+			return u32(__builtin_ctz(mask));
+#endif
+		}
+
+		// The first GROUP_SIZE - 1 control bytes are replicated at the end, so a group can be loaded from any position
+		SV_INLINE void _set_ctrl(size_t index, u8 ctrl)
+		{
+			_ctrl[index] = ctrl;
+			if (index < GROUP_SIZE - 1u)
+				_ctrl[_capacity + index] = ctrl;
+		}
+
+		size_t _find(const K& key, u64 hash) const
+		{
+			if (_size == 0u) return size_t_max;
+
+			size_t mask = _capacity - 1u;
+			size_t pos = _h1(hash) & mask;
+
+			__m128i match = _mm_set1_epi8(char(_h2(hash)));
+			__m128i empty = _mm_set1_epi8(char(CTRL_EMPTY));
+
+			// Triangular probing, visits all the groups. There is always an empty slot
+			for (size_t step = GROUP_SIZE; ; step += GROUP_SIZE) {
+
+				__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_ctrl + pos));
+				u32 bits = u32(_mm_movemask_epi8(_mm_cmpeq_epi8(group, match)));
+
+				while (bits) {
+
+					size_t index = (pos + _first_bit(bits)) & mask;
+					const Slot& slot = _slots[index];
+
+					if (slot.hash == hash && KeyPolicy::equals(slot.key, key))
+						return index;
+
+					bits &= bits - 1u;
+				}
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(group, empty)))
+					return size_t_max;
+
+				pos = (pos + step) & mask;
+			}
+		}
+
+		// Empty and deleted control bytes have the high bit set
+		size_t _find_free(u64 hash) const
+		{
+			size_t mask = _capacity - 1u;
+			size_t pos = _h1(hash) & mask;
+
+			for (size_t step = GROUP_SIZE; ; step += GROUP_SIZE) {
+
+				__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_ctrl + pos));
+				u32 bits = u32(_mm_movemask_epi8(group));
+
+				if (bits)
+					return (pos + _first_bit(bits)) & mask;
+
+				pos = (pos + step) & mask;
+			}
+		}
+
+		void _rehash(size_t capacity)
+		{
+			u8* old_ctrl = _ctrl;
+			Slot* old_slots = _slots;
+			size_t old_capacity = _capacity;
+
+			_capacity = capacity;
+			_ctrl = (u8*)SV_ALLOCATE_MEMORY(capacity + GROUP_SIZE - 1u, "HashMap");
+			_slots = (Slot*)SV_ALLOCATE_MEMORY(sizeof(Slot) * capacity, "HashMap");
+			memset(_ctrl, CTRL_EMPTY, capacity + GROUP_SIZE - 1u);
+			_deleted = 0u;
+
+			foreach(i, old_capacity) {
+
+				if ((old_ctrl[i] & 0x80) == 0u) {
+
+					Slot& old = old_slots[i];
+					size_t index = _find_free(old.hash);
+					
+					_set_ctrl(index, _h2(old.hash));
+					new(_slots + index) Slot(std::move(old));
+					old.~Slot();
+				}
+			}
+
+			if (old_ctrl) {
+				SV_FREE_MEMORY(old_ctrl);
+				SV_FREE_MEMORY(old_slots);
+			}
+		}
+
+		u8*    _ctrl = nullptr;
+		Slot*  _slots = nullptr;
+		size_t _capacity = 0u;
+		size_t _size = 0u;
+		size_t _deleted = 0u;
+	
+    };
+
+	// Logs the insert and lookup throughput of the HashMap against the ThickHashTable
+	SV_API void hash_map_benchmark(u32 count);
+
     // SIZED INSTANCE ALLOCATOR
 
     struct SizedInstanceAllocatorPoolIterator {
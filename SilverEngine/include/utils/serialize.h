@@ -5,6 +5,8 @@
 #include "utils/math.h"
 #include "utils/string.h"
 
+#include <type_traits>
+
 namespace sv {
 
     constexpr u32 VARNAME_SIZE = 30u;
@@ -35,84 +37,128 @@ namespace sv {
 
     struct Serializer {
 		static constexpr u32 VERSION = 0u;
-		RawList buff;
+		RawList buff; // In streaming mode contains the bytes that are not flushed
+		bool compress = false; // serialize_end writes a compressed file, ignored in streaming mode
+		size_t _flushed = 0u;
+		void* _stream = NULL;
+
+		~Serializer();
     };
 
+    constexpr size_t SERIALIZER_CHUNK_SIZE = 1024u * 1024u;
+
     SV_API void serialize_begin(Serializer& s);
     SV_API bool serialize_end(Serializer& s, const char* filepath);
 
+    // Streaming mode: the buffer has a fixed size and is written to the file every time it is filled.
+    // With async the chunks are written in a worker thread while the next one is filled.
+    // serialize_end ignores the filepath and returns false if any write failed.
+    // The streamed files are not compressed, serialize_patch can rewrite the flushed bytes.
+    // The compressed files are written with serialize_begin and the compress flag
+    SV_API bool serialize_begin_stream(Serializer& s, const char* filepath, bool async = false, size_t chunk_size = SERIALIZER_CHUNK_SIZE);
+
+    SV_API void _serialize_stream_write(Serializer& s, const void* data, size_t size);
+
+    SV_INLINE void serialize_write(Serializer& s, const void* data, size_t size)
+    {
+		if (s._stream && s.buff.size() + size > s.buff.capacity())
+			_serialize_stream_write(s, data, size);
+		else
+			s.buff.write_back(data, size);
+    }
+
+    // The streaming buffer is never resized
+    SV_INLINE void serialize_reserve(Serializer& s, size_t size)
+    {
+		if (s._stream == NULL) s.buff.reserve(size);
+    }
+
+    // Bytes written since serialize_begin, including the flushed ones
+    SV_INLINE size_t serialize_size(const Serializer& s)
+    {
+		return s._flushed + s.buff.size();
+    }
+
+    // Overwrites bytes already serialized, pos is obtained with serialize_size
+    SV_API void serialize_patch(Serializer& s, size_t pos, const void* data, size_t size);
+
+    SV_INLINE Serializer::~Serializer()
+    {
+		if (_stream) serialize_end(*this, NULL);
+    }
+
     SV_INLINE void serialize_u8(Serializer& s, u8 n)
     {
-		s.buff.write_back(&n, sizeof(u8));
+		serialize_write(s, &n, sizeof(u8));
     }
     SV_INLINE void serialize_u16(Serializer& s, u16 n)
     {
-		s.buff.write_back(&n, sizeof(u16));
+		serialize_write(s, &n, sizeof(u16));
     }
     SV_INLINE void serialize_u32(Serializer& s, u32 n)
     {
-		s.buff.write_back(&n, sizeof(u32));
+		serialize_write(s, &n, sizeof(u32));
     }
     SV_INLINE void serialize_u64(Serializer& s, u64 n)
     {
-		s.buff.write_back(&n, sizeof(u64));
+		serialize_write(s, &n, sizeof(u64));
     }
     SV_INLINE void serialize_size_t(Serializer& s, size_t n)
     {
 		u64 n0 = u64(n);
-		s.buff.write_back(&n0, sizeof(u64));
+		serialize_write(s, &n0, sizeof(u64));
     }
 
     SV_INLINE void serialize_i8(Serializer& s, i8 n)
     {
-		s.buff.write_back(&n, sizeof(i8));
+		serialize_write(s, &n, sizeof(i8));
     }
     SV_INLINE void serialize_i16(Serializer& s, i16 n)
     {
-		s.buff.write_back(&n, sizeof(i16));
+		serialize_write(s, &n, sizeof(i16));
     }
     SV_INLINE void serialize_i32(Serializer& s, i32 n)
     {
-		s.buff.write_back(&n, sizeof(i32));
+		serialize_write(s, &n, sizeof(i32));
     }
     SV_INLINE void serialize_i64(Serializer& s, i64 n)
     {
-		s.buff.write_back(&n, sizeof(i64));
+		serialize_write(s, &n, sizeof(i64));
     }
 
     SV_INLINE void serialize_f32(Serializer& s, f32 n)
     {
-		s.buff.write_back(&n, sizeof(f32));
+		serialize_write(s, &n, sizeof(f32));
     }
     SV_INLINE void serialize_f64(Serializer& s, f64 n)
     {
-		s.buff.write_back(&n, sizeof(f64));
+		serialize_write(s, &n, sizeof(f64));
     }
 
     SV_INLINE void serialize_char(Serializer& s, char n)
     {
-		s.buff.write_back(&n, sizeof(char));
+		serialize_write(s, &n, sizeof(char));
     }
     SV_INLINE void serialize_bool(Serializer& s, bool n)
     {
-		s.buff.write_back(&n, sizeof(bool));
+		serialize_write(s, &n, sizeof(bool));
     }
 
     SV_INLINE void serialize_color(Serializer& s, Color n)
     {
-		s.buff.write_back(&n, sizeof(Color));
+		serialize_write(s, &n, sizeof(Color));
     }
 
     SV_INLINE void serialize_xmmatrix(Serializer& s, const XMMATRIX& n)
     {
-		s.buff.write_back(&n, sizeof(XMMATRIX));
+		serialize_write(s, &n, sizeof(XMMATRIX));
     }
 
     SV_INLINE void serialize_string(Serializer& s, const char* str)
     {
 		size_t len = strlen(str) + 1u;
-		s.buff.reserve(len);
-		s.buff.write_back(str, len);
+		serialize_reserve(s, len);
+		serialize_write(s, str, len);
     }
     SV_INLINE void serialize_string(Serializer& s, const String& str)
     {
@@ -129,20 +175,20 @@ namespace sv {
 
     SV_INLINE void serialize_v2_f32(Serializer& s, const v2_f32& v)
     {
-		s.buff.reserve(sizeof(f32) * 2u);
+		serialize_reserve(s, sizeof(f32) * 2u);
 		serialize_f32(s, v.x);
 		serialize_f32(s, v.y);
     }
     SV_INLINE void serialize_v3_f32(Serializer& s, const v3_f32& v)
     {
-		s.buff.reserve(sizeof(f32) * 3u);
+		serialize_reserve(s, sizeof(f32) * 3u);
 		serialize_f32(s, v.x);
 		serialize_f32(s, v.y);
 		serialize_f32(s, v.z);
     }
     SV_INLINE void serialize_v4_f32(Serializer& s, const v4_f32& v)
     {
-		s.buff.reserve(sizeof(f32) * 4u);
+		serialize_reserve(s, sizeof(f32) * 4u);
 		serialize_f32(s, v.x);
 		serialize_f32(s, v.y);
 		serialize_f32(s, v.z);
@@ -155,76 +201,43 @@ namespace sv {
 		serialize_u32(s, v.y);
     }
 
-	SV_INLINE void serialize_f32_array(Serializer& s, const f32* v, u32 count)
-    {
-		s.buff.reserve(sizeof(f32) * count + sizeof(u32));
+	// Bulk arrays: the count followed by the elements in one copy.
+	// The elements must be trivially copyable and tightly packed, the layout is the same of the per element loops
+
+	template<typename T>
+	SV_INLINE void serialize_pod_array(Serializer& s, const T* v, u32 count)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "The array elements must be PODs");
+		
+		size_t size = sizeof(T) * size_t(count);
+		serialize_reserve(s, size + sizeof(u32));
 
 		serialize_u32(s, count);
+		if (size) serialize_write(s, v, size);
+	}
 
-		const f32* end = v + size_t(count);
+	static_assert(sizeof(v2_f32) == sizeof(f32) * 2u && sizeof(v3_f32) == sizeof(f32) * 3u && sizeof(v4_f32) == sizeof(f32) * 4u, "The vectors must be tightly packed");
 
-		while (v != end)  {
-	
-			serialize_f32(s, *v);
-			++v;
-		}
+	SV_INLINE void serialize_f32_array(Serializer& s, const f32* v, u32 count)
+    {
+		serialize_pod_array(s, v, count);
     }
     SV_INLINE void serialize_v2_f32_array(Serializer& s, const v2_f32* v, u32 count)
     {
-		s.buff.reserve(sizeof(f32) * 2u * count + sizeof(u32));
-
-		serialize_u32(s, count);
-
-		const v2_f32* end = v + size_t(count);
-
-		while (v != end)  {
-	
-			serialize_f32(s, v->x);
-			serialize_f32(s, v->y);
-			++v;
-		}
+		serialize_pod_array(s, v, count);
     }
     SV_INLINE void serialize_v3_f32_array(Serializer& s, const v3_f32* v, u32 count)
     {
-		s.buff.reserve(sizeof(f32) * 3u * count + sizeof(u32));
-
-		serialize_u32(s, count);
-
-		const v3_f32* end = v + size_t(count);
-
-		while (v != end)  {
-	
-			serialize_f32(s, v->x);
-			serialize_f32(s, v->y);
-			serialize_f32(s, v->z);
-			++v;
-		}
+		serialize_pod_array(s, v, count);
     }
     SV_INLINE void serialize_v4_f32_array(Serializer& s, const v4_f32* v, u32 count)
     {
-		s.buff.reserve(sizeof(f32) * 4u * count + sizeof(u32));
-
-		serialize_u32(s, count);
-
-		const v4_f32* end = v + size_t(count);
-
-		while (v != end)  {
-	
-			serialize_f32(s, v->x);
-			serialize_f32(s, v->y);
-			serialize_f32(s, v->z);
-			serialize_f32(s, v->w);
-			++v;
-		}
+		serialize_pod_array(s, v, count);
     }
 
     SV_INLINE void serialize_u32_array(Serializer& s, const u32* n, u32 count)
     {
-		s.buff.reserve(sizeof(u32) * (count + 1u));
-		serialize_u32(s, count);
-
-		foreach(i, count)
-			serialize_u32(s, n[i]);
+		serialize_pod_array(s, n, count);
     }
 
 	SV_INLINE void serialize_f32_array(Serializer& s, const List<f32>& list)
@@ -249,9 +262,30 @@ namespace sv {
 		serialize_u32_array(s, list.data(), (u32)list.size());
     }
 
+	// Variable length integers: 7 bits per byte, the high bit marks that more bytes follow
+	SV_INLINE void serialize_varint(Serializer& s, u64 n)
+	{
+		u8 bytes[10u];
+		u32 count = 0u;
+
+		while (n >= 0x80u) {
+			bytes[count++] = u8(n) | 0x80u;
+			n >>= 7u;
+		}
+		bytes[count++] = u8(n);
+
+		serialize_write(s, bytes, count);
+	}
+
+	// Zigzag encoding, the small negative numbers are also small varints
+	SV_INLINE void serialize_varint_signed(Serializer& s, i64 n)
+	{
+		serialize_varint(s, (u64(n) << 1u) ^ u64(n >> 63));
+	}
+
     SV_INLINE void serialize_version(Serializer& s, Version n)
     {
-		s.buff.write_back(&n, sizeof(Version));
+		serialize_write(s, &n, sizeof(Version));
     }
 
     /////////////////////////// DESERIALIZER //////////////////////////////////
@@ -260,13 +294,30 @@ namespace sv {
 		static constexpr u32 LAST_VERSION_SUPPORTED = 0u;
 		u32 serializer_version;
 		Version engine_version;
-		RawList buff;
+		RawList buff; // In mapped and view modes the memory is not owned
 		size_t pos;
+		void* _mapping = NULL;
+		bool _view = false;
+
+		~Deserializer();
     };
 
     SV_API bool deserialize_begin(Deserializer& d, const char* filepath);
     SV_API void deserialize_end(Deserializer& d);
 
+	// The file is memory mapped instead of read, the data is loaded by the page faults while deserializing.
+	// With prefetch the pages are touched before returning, useful when the data is consumed in other thread.
+	// The buffer and the array views are valid until deserialize_end
+	SV_API bool deserialize_begin_mapped(Deserializer& d, const char* filepath, bool prefetch = false);
+
+	// Reads a memory block without header, used to deserialize parts of a file in other threads
+	SV_API void deserialize_begin_view(Deserializer& d, const void* data, size_t size);
+
+	SV_INLINE Deserializer::~Deserializer()
+	{
+		if (_mapping || _view) deserialize_end(*this);
+	}
+
     SV_INLINE bool deserialize_assert(Deserializer& d, size_t size)
     {
 		return (d.pos + size) <= d.buff.size();
@@ -357,10 +408,14 @@ namespace sv {
 
     SV_INLINE size_t deserialize_string_size(Deserializer& d)
     {
-		size_t size;
+		if (d.pos >= d.buff.size()) return 0u;
+		
+		// Bounded by the buffer, the mapped files are not null terminated
+		size_t max_size = d.buff.size() - d.pos;
 		const char* str = (const char*)(d.buff.data() + d.pos);
-		size = strlen(str);
-		return size;
+		const char* end = (const char*)memchr(str, '\0', max_size);
+		
+		return end ? size_t(end - str) : max_size;
     }
     SV_INLINE void deserialize_string(Deserializer& d, char* str, size_t buff_size)
     {
@@ -396,81 +451,156 @@ namespace sv {
 		deserialize_u32(d, v.y);
     }
 
-	SV_INLINE void deserialize_f32_array(Deserializer& d, List<f32>& list)
-    {
-		u32 count;
-		deserialize_u32(d, count);
+	// Checked read, returns false and keeps the position if the buffer is too small
+	SV_INLINE bool deserialize_bytes(Deserializer& d, void* dst, size_t size)
+	{
+		if (size > d.buff.size() || d.pos > d.buff.size() - size)
+			return false;
 
-		list.resize(count);
+		if (size) memcpy(dst, d.buff.data() + d.pos, size);
+		d.pos += size;
+		return true;
+	}
 
-		foreach(i, count)  {
+	// Reads an array written with serialize_pod_array without copying it, the pointer can be unaligned.
+	// Valid until deserialize_end. Used to validate the arrays of a file before allocating them
+	template<typename T>
+	SV_INLINE bool deserialize_pod_array_view(Deserializer& d, const T*& data, u32& count)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "The array elements must be PODs");
 
-			deserialize_f32(d, list[i]);
-		}
-    }
-    SV_INLINE void deserialize_v2_f32_array(Deserializer& d, List<v2_f32>& list)
-    {
-		u32 count;
-		deserialize_u32(d, count);
+		size_t begin = d.pos;
+		data = NULL;
 
-		list.resize(count);
+		if (!deserialize_bytes(d, &count, sizeof(u32))) {
+			count = 0u;
+			return false;
+		}
 
-		foreach(i, count)  {
+		size_t size = sizeof(T) * size_t(count);
 
-			v2_f32& v = list[i];
-			deserialize_f32(d, v.x);
-			deserialize_f32(d, v.y);
+		if (!deserialize_assert(d, size)) {
+			d.pos = begin;
+			count = 0u;
+			return false;
 		}
-    }
-    SV_INLINE void deserialize_v3_f32_array(Deserializer& d, List<v3_f32>& list)
-    {
-		u32 count;
-		deserialize_u32(d, count);
 
-		list.resize(count);
+		data = reinterpret_cast<const T*>(d.buff.data() + d.pos);
+		d.pos += size;
+		return true;
+	}
 
-		foreach(i, count)  {
+	// Copies an array view to the list
+	template<typename T>
+	SV_INLINE void deserialize_pod_array_copy(List<T>& list, const T* data, u32 count)
+	{
+		list.resize(count);
+		if (count) memcpy(list.data(), data, sizeof(T) * size_t(count));
+	}
+
+	// Reads an array written with serialize_pod_array.
+	// If the file is truncated the list is cleared, the position is restored and returns false
+	template<typename T>
+	SV_INLINE bool deserialize_pod_array(Deserializer& d, List<T>& list)
+	{
+		const T* data;
+		u32 count;
 
-			v3_f32& v = list[i];
-			deserialize_f32(d, v.x);
-			deserialize_f32(d, v.y);
-			deserialize_f32(d, v.z);
+		if (!deserialize_pod_array_view(d, data, count)) {
+			list.reset();
+			return false;
 		}
+
+		deserialize_pod_array_copy(list, data, count);
+		return true;
     }
-    SV_INLINE void deserialize_v4_f32_array(Deserializer& d, List<v4_f32>& list)
+
+	SV_INLINE bool deserialize_f32_array(Deserializer& d, List<f32>& list)
     {
-		u32 count;
-		deserialize_u32(d, count);
+		return deserialize_pod_array(d, list);
+    }
+    SV_INLINE bool deserialize_v2_f32_array(Deserializer& d, List<v2_f32>& list)
+    {
+		return deserialize_pod_array(d, list);
+    }
+    SV_INLINE bool deserialize_v3_f32_array(Deserializer& d, List<v3_f32>& list)
+    {
+		return deserialize_pod_array(d, list);
+    }
+    SV_INLINE bool deserialize_v4_f32_array(Deserializer& d, List<v4_f32>& list)
+    {
+		return deserialize_pod_array(d, list);
+    }
 
-		list.resize(count);
+    SV_INLINE bool deserialize_u32_array(Deserializer& d, List<u32>& list)
+    {
+		return deserialize_pod_array(d, list);
+    }
 
-		foreach(i, count)  {
+	// Returns false if the varint is truncated or longer than 10 bytes
+	SV_INLINE bool deserialize_varint(Deserializer& d, u64& n)
+	{
+		n = 0u;
 
-			v4_f32& v = list[i];
-			deserialize_f32(d, v.x);
-			deserialize_f32(d, v.y);
-			deserialize_f32(d, v.z);
-			deserialize_f32(d, v.w);
-		}
-    }
+		const u8* it = d.buff.data() + d.pos;
+		u32 shift = 0u;
 
-    SV_INLINE void deserialize_u32_array(Deserializer& d, List<u32>& list)
-    {
-		u32 count;
-		deserialize_u32(d, count);
+		while (d.pos < d.buff.size() && shift < 64u) {
 
-		list.resize(count);
+			u8 byte = *it++;
+			++d.pos;
+			
+			n |= u64(byte & 0x7Fu) << shift;
+			shift += 7u;
 
-		foreach(i, count)  {
-	    
-			deserialize_u32(d, list[i]);
+			if ((byte & 0x80u) == 0u) return true;
 		}
-    }
+
+		return false;
+	}
+	SV_INLINE bool deserialize_varint(Deserializer& d, u32& n)
+	{
+		u64 n0;
+		bool res = deserialize_varint(d, n0);
+		n = u32(n0);
+		return res && n0 <= u64(u32_max);
+	}
+	SV_INLINE bool deserialize_varint_signed(Deserializer& d, i64& n)
+	{
+		u64 n0;
+		bool res = deserialize_varint(d, n0);
+		n = i64(n0 >> 1u) ^ -i64(n0 & 1u);
+		return res;
+	}
 
     SV_INLINE void deserialize_version(Deserializer& d, Version& n)
     {
 		d.buff.read_safe(&n, sizeof(Version), d.pos);
 		d.pos += sizeof(Version);
     }    
+
+	// Logs the throughput in MB/s of the bulk array paths against the per element reads and writes
+	SV_API void serialize_benchmark(u32 count);
+
+	/////////////////////////// COMPRESSION //////////////////////////////////
+
+	// The blocks use the LZ4 block format. The compressed files start with a header and are split in
+	// independent chunks, decompressed in parallel. The deserializer and bin_read detect the header
+	// and decompress transparently, the raw files are read as before
+
+	constexpr size_t COMPRESSION_CHUNK_SIZE = 256u * 1024u;
+
+	SV_API size_t compress_bound(size_t size);
+	SV_API size_t compress_block(const void* src, size_t size, void* dst, size_t capacity); // Returns 0 if it doesn't fit
+	SV_API bool   decompress_block(const void* src, size_t size, void* dst, size_t dst_size);
+
+	SV_API void compress_data(const void* data, size_t size, RawList& dst, size_t chunk_size = COMPRESSION_CHUNK_SIZE);
+	SV_API bool decompress_data(const void* data, size_t size, RawList& dst);
+	SV_API bool data_is_compressed(const void* data, size_t size);
+	SV_API bool file_is_compressed(const char* filepath); // Used to keep the format when a file is saved again
+
+	// Logs the compression ratio of a file and the load time against the raw file for some read speeds.
+	// With a folder the scenes, prefabs and meshes inside it are measured and the totals are logged by type
+	SV_API void compression_benchmark(const char* filepath);
     
 }
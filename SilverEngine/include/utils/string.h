@@ -1,6 +1,7 @@
 #pragma once
 
 #include "platform/input.h"
+#include <emmintrin.h>
 
 namespace sv {
 
@@ -70,27 +71,50 @@ namespace sv {
 		return str ? str : "";
 	}
 
-    SV_INLINE size_t string_split(const char* line, char* delimiters, u32 count)
-    {
-		const char* it = line;
-		while (*it != '\0') {
+	SV_INLINE u32 _string_first_bit(u32 mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return u32(index);
+#else
+		return u32(__builtin_ctz(mask));
+#endif
+	}
 
-			bool end = false;
+	// Text scanning 16 bytes at a time with SSE2. The loads are aligned, they never cross a page
+	// so reading the bytes after the terminator can't fault
 
-			foreach(i, count)
-				if (delimiters[i] == *it) {
-					end = true;
-					break;
-				}
+	SV_INLINE u32 _string_match_mask(__m128i chunk, const char* delimiters, u32 count)
+	{
+		__m128i match = _mm_cmpeq_epi8(chunk, _mm_setzero_si128());
 
-			if (end) break;
-	    
-			++it;
+		foreach(i, count)
+			match = _mm_or_si128(match, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(delimiters[i])));
+
+		return u32(_mm_movemask_epi8(match));
+	}
+
+	// Returns the position of the first delimiter or the terminator
+	SV_INLINE const char* string_scan(const char* str, const char* delimiters, u32 count)
+	{
+		size_t misalign = size_t(str) & 15u;
+		const char* it = str - misalign;
+
+		u32 mask = _string_match_mask(_mm_load_si128(reinterpret_cast<const __m128i*>(it)), delimiters, count);
+		mask &= 0xFFFFu << misalign;
+
+		while (mask == 0u) {
+			it += 16u;
+			mask = _string_match_mask(_mm_load_si128(reinterpret_cast<const __m128i*>(it)), delimiters, count);
 		}
 
-		size_t size = it - line;
-	
-		return size;
+		return it + _string_first_bit(mask);
+	}
+
+    SV_INLINE size_t string_split(const char* line, const char* delimiters, u32 count)
+    {
+		return string_scan(line, delimiters, count) - line;
     }
 
     constexpr size_t string_size(const char* str)
@@ -392,11 +416,10 @@ namespace sv {
     // Line processing
 
     struct LineProcessor {
-		String line_buff;
 		const char* str;
 		size_t offset;
 		u32 line_count;
-		const char* line;
+		const char* line; // Points to the text, the line ends with the '\n' or the terminator
     };
     
     SV_INLINE void line_begin(LineProcessor& processor, const char* str)
@@ -404,30 +427,25 @@ namespace sv {
 		processor.str = str;
 		processor.offset = 0u;
 		processor.line_count = 0u;
+		processor.line = nullptr;
     }
 
     SV_INLINE bool line_next(LineProcessor& processor)
     {
-		processor.offset += processor.line_buff.size();
+		const char* begin = processor.str + processor.offset;
 
-		char del = '\n';
-		size_t size = string_split(processor.str + processor.offset, &del, 1u);
-		if (*(processor.str + processor.offset + size) != '\0')
-			++size;
-
-		if (size) {
-
-			processor.line_buff.reset();
-			processor.line_buff.append(processor.str, processor.offset, size);
-			processor.line = processor.line_buff.c_str();
-			++processor.line_count;
-			return true;
-		}
-		else {
-			processor.line_buff.clear();
+		if (*begin == '\0') {
 			processor.line = nullptr;
 			return false;
 		}
+
+		const char* end = string_scan(begin, "\n", 1u);
+		if (*end == '\n') ++end;
+
+		processor.offset = end - processor.str;
+		processor.line = begin;
+		++processor.line_count;
+		return true;
     }
 
     SV_INLINE void line_jump_spaces(const char*& line)
@@ -435,143 +453,207 @@ namespace sv {
 		while (*line == ' ') ++line;
     }
 
-    SV_INLINE bool line_read_f32(const char*& line, f32& value)
-    {
-		value = 0.f;
-		line_jump_spaces(line);
+	SV_INLINE bool _line_is_token_end(char c, const char* delimiters, u32 delimiter_count)
+	{
+		if (c == '\0' || c == '\n' || c == '\r') return true;
 
-		const char* start = line;
+		foreach(i, delimiter_count)
+			if (delimiters[i] == c) return true;
 
-		if (*line == '-') ++line;
+		return false;
+	}
 
-		u32 dots = 0u;
-	
-		while (*line != '\0' && *line != ' ' && *line != '\n' && *line != '\r') {
-			if (!char_is_number(*line) && *line != '.')
-				return false;
+	// Decimal number: [-]digits[.digits][(e|E)[+|-]digits]. Up to 19 significant digits are stored in the mantissa,
+	// value = mantissa * 10^exponent. With more digits exact is false
+	SV_INLINE bool _line_read_decimal(const char*& line, u64& mantissa, i32& exponent, bool& negative, bool& exact)
+	{
+		mantissa = 0u;
+		exponent = 0;
+		exact = true;
 
-			if (*line == '.')
-				++dots;
-	    
+		negative = *line == '-';
+		if (negative) ++line;
+
+		u32 digits = 0u;
+		u32 significant = 0u;
+
+		while (char_is_number(*line)) {
+
+			if (significant < 19u) {
+				mantissa = mantissa * 10u + u64(*line - '0');
+				if (mantissa) ++significant;
+			}
+			else {
+				++exponent;
+				if (*line != '0') exact = false;
+			}
+
+			++digits;
 			++line;
 		}
 
-		if (line == start || dots > 1) return false;
-	
-		size_t size = line - start;	
+		if (*line == '.') {
+
+			++line;
+
+			while (char_is_number(*line)) {
+
+				if (significant < 19u) {
+					mantissa = mantissa * 10u + u64(*line - '0');
+					if (mantissa) ++significant;
+					--exponent;
+				}
+				else if (*line != '0') exact = false;
+
+				++digits;
+				++line;
+			}
+		}
+
+		if (digits == 0u) return false;
+
+		if (*line == 'e' || *line == 'E') {
+
+			++line;
+
+			bool negative_exp = *line == '-';
+			if (*line == '-' || *line == '+') ++line;
+
+			if (!char_is_number(*line)) return false;
+
+			i32 e = 0;
+
+			while (char_is_number(*line)) {
+				if (e < 100000) e = e * 10 + i32(*line - '0');
+				++line;
+			}
 
-		char value_str[20u];
-		memcpy(value_str, start, size);
-		value_str[size] = '\0';
-		value = (f32)atof(value_str);
+			exponent += negative_exp ? -e : e;
+		}
 
 		return true;
-    }
+	}
 
-	SV_INLINE bool line_read_f64(const char*& line, f64& value)
+	// The long values and the big exponents can't use the fast path, they are parsed with the CRT
+	SV_INLINE bool _line_copy_token(const char* start, const char* end, char* buff, size_t buff_size)
+	{
+		size_t size = end - start;
+		if (size >= buff_size) return false;
+
+		memcpy(buff, start, size);
+		buff[size] = '\0';
+		return true;
+	}
+
+	// Correctly rounded. If the mantissa and the power of ten are exact floats the result is one rounded
+	// multiplication or division, otherwise uses strtof
+    SV_INLINE bool line_read_f32(const char*& line, f32& value)
     {
+		constexpr f32 POW10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+		
 		value = 0.f;
 		line_jump_spaces(line);
 
 		const char* start = line;
 
-		if (*line == '-') ++line;
+		u64 mantissa;
+		i32 exponent;
+		bool negative, exact;
 
-		u32 dots = 0u;
-	
-		while (*line != '\0' && *line != ' ' && *line != '\n' && *line != '\r') {
-			if (!char_is_number(*line) && *line != '.')
-				return false;
+		if (!_line_read_decimal(line, mantissa, exponent, negative, exact) || (*line != '\0' && *line != ' ' && *line != '\n' && *line != '\r'))
+			return false;
 
-			if (*line == '.')
-				++dots;
-	    
-			++line;
+		if (exact && mantissa <= (1ULL << 24u) && exponent >= -10 && exponent <= 10) {
+
+			f32 v = f32(mantissa);
+			v = (exponent < 0) ? v / POW10[-exponent] : v * POW10[exponent];
+			value = negative ? -v : v;
 		}
+		else {
 
-		if (line == start || dots > 1) return false;
-	
-		size_t size = line - start;	
+			char value_str[128u];
+			if (!_line_copy_token(start, line, value_str, sizeof(value_str)))
+				return false;
 
-		char value_str[50u];
-		memcpy(value_str, start, size);
-		value_str[size] = '\0';
-		char* si;
-		value = (f64)strtod(value_str, &si);
+			value = strtof(value_str, nullptr);
+		}
 
 		return true;
     }
 
-    SV_INLINE bool line_read_i32(const char*& line, i32& value, const char* delimiters, u32 delimiter_count)
+	SV_INLINE bool line_read_f64(const char*& line, f64& value)
     {
-		value = 0;
+		constexpr f64 POW10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		
+		value = 0.0;
 		line_jump_spaces(line);
 
 		const char* start = line;
-	
-		if (*line == '-') ++line;
-	
-		while (*line != '\0' && *line != '\n' && *line != '\r') {
 
-			bool end = false;
+		u64 mantissa;
+		i32 exponent;
+		bool negative, exact;
 
-			foreach(i, delimiter_count)
-				if (delimiters[i] == *line) end = true;
+		if (!_line_read_decimal(line, mantissa, exponent, negative, exact) || (*line != '\0' && *line != ' ' && *line != '\n' && *line != '\r'))
+			return false;
 
-			if (end)
-				break;
-	    
-			if (!char_is_number(*line))
-				return false;
-			++line;
+		if (exact && mantissa <= (1ULL << 53u) && exponent >= -22 && exponent <= 22) {
+
+			f64 v = f64(mantissa);
+			v = (exponent < 0) ? v / POW10[-exponent] : v * POW10[exponent];
+			value = negative ? -v : v;
 		}
+		else {
 
-		if (line == start) return false;
-	
-		size_t size = line - start;	
+			char value_str[128u];
+			if (!_line_copy_token(start, line, value_str, sizeof(value_str)))
+				return false;
 
-		char value_str[20u];
-		memcpy(value_str, start, size);
-		value_str[size] = '\0';
-		value = atoi(value_str);
+			value = strtod(value_str, nullptr);
+		}
 
 		return true;
     }
 
-	SV_INLINE bool line_read_i64(const char*& line, i64& value, const char* delimiters, u32 delimiter_count)
-    {
-		value = 0;
+	SV_INLINE bool _line_read_integer(const char*& line, u64& value, bool& negative, const char* delimiters, u32 delimiter_count)
+	{
+		value = 0u;
 		line_jump_spaces(line);
 
-		const char* start = line;
-	
-		if (*line == '-') ++line;
-	
-		while (*line != '\0' && *line != '\n' && *line != '\r') {
-
-			bool end = false;
+		negative = *line == '-';
+		if (negative) ++line;
 
-			foreach(i, delimiter_count)
-				if (delimiters[i] == *line) end = true;
+		const char* start = line;
 
-			if (end)
-				break;
-	    
-			if (!char_is_number(*line))
-				return false;
+		while (char_is_number(*line)) {
+			value = value * 10u + u64(*line - '0');
 			++line;
 		}
 
-		if (line == start) return false;
-	
-		size_t size = line - start;	
+		return line != start && _line_is_token_end(*line, delimiters, delimiter_count);
+	}
 
-		char value_str[50u];
-		memcpy(value_str, start, size);
-		value_str[size] = '\0';
-		value = atol(value_str);
+    SV_INLINE bool line_read_i32(const char*& line, i32& value, const char* delimiters, u32 delimiter_count)
+    {
+		u64 n;
+		bool negative;
+		bool res = _line_read_integer(line, n, negative, delimiters, delimiter_count);
 
-		return true;
+		value = res ? (negative ? -i32(n) : i32(n)) : 0;
+		return res;
+    }
+
+	SV_INLINE bool line_read_i64(const char*& line, i64& value, const char* delimiters, u32 delimiter_count)
+    {
+		u64 n;
+		bool negative;
+		bool res = _line_read_integer(line, n, negative, delimiters, delimiter_count);
+
+		value = res ? (negative ? -i64(n) : i64(n)) : 0;
+		return res;
     }
 
     SV_INLINE bool line_read_v3_f32(const char*& line, v3_f32& value)
@@ -1,4 +1,5 @@
 #include "core/asset_system.h"
+#include "core/event_system.h"
 #include "utils/allocators.h"
 #include "utils/string.h"
 
@@ -6,6 +7,8 @@ namespace sv {
 
     // Time to update one asset type, after this time will update the next type
     constexpr float UNUSED_CHECK_TIME = 1.f;
+	// Min time between two evictions of the same type
+	constexpr f64 EVICTION_CHECK_TIME = 0.1;
 
 	struct Asset_internal;
 
@@ -16,12 +19,27 @@ namespace sv {
 		AssetLoadFileFn	  load_file_fn;
 		AssetReloadFileFn reload_file_fn;
 		AssetFreeFn 	  free_fn;
+		AssetPrepareFileFn  prepare_file_fn;
+		AssetLoadPreparedFn load_prepared_fn;
+		AssetDependenciesFn dependencies_fn;
+		AssetSizeFn         size_fn;
+		u32                 asset_size;
 		f32		          unused_time;
 		f64		          last_update = 0.0;
 		u32               extension_count;
 		char              extensions[ASSET_EXTENSION_NAME_SIZE + 1u][ASSET_TYPE_EXTENSION_MAX];
 		
-		ThickHashTable<Asset_internal*, 100u> name_table;
+		HashMap<const char*, Asset_internal*> name_table;
+
+		// Memory residency
+		size_t cpu_size = 0u;
+		size_t gpu_size = 0u;
+		size_t cpu_budget = 0u;
+		size_t gpu_budget = 0u;
+		f64    last_eviction = 0.0;
+		bool   budget_warning = false;
+
+		AssetTelemetry telemetry = {};
 		
 		SizedInstanceAllocator allocator;
 
@@ -29,6 +47,12 @@ namespace sv {
 
     };
 
+	enum AssetState : u32 {
+		AssetState_Ready,
+		AssetState_Loading,
+		AssetState_Failed,
+	};
+
     struct Asset_internal {
 
 		std::atomic<i32>	ref_count = 0;
@@ -39,26 +63,121 @@ namespace sv {
 		Date                last_write_date;
 		char			    name[ASSET_NAME_SIZE + 1u] = "";
 		AssetType_internal* type = NULL;
+		AssetState          state = AssetState_Ready;
+		bool                constructed = true; // The content exists and needs the free function, false if the load failed before creating it
+		size_t              cpu_size = 0u;
+		size_t              gpu_size = 0u;
+		std::atomic<f64>    unreferenced_time = f64_max; // Set when the last reference is released, used to evict the least recently used
 
     };
 
+	struct AssetLoadJob {
+
+		Asset_internal*    asset;
+		AssetPrepareFileFn prepare_fn;
+		char               filepath[FILEPATH_SIZE + 1u];
+		void*              prepared = NULL;
+		std::atomic<bool>  done = false;
+		f64                begin_time;
+		f64                prepare_time;
+		f64                read_time;
+		u64                read_bytes;
+		
+	};
+
+	struct AssetPrefetch {
+		
+		char          name[FILEPATH_SIZE + 1u];
+		f64           begin_time;
+		List<AssetPtr> assets;
+		
+	};
+
 	struct AssetSystemData {
 		
 		List<AssetType_internal*>             asset_types;
-		ThickHashTable<Asset_internal*, 2000> filepath_table;
-		ThickHashTable<AssetType_internal*, 100>   extension_table;
+		HashMap<const char*, Asset_internal*>     filepath_table;
+		HashMap<const char*, AssetType_internal*> extension_table;
 
 		u32 check_type_index = 0u;
 		f32 check_time = 0.f;
 		List<Asset_internal*> free_assets_list;
+
+		List<AssetLoadJob*> loading_jobs;
+		List<AssetLoadJob*> finished_jobs;
+		TaskContext         loading_context;
+
+		List<AssetPrefetch*> prefetchs;
+
+		bool                          recording = false;
+		List<Asset_internal*>         recorded_assets;
+		HashMap<Asset_internal*, u32> recorded_table; // Index in recorded_assets
+
+		HashMap<const char*, AssetTelemetry> telemetry_table;
+		List<AssetTelemetry>                 telemetry_list;
+
+#if SV_EDITOR
+		FileWatcher* watcher = NULL;
+		char         watcher_path[FILEPATH_SIZE + 1u] = "";
+#endif
 		
 	};
 
     static AssetSystemData* asset_system = NULL;
 
+	// Read time reported by the callbacks of the load executed in this thread
+	struct AssetTelemetryScope {
+		f64 read_time;
+		u64 read_bytes;
+	};
+
+	static thread_local AssetTelemetryScope* telemetry_scope = NULL;
+
+	SV_AUX void record_load(AssetType_internal* type, const char* filepath, bool success, const AssetTelemetryScope& scope, f64 prepare_time, f64 gpu_time)
+	{
+		AssetTelemetry& file = asset_system->telemetry_table[filepath];
+		file.type_name = type->name;
+
+		AssetTelemetry* records[] = { &type->telemetry, &file };
+
+		for (AssetTelemetry* t : records) {
+
+			if (success) ++t->load_count;
+			else ++t->failed_count;
+
+			t->read_bytes += scope.read_bytes;
+			t->read_time += scope.read_time;
+			t->decode_time += SV_MAX(prepare_time - scope.read_time, 0.0);
+			t->gpu_time += gpu_time;
+		}
+	}
+
+	SV_AUX void record_request(AssetType_internal* type, const char* filepath, bool hit)
+	{
+		AssetTelemetry& file = asset_system->telemetry_table[filepath];
+		file.type_name = type->name;
+
+		if (hit) {
+			++type->telemetry.hit_count;
+			++file.hit_count;
+		}
+		else {
+			++type->telemetry.miss_count;
+			++file.miss_count;
+		}
+	}
+
     SV_AUX bool destroy_asset(Asset_internal* asset, AssetType_internal* type)
     {
-		bool res = type->free_fn(asset + 1u, asset->name);
+		bool res = true;
+
+		// A failed load can leave a constructed asset
+		if (asset->constructed)
+			res = type->free_fn(asset + 1u, asset->name);
+
+		type->cpu_size -= asset->cpu_size;
+		type->gpu_size -= asset->gpu_size;
+		
 		type->allocator.free(asset);
 
 		bool log = false;
@@ -91,8 +210,321 @@ namespace sv {
 		return res;
     }
 
+	void _asset_unreferenced(void* ptr)
+	{
+		Asset_internal* asset = reinterpret_cast<Asset_internal*>(ptr);
+		asset->unreferenced_time.store(timer_now());
+	}
+
+	// Frees an unreferenced asset to release memory
+	SV_AUX void evict_asset(Asset_internal* asset, AssetType_internal* type)
+	{
+		++type->telemetry.eviction_count;
+
+		if (asset->filepath[0]) {
+
+			AssetTelemetry* file = asset_system->telemetry_table.find(asset->filepath);
+			if (file) ++file->eviction_count;
+		}
+
+		destroy_asset(asset, type);
+	}
+
+	SV_AUX void update_asset_size(Asset_internal* asset)
+	{
+		AssetType_internal* type = asset->type;
+
+		size_t cpu_size = 0u;
+		size_t gpu_size = 0u;
+
+		if (asset->state == AssetState_Ready && type->size_fn)
+			type->size_fn(asset + 1u, &cpu_size, &gpu_size);
+
+		cpu_size += type->asset_size;
+
+		type->cpu_size = type->cpu_size - asset->cpu_size + cpu_size;
+		type->gpu_size = type->gpu_size - asset->gpu_size + gpu_size;
+		asset->cpu_size = cpu_size;
+		asset->gpu_size = gpu_size;
+	}
+
+	SV_AUX bool has_budget(AssetType_internal* type)
+	{
+		return type->cpu_budget != 0u || type->gpu_budget != 0u;
+	}
+
+	SV_AUX bool is_over_budget(AssetType_internal* type)
+	{
+		return (type->cpu_budget && type->cpu_size > type->cpu_budget) || (type->gpu_budget && type->gpu_size > type->gpu_budget);
+	}
+
+	// Frees the unreferenced assets, starting with the least recently used, until the type is under budget
+	SV_INTERNAL void evict_assets(AssetType_internal* type, f64 now)
+	{
+		// The release time is copied, other threads can release references while sorting
+		struct EvictCandidate {
+			Asset_internal* asset;
+			f64             unreferenced_time;
+		};
+		
+		List<EvictCandidate> candidates;
+
+		for (auto& pool : type->allocator) {
+			for (void* _ptr : pool) {
+
+				Asset_internal* asset = reinterpret_cast<Asset_internal*>(_ptr);
+
+				if (asset->state == AssetState_Loading || asset->ref_count.load() > 0) continue;
+
+				candidates.push_back({ asset, asset->unreferenced_time.load() });
+			}
+		}
+
+		std::sort(candidates.data(), candidates.data() + candidates.size(), [](const EvictCandidate& c0, const EvictCandidate& c1) {
+			return c0.unreferenced_time < c1.unreferenced_time;
+		});
+
+		size_t cpu_size = type->cpu_size;
+		size_t gpu_size = type->gpu_size;
+		u32 count = 0u;
+
+		for (const EvictCandidate& c : candidates) {
+
+			if (!is_over_budget(type)) break;
+
+			evict_asset(c.asset, type);
+			++count;
+		}
+
+		if (count) {
+			SV_LOG_INFO("%s: %u assets evicted, %.2f MB CPU and %.2f MB GPU released", type->name, count, f32(cpu_size - type->cpu_size) / (1024.f * 1024.f), f32(gpu_size - type->gpu_size) / (1024.f * 1024.f));
+		}
+
+		type->last_eviction = now;
+
+		if (is_over_budget(type)) {
+
+			if (!type->budget_warning) {
+				SV_LOG_WARNING("%s exceeds the memory budget and all the remaining assets are referenced", type->name);
+				type->budget_warning = true;
+			}
+		}
+		else type->budget_warning = false;
+	}
+
+	SV_INTERNAL void asset_prepare_task(void* data)
+	{
+		AssetLoadJob* job = *reinterpret_cast<AssetLoadJob**>(data);
+
+		// The task can run inside a task_wait of other load, the previous scope is restored
+		AssetTelemetryScope scope = {};
+		AssetTelemetryScope* last_scope = telemetry_scope;
+		telemetry_scope = &scope;
+
+		f64 begin = timer_now();
+		job->prepared = job->prepare_fn(job->filepath);
+		job->prepare_time = timer_now() - begin;
+
+		telemetry_scope = last_scope;
+		job->read_time = scope.read_time;
+		job->read_bytes = scope.read_bytes;
+		
+		job->done = true;
+	}
+
+	SV_AUX void finish_asset_load(AssetLoadJob* job)
+	{
+		Asset_internal* asset = job->asset;
+		AssetType_internal* type = asset->type;
+
+		bool res = job->prepared != NULL;
+		f64 gpu_time = 0.0;
+
+		if (res) {
+			
+			f64 begin = timer_now();
+			asset->constructed = true;
+			res = type->load_prepared_fn(asset + 1u, asset->name, asset->filepath, job->prepared);
+			gpu_time = timer_now() - begin;
+		}
+
+		AssetTelemetryScope scope;
+		scope.read_time = job->read_time;
+		scope.read_bytes = job->read_bytes;
+		record_load(type, job->filepath, res, scope, job->prepare_time, gpu_time);
+
+		if (res) {
+
+			asset->state = AssetState_Ready;
+			update_asset_size(asset);
+			file_date(asset->filepath, NULL, &asset->last_write_date, NULL);
+
+			f64 total = timer_now() - job->begin_time;
+			SV_LOG_INFO("%s loaded: %s (%.2f ms, prepare %.2f ms)", type->name, asset->filepath, f32(total * 1000.0), f32(job->prepare_time * 1000.0));
+		}
+		else {
+
+			SV_LOG_ERROR("Can't load the asset '%s'", asset->filepath);
+
+			// The asset remains allocated without content until is released
+			asset->state = AssetState_Failed;
+			update_asset_size(asset);
+			asset_system->filepath_table.erase(asset->filepath);
+			asset->filepath[0] = '\0';
+		}
+
+		AssetLoadedEvent e;
+		e.asset_ptr = AssetPtr(asset);
+		e.filepath = job->filepath;
+		e.success = res;
+		event_dispatch("asset_loaded", &e);
+		
+		SV_FREE_STRUCT(job);
+	}
+
+	SV_AUX void update_loading_assets()
+	{
+		List<AssetLoadJob*>& jobs = asset_system->loading_jobs;
+		List<AssetLoadJob*>& finished = asset_system->finished_jobs;
+
+		if (jobs.empty()) return;
+
+		finished.reset();
+
+		u32 count = 0u;
+
+		foreach(i, jobs.size()) {
+
+			AssetLoadJob* job = jobs[i];
+
+			if (job->done.load()) finished.push_back(job);
+			else jobs[count++] = job;
+		}
+
+		jobs.resize(count);
+
+		// Finishing an asset can start other loadings
+		foreach(i, finished.size()) {
+			finish_asset_load(finished[i]);
+		}
+		finished.reset();
+	}
+
+	SV_AUX void update_prefetchs()
+	{
+		List<AssetPrefetch*>& prefetchs = asset_system->prefetchs;
+		u32 count = 0u;
+
+		foreach(i, prefetchs.size()) {
+
+			AssetPrefetch* prefetch = prefetchs[i];
+
+			bool finished = true;
+			u32 loaded = 0u;
+			
+			for (const AssetPtr& asset_ptr : prefetch->assets) {
+
+				AssetState state = reinterpret_cast<Asset_internal*>(asset_ptr.ptr)->state;
+				
+				if (state == AssetState_Loading) {
+					finished = false;
+					break;
+				}
+				if (state == AssetState_Ready) ++loaded;
+			}
+
+			if (finished) {
+
+				f64 total = timer_now() - prefetch->begin_time;
+				SV_LOG_INFO("Prefetch '%s': %u/%u assets loaded in %.2f ms", prefetch->name, loaded, u32(prefetch->assets.size()), f32(total * 1000.0));
+				
+				SV_FREE_STRUCT(prefetch);
+			}
+			else prefetchs[count++] = prefetch;
+		}
+
+		prefetchs.resize(count);
+	}
+
+	void _wait_assets()
+	{
+		while (!asset_system->loading_jobs.empty()) {
+
+			task_wait(asset_system->loading_context);
+			update_loading_assets();
+		}
+
+		update_prefetchs();
+	}
+
+#if SV_EDITOR
+
+	// Only the files notified by the file watcher are checked
+	SV_INTERNAL void reload_modified_assets()
+	{
+		// The asset filepaths are relative to the project
+		if (!string_equals(asset_system->watcher_path, engine.project_path)) {
+
+			file_watcher_destroy(asset_system->watcher);
+			asset_system->watcher = file_watcher_create("");
+			string_copy(asset_system->watcher_path, engine.project_path, FILEPATH_SIZE + 1u);
+		}
+
+		if (asset_system->watcher == NULL) return;
+
+		char filepath[FILEPATH_SIZE + 1u];
+
+		while (file_watcher_pop(asset_system->watcher, filepath)) {
+
+			Asset_internal** asset_ = asset_system->filepath_table.find(filepath);
+			if (asset_ == NULL) continue;
+
+			Asset_internal* asset = *asset_;
+			AssetType_internal* type = asset->type;
+
+			if (asset->state != AssetState_Ready || type->reload_file_fn == NULL) continue;
+
+			Date last_write;
+			if (!file_date(asset->filepath, NULL, &last_write, NULL)) continue;
+
+			if (asset->last_write_date != last_write) {
+
+				if (type->reload_file_fn(asset + 1u, asset->name, asset->filepath)) {
+					update_asset_size(asset);
+					SV_LOG_INFO("%s asset reloaded: '%s'", type->name, asset->filepath);
+				}
+				else {
+					SV_LOG_ERROR("Can't reload the %s asset: '%s'", type->name, asset->filepath);
+				}
+
+				asset->last_write_date = last_write;
+			}
+		}
+	}
+
+#endif
+
     void _update_assets()
     {
+		update_loading_assets();
+		update_prefetchs();
+
+#if SV_EDITOR
+		reload_modified_assets();
+#endif
+
+		// The sizes are tracked incrementally, only the types over budget are traversed
+		{
+			f64 now = timer_now();
+
+			for (AssetType_internal* type : asset_system->asset_types) {
+
+				if (has_budget(type) && is_over_budget(type) && now - type->last_eviction >= EVICTION_CHECK_TIME) {
+					evict_assets(type, now);
+				}
+			}
+		}
+		
 		asset_system->check_time += engine.deltatime;
 
 		if (asset_system->check_time >= UNUSED_CHECK_TIME) {
@@ -108,10 +540,18 @@ namespace sv {
 
 					Asset_internal* asset = reinterpret_cast<Asset_internal*>(_ptr);
 
+					if (asset->state == AssetState_Loading) continue;
+
+					// The content can change after loading
+					update_asset_size(asset);
+
 					i32 ref_count = asset->ref_count.load();
 
 					if (ref_count <= 0) {
 
+						// With budget, the unreferenced assets are kept until the budget is exceeded
+						if (has_budget(type)) continue;
+
 						if (asset->unused_time == f32_max) {
 
 							asset->unused_time = type->unused_time;
@@ -126,27 +566,6 @@ namespace sv {
 					}
 					else {
 						asset->unused_time = f32_max;
-
-#if SV_EDITOR
-						if (asset->filepath[0] && type->reload_file_fn) {
-
-							Date last_write;
-							if (file_date(asset->filepath, NULL, &last_write, NULL)) {
-
-								if (asset->last_write_date != last_write) {
-
-									if (type->reload_file_fn(asset + 1u, asset->name, asset->filepath)) {
-										SV_LOG_INFO("%s asset reloaded: '%s'", type->name, asset->filepath);
-									}
-									else {
-										SV_LOG_ERROR("Can't reload the %s asset: '%s'", type->name, asset->filepath);
-									}
-
-									asset->last_write_date = last_write;
-								}
-							}
-						}
-#endif
 					}
 				}
 			}
@@ -154,7 +573,7 @@ namespace sv {
 			// Free assets
 			for (Asset_internal* asset : asset_system->free_assets_list) {
 
-				destroy_asset(asset, type);
+				evict_asset(asset, type);
 				// TODO: this can fail...
 			}
 
@@ -167,18 +586,28 @@ namespace sv {
 	void _initialize_assets()
 	{
 		asset_system = SV_ALLOCATE_STRUCT(AssetSystemData, "AssetSystem");
+
+#if SV_EDITOR
+		asset_system->watcher = file_watcher_create("");
+		string_copy(asset_system->watcher_path, engine.project_path, FILEPATH_SIZE + 1u);
+#endif
 	}
 
     void _close_assets()
     {
 		if (asset_system) {
-			
+
+			_wait_assets();
 			free_unused_assets();
 
+#if SV_EDITOR
+			file_watcher_destroy(asset_system->watcher);
+#endif
+
 			for (AssetType_internal* type : asset_system->asset_types) {
 
 				type->allocator.clear();
-				SV_FREE_MEMORY(type);
+				SV_FREE_STRUCT(type);
 			}
 			asset_system->asset_types.clear();
 
@@ -186,6 +615,13 @@ namespace sv {
 			asset_system->extension_table.clear();
 
 			asset_system->free_assets_list.clear();
+			asset_system->loading_jobs.clear();
+			asset_system->finished_jobs.clear();
+			asset_system->prefetchs.clear();
+			asset_system->recorded_assets.clear();
+			asset_system->recorded_table.clear();
+			asset_system->telemetry_table.clear();
+			asset_system->telemetry_list.clear();
 
 			SV_FREE_STRUCT(asset_system);
 			asset_system = NULL;
@@ -283,6 +719,8 @@ namespace sv {
 			return false;
 		}
 
+		update_asset_size(asset);
+
 		if (string_size(name))
 			type->name_table[name] = asset;
 
@@ -333,7 +771,21 @@ namespace sv {
 			Asset_internal* asset = new(type->allocator.alloc()) Asset_internal();
 			asset->type = type;
 
-			if (!type->load_file_fn(asset + 1u, asset->name, filepath)) {
+			record_request(type, filepath, false);
+
+			// The load functions can load dependencies, they are not counted in this scope
+			AssetTelemetryScope scope = {};
+			AssetTelemetryScope* last_scope = telemetry_scope;
+			telemetry_scope = &scope;
+
+			f64 begin = timer_now();
+			bool res = type->load_file_fn(asset + 1u, asset->name, filepath);
+			f64 load_time = timer_now() - begin;
+
+			telemetry_scope = last_scope;
+			record_load(type, filepath, res, scope, load_time, 0.0);
+
+			if (!res) {
 
 				SV_LOG_ERROR("Can't load the asset '%s'", filepath);
 
@@ -345,12 +797,29 @@ namespace sv {
 			string_copy(asset->filepath, filepath, FILEPATH_SIZE + 1u);
 			asset_ptr = AssetPtr(asset);
 
+			update_asset_size(asset);
+
 			file_date(filepath, NULL, &asset->last_write_date, NULL);
 
 			SV_LOG_INFO("%s loaded: %s", type->name, filepath);
 		}
 		else {
-			asset_ptr = AssetPtr(*asset_);
+
+			Asset_internal* asset = *asset_;
+			asset_ptr = AssetPtr(asset);
+
+			record_request(asset->type, filepath, true);
+
+			if (asset->state == AssetState_Loading) {
+
+				while (asset->state == AssetState_Loading) {
+
+					task_wait(asset_system->loading_context);
+					update_loading_assets();
+				}
+				
+				return asset->state == AssetState_Ready;
+			}
 		}
 
 		return true;
@@ -358,8 +827,44 @@ namespace sv {
 
 	SV_AUX bool load_asset_keep_it_loading(AssetPtr& asset_ptr, const char* filepath)
 	{
-		// TODO
-		return load_asset_right_now(asset_ptr, filepath);
+		Asset_internal** asset_ = asset_system->filepath_table.find(filepath);
+
+		if (asset_) {
+			asset_ptr = AssetPtr(*asset_);
+			record_request((*asset_)->type, filepath, true);
+			return true;
+		}
+
+		size_t size = string_size(filepath);
+		AssetType_internal* type = get_type_from_filepath(size, filepath);
+		if (type == NULL) return false;
+
+		if (type->prepare_file_fn == NULL || type->load_prepared_fn == NULL || size > FILEPATH_SIZE) {
+			return load_asset_right_now(asset_ptr, filepath);
+		}
+
+		Asset_internal* asset = new(type->allocator.alloc()) Asset_internal();
+		asset->type = type;
+		asset->state = AssetState_Loading;
+		asset->constructed = false;
+		string_copy(asset->filepath, filepath, FILEPATH_SIZE + 1u);
+
+		asset_system->filepath_table[filepath] = asset;
+		asset_ptr = AssetPtr(asset);
+
+		record_request(type, filepath, false);
+
+		AssetLoadJob* job = SV_ALLOCATE_STRUCT(AssetLoadJob, "AssetSystem");
+		job->begin_time = timer_now();
+		job->asset = asset;
+		job->prepare_fn = type->prepare_file_fn;
+		string_copy(job->filepath, filepath, FILEPATH_SIZE + 1u);
+
+		asset_system->loading_jobs.push_back(job);
+
+		task_dispatch(asset_prepare_task, &job, sizeof(job), &asset_system->loading_context);
+		
+		return true;
 	}
 
 	SV_AUX bool load_asset_get_if_exists(AssetPtr& asset_ptr, const char* filepath)
@@ -368,6 +873,7 @@ namespace sv {
 
 		if (asset_) {
 			asset_ptr = AssetPtr(*asset_);
+			record_request((*asset_)->type, filepath, true);
 			return true;
 		}
 
@@ -437,7 +943,11 @@ namespace sv {
 
     void* get_asset_content(const AssetPtr& asset_ptr)
     {
-		if (asset_ptr.ptr) return reinterpret_cast<Asset_internal*>(asset_ptr.ptr) + 1u;
+		if (asset_ptr.ptr) {
+
+			Asset_internal* asset = reinterpret_cast<Asset_internal*>(asset_ptr.ptr);
+			if (asset->state == AssetState_Ready) return asset + 1u;
+		}
 		return nullptr;
     }
 
@@ -472,6 +982,15 @@ namespace sv {
 		return false;
 	}
 
+	bool asset_is_ready(const AssetPtr& asset_ptr)
+	{
+		if (asset_ptr.ptr) {
+			
+			return reinterpret_cast<Asset_internal*>(asset_ptr.ptr)->state == AssetState_Ready;
+		}
+		return false;
+	}
+
     bool register_asset_type(const AssetTypeDesc* desc)
     {
 		// TODO: Check if the extensions or the name is repeated or if the extension name is too large
@@ -485,6 +1004,11 @@ namespace sv {
 		type->load_file_fn = desc->load_file_fn;
 		type->reload_file_fn = desc->reload_file_fn;
 		type->free_fn = desc->free_fn;
+		type->prepare_file_fn = desc->prepare_file_fn;
+		type->load_prepared_fn = desc->load_prepared_fn;
+		type->dependencies_fn = desc->dependencies_fn;
+		type->size_fn = desc->size_fn;
+		type->asset_size = desc->asset_size;
 		type->unused_time = desc->unused_time;
 
 		type->extension_count = desc->extension_count;
@@ -499,6 +1023,307 @@ namespace sv {
 		return true;
     }
 
+	bool asset_type_set_budget(const char* type_name, size_t cpu_budget, size_t gpu_budget)
+	{
+		AssetType_internal* type = get_type_from_typename(type_name);
+		if (type == NULL) {
+			SV_LOG_ERROR("Asset type '%s' not found", type_name);
+			return false;
+		}
+
+		type->cpu_budget = cpu_budget;
+		type->gpu_budget = gpu_budget;
+		type->budget_warning = false;
+		type->last_eviction = 0.0;
+		return true;
+	}
+
+	u32 asset_residency_report(AssetTypeResidency* report, u32 max_count)
+	{
+		u32 count = SV_MIN(max_count, u32(asset_system->asset_types.size()));
+
+		foreach(i, count) {
+
+			AssetType_internal* type = asset_system->asset_types[i];
+			AssetTypeResidency& r = report[i];
+
+			r.type_name = type->name;
+			r.asset_count = 0u;
+			r.unreferenced_count = 0u;
+			r.cpu_size = type->cpu_size;
+			r.gpu_size = type->gpu_size;
+			r.cpu_budget = type->cpu_budget;
+			r.gpu_budget = type->gpu_budget;
+
+			for (auto& pool : type->allocator) {
+				for (void* _ptr : pool) {
+
+					Asset_internal* asset = reinterpret_cast<Asset_internal*>(_ptr);
+
+					++r.asset_count;
+					if (asset->ref_count.load() <= 0) ++r.unreferenced_count;
+				}
+			}
+		}
+
+		return count;
+	}
+
+	void asset_residency_log()
+	{
+		constexpr f32 MB = 1024.f * 1024.f;
+
+		AssetTypeResidency report[30u];
+		u32 count = asset_residency_report(report, 30u);
+
+		size_t cpu_size = 0u;
+		size_t gpu_size = 0u;
+
+		foreach(i, count) {
+
+			const AssetTypeResidency& r = report[i];
+
+			SV_LOG_INFO("%s: %u assets (%u unreferenced), CPU %.2f MB / %.2f MB, GPU %.2f MB / %.2f MB", r.type_name, r.asset_count, r.unreferenced_count, f32(r.cpu_size) / MB, f32(r.cpu_budget) / MB, f32(r.gpu_size) / MB, f32(r.gpu_budget) / MB);
+
+			cpu_size += r.cpu_size;
+			gpu_size += r.gpu_size;
+		}
+
+		SV_LOG_INFO("Total assets memory: CPU %.2f MB, GPU %.2f MB", f32(cpu_size) / MB, f32(gpu_size) / MB);
+	}
+
+	static thread_local List<AssetRequest>* bound_requests = NULL;
+
+	void asset_requests_bind(List<AssetRequest>* requests)
+	{
+		bound_requests = requests;
+	}
+
+	bool asset_request_defer(AssetPtr& asset_ptr, const char* filepath, const char* name, AssetLoadingPriority priority, bool from_name)
+	{
+		if (bound_requests == NULL) return false;
+
+		AssetRequest& req = bound_requests->emplace_back();
+		req.asset_ptr = &asset_ptr;
+		req.priority = priority;
+		req.from_name = from_name;
+		string_copy(req.filepath, filepath, FILEPATH_SIZE + 1u);
+		string_copy(req.name, name ? name : "", ASSET_NAME_SIZE + 1u);
+		
+		return true;
+	}
+
+	void asset_requests_execute(const AssetRequest* requests, u32 count)
+	{
+		foreach(i, count) {
+
+			const AssetRequest& req = requests[i];
+			AssetPtr& asset_ptr = *req.asset_ptr;
+
+			if (req.from_name) {
+
+				if (!create_asset_from_name(asset_ptr, req.filepath, req.name)) {
+					SV_LOG_ERROR("Can't create asset from name '%s'", req.name);
+				}
+			}
+			else {
+
+				if (!load_asset_from_file(asset_ptr, req.filepath, req.priority)) {
+					SV_LOG_ERROR("Can't load the asset '%s'", req.filepath);
+				}
+
+				if (req.name[0] && !set_asset_name(asset_ptr, req.name)) {
+					SV_LOG_ERROR("Can't set the asset name '%s'", req.name);
+				}
+			}
+		}
+	}
+
+	void asset_telemetry_read(f64 time, size_t bytes)
+	{
+		if (telemetry_scope) {
+			telemetry_scope->read_time += time;
+			telemetry_scope->read_bytes += u64(bytes);
+		}
+	}
+
+	u32 asset_telemetry_types(AssetTelemetry* telemetry, u32 max_count)
+	{
+		u32 count = SV_MIN(max_count, u32(asset_system->asset_types.size()));
+
+		foreach(i, count) {
+
+			AssetType_internal* type = asset_system->asset_types[i];
+			
+			telemetry[i] = type->telemetry;
+			telemetry[i].type_name = type->name;
+			telemetry[i].filepath = NULL;
+		}
+
+		return count;
+	}
+
+	u32 asset_telemetry_asset_count()
+	{
+		return u32(asset_system->telemetry_table.size());
+	}
+
+	SV_AUX f64 telemetry_total_time(const AssetTelemetry& t)
+	{
+		return t.read_time + t.decode_time + t.gpu_time;
+	}
+
+	u32 asset_telemetry_assets(AssetTelemetry* telemetry, u32 max_count)
+	{
+		List<AssetTelemetry>& list = asset_system->telemetry_list;
+		list.reset();
+
+		for (auto it = asset_system->telemetry_table.begin(); it != asset_system->telemetry_table.end(); ++it) {
+
+			AssetTelemetry& t = list.emplace_back();
+			t = *it;
+			t.filepath = it.key();
+		}
+
+		std::sort(list.data(), list.data() + list.size(), [](const AssetTelemetry& t0, const AssetTelemetry& t1) {
+			return telemetry_total_time(t0) > telemetry_total_time(t1);
+		});
+
+		u32 count = SV_MIN(max_count, u32(list.size()));
+		memcpy(telemetry, list.data(), sizeof(AssetTelemetry) * count);
+
+		list.reset();
+		return count;
+	}
+
+	void asset_telemetry_reset()
+	{
+		asset_system->telemetry_table.clear();
+
+		for (AssetType_internal* type : asset_system->asset_types) {
+			type->telemetry = {};
+		}
+	}
+
+	void asset_telemetry_log(u32 count)
+	{
+		constexpr f32 MB = 1024.f * 1024.f;
+		
+		AssetTelemetry types[30u];
+		u32 type_count = asset_telemetry_types(types, 30u);
+
+		foreach(i, type_count) {
+
+			const AssetTelemetry& t = types[i];
+
+			u32 requests = t.hit_count + t.miss_count;
+			f32 hit_rate = requests ? (f32(t.hit_count) / f32(requests) * 100.f) : 0.f;
+			
+			SV_LOG_INFO("%s: %u loads (%u failed), %.2f MB read, read %.2f ms, decode %.2f ms, gpu %.2f ms, hits %.1f%% (%u/%u), %u evictions", t.type_name, t.load_count, t.failed_count, f32(t.read_bytes) / MB, f32(t.read_time * 1000.0), f32(t.decode_time * 1000.0), f32(t.gpu_time * 1000.0), hit_rate, t.hit_count, requests, t.eviction_count);
+		}
+
+		count = SV_MIN(count, asset_telemetry_asset_count());
+		if (count == 0u) return;
+
+		List<AssetTelemetry> assets;
+		assets.resize(count);
+		count = asset_telemetry_assets(assets.data(), count);
+
+		SV_LOG_INFO("Slowest assets:");
+
+		foreach(i, count) {
+
+			const AssetTelemetry& t = assets[i];
+			SV_LOG_INFO("%.2f ms '%s' (read %.2f ms, decode %.2f ms, gpu %.2f ms, %u loads)", f32(telemetry_total_time(t) * 1000.0), t.filepath, f32(t.read_time * 1000.0), f32(t.decode_time * 1000.0), f32(t.gpu_time * 1000.0), t.load_count);
+		}
+	}
+
+	SV_AUX void telemetry_append_csv(String& str, const AssetTelemetry& t)
+	{
+		char line[FILEPATH_SIZE + 300u];
+		sprintf(line, "%s,%s,%u,%u,%u,%u,%u,%llu,%.4f,%.4f,%.4f\n", t.type_name, t.filepath ? t.filepath : "", t.load_count, t.failed_count, t.hit_count, t.miss_count, t.eviction_count, (unsigned long long)t.read_bytes, t.read_time * 1000.0, t.decode_time * 1000.0, t.gpu_time * 1000.0);
+		str.append(line);
+	}
+
+	SV_AUX void telemetry_append_json(String& str, const AssetTelemetry& t, bool last)
+	{
+		str.append("\t\t{ \"type\": \"");
+		str.append(t.type_name);
+		str.append("\"");
+
+		if (t.filepath) {
+
+			str.append(", \"filepath\": \"");
+
+			for (const char* c = t.filepath; *c; ++c) {
+				if (*c == '"' || *c == '\\') str.append('\\');
+				str.append(*c);
+			}
+			
+			str.append("\"");
+		}
+		
+		char line[300u];
+		sprintf(line, ", \"loads\": %u, \"failed\": %u, \"hits\": %u, \"misses\": %u, \"evictions\": %u, \"read_bytes\": %llu, \"read_ms\": %.4f, \"decode_ms\": %.4f, \"gpu_ms\": %.4f }%s\n", t.load_count, t.failed_count, t.hit_count, t.miss_count, t.eviction_count, (unsigned long long)t.read_bytes, t.read_time * 1000.0, t.decode_time * 1000.0, t.gpu_time * 1000.0, last ? "" : ",");
+		str.append(line);
+	}
+
+	bool asset_telemetry_dump(const char* filepath)
+	{
+		const char* extension = filepath_extension(filepath);
+		
+		bool json = extension && string_equals(extension, ".json");
+		bool csv = extension && string_equals(extension, ".csv");
+
+		if (!json && !csv) {
+			SV_LOG_ERROR("Unknown telemetry format '%s', use .csv or .json", filepath);
+			return false;
+		}
+
+		AssetTelemetry types[30u];
+		u32 type_count = asset_telemetry_types(types, 30u);
+
+		List<AssetTelemetry> assets;
+		assets.resize(asset_telemetry_asset_count());
+		u32 asset_count = asset_telemetry_assets(assets.data(), u32(assets.size()));
+
+		String str;
+
+		if (csv) {
+
+			// The type records have no filepath
+			str.append("type,filepath,loads,failed,hits,misses,evictions,read_bytes,read_ms,decode_ms,gpu_ms\n");
+
+			foreach(i, type_count)
+				telemetry_append_csv(str, types[i]);
+
+			foreach(i, asset_count)
+				telemetry_append_csv(str, assets[i]);
+		}
+		else {
+
+			str.append("{\n\t\"types\": [\n");
+
+			foreach(i, type_count)
+				telemetry_append_json(str, types[i], i + 1u == type_count);
+
+			str.append("\t],\n\t\"assets\": [\n");
+
+			foreach(i, asset_count)
+				telemetry_append_json(str, assets[i], i + 1u == asset_count);
+
+			str.append("\t]\n}\n");
+		}
+
+		if (!file_write_text(filepath, str.c_str(), str.size())) {
+			SV_LOG_ERROR("Can't write the telemetry file '%s'", filepath);
+			return false;
+		}
+
+		SV_LOG_INFO("Asset telemetry saved at '%s'", filepath);
+		return true;
+	}
+
     void update_asset_files()
     {
 		SV_LOG("TODO");
@@ -517,7 +1342,7 @@ namespace sv {
 
 						Asset_internal* asset = reinterpret_cast<Asset_internal*>(_ptr);
 
-						if (asset->ref_count.load() <= 0) {
+						if (asset->ref_count.load() <= 0 && asset->state != AssetState_Loading) {
 
 							asset_system->free_assets_list.push_back(asset);
 						}
@@ -534,4 +1359,94 @@ namespace sv {
 		}
     }
 
+
+	void asset_dependencies_record_begin()
+	{
+		asset_system->recording = true;
+		asset_system->recorded_assets.reset();
+		asset_system->recorded_table.clear();
+	}
+
+	void asset_dependencies_record_end(Serializer& s)
+	{
+		List<Asset_internal*>& assets = asset_system->recorded_assets;
+		
+		serialize_u32(s, u32(assets.size()));
+
+		for (Asset_internal* asset : assets) {
+			serialize_string(s, asset->filepath);
+		}
+
+		assets.clear();
+		asset_system->recorded_table.clear();
+		asset_system->recording = false;
+	}
+
+	void asset_dependency_record(const AssetPtr& asset_ptr)
+	{
+		if (!asset_system->recording || asset_ptr.ptr == NULL) return;
+
+		Asset_internal* asset = reinterpret_cast<Asset_internal*>(asset_ptr.ptr);
+
+		if (asset->filepath[0] == '\0') return;
+
+		// The list keeps the serialization order, the table avoids the duplicates
+		if (asset_system->recorded_table.find(asset)) return;
+
+		asset_system->recorded_table[asset] = u32(asset_system->recorded_assets.size());
+		asset_system->recorded_assets.push_back(asset);
+
+		AssetType_internal* type = asset->type;
+		
+		if (type->dependencies_fn && asset->state == AssetState_Ready) {
+
+			// Use a local list, the recursion uses the same function
+			List<AssetPtr> dependencies;
+			type->dependencies_fn(asset + 1u, dependencies);
+
+			for (const AssetPtr& dep : dependencies) {
+				asset_dependency_record(dep);
+			}
+		}
+	}
+
+	void asset_dependencies_prefetch(Deserializer& d, const char* name)
+	{
+		if (!deserialize_assert(d, sizeof(u32))) {
+			SV_LOG_ERROR("Invalid dependency table in '%s'", name);
+			return;
+		}
+		
+		u32 count;
+		deserialize_u32(d, count);
+
+		if (count == 0u) return;
+
+		// Each filepath uses at least two bytes, one char and the terminator
+		if (size_t(count) > (d.buff.size() - d.pos) / 2u) {
+			SV_LOG_ERROR("Invalid dependency count in '%s'", name);
+			return;
+		}
+
+		AssetPrefetch* prefetch = SV_ALLOCATE_STRUCT(AssetPrefetch, "AssetSystem");
+		string_copy(prefetch->name, name, FILEPATH_SIZE + 1u);
+		prefetch->begin_time = timer_now();
+
+		char filepath[FILEPATH_SIZE + 1u];
+		
+		foreach(i, count) {
+
+			deserialize_string(d, filepath, FILEPATH_SIZE + 1u);
+
+			AssetPtr asset_ptr;
+			if (load_asset_from_file(asset_ptr, filepath, AssetLoadingPriority_KeepItLoading)) {
+				prefetch->assets.push_back(asset_ptr);
+			}
+		}
+
+		SV_LOG_INFO("Prefetching %u assets for '%s'", u32(prefetch->assets.size()), name);
+		
+		asset_system->prefetchs.push_back(prefetch);
+	}
+
 }
@@ -5,6 +5,7 @@
 #include "core/particles.h"
 #include "core/event_system.h"
 #include "core/physics3D.h"
+#include "core/texture.h"
 
 #include "platform/os.h"
 #include "platform/audio.h"
@@ -22,6 +23,7 @@ namespace sv {
 
     static bool reset_game_request = false;
 	static char reset_game_scene_name[SCENE_NAME_SIZE + 1u] = "";
+	static const SceneSnapshot* reset_game_snapshot = NULL;
     static bool close_project_request = false;
 #endif
 
@@ -72,32 +74,133 @@ namespace sv {
 		return true;
     }
 
-    SV_INTERNAL bool load_image_asset(void* asset, const char* name, const char* filepath)
+    // Image pixels (RGBA8) or cooked texture
+    struct ImagePrepared {
+		void*         data;
+		Format        format;
+		u32           width;
+		u32           height;
+		u32           mip_levels;
+		u32           size;
+		Deserializer* cooked;
+    };
+
+    SV_AUX bool is_cooked_texture(const char* filepath)
     {
-		GPUImage*& image = *reinterpret_cast<GPUImage**>(asset);
+		const char* extension = filepath_extension(filepath);
+		return extension && string_equals(extension, ".tex");
+    }
+
+    SV_INTERNAL bool prepare_image(const char* filepath, ImagePrepared& image)
+    {
+		image = {};
+
+		if (is_cooked_texture(filepath)) {
+
+			Deserializer* d = SV_ALLOCATE_STRUCT(Deserializer, "Asset");
+			CookedTexture texture;
+
+			// The texture data is uploaded directly from the file mapping
+			f64 begin = timer_now();
+			bool res = deserialize_begin_mapped(*d, filepath, true);
+			asset_telemetry_read(timer_now() - begin, d->buff.size());
 
-		// Get file data
-		void* data;
-		u32 width;
-		u32 height;
-		if (!load_image(filepath, &data, &width, &height)) return false;
+			if (!res || !texture_cooked_read(*d, texture)) {
+				SV_LOG_ERROR("Can't read the cooked texture '%s'", filepath);
+				SV_FREE_STRUCT(d);
+				return false;
+			}
+
+			image.data = (void*)texture.data;
+			image.format = texture.format;
+			image.width = texture.width;
+			image.height = texture.height;
+			image.mip_levels = texture.mip_levels;
+			image.size = texture.size;
+			image.cooked = d;
+		}
+		else {
 
-		// Create Image
+			// The file is read before decoding to split the telemetry times
+			RawList file;
+
+			f64 begin = timer_now();
+			if (!file_read_binary(filepath, file)) return false;
+			asset_telemetry_read(timer_now() - begin, file.size());
+			
+			if (!load_image_from_memory(file.data(), file.size(), &image.data, &image.width, &image.height)) return false;
+
+			image.format = Format_R8G8B8A8_UNORM;
+			image.mip_levels = 1u;
+			image.size = image.width * image.height * 4u;
+		}
+
+		return true;
+    }
+
+    SV_INTERNAL void free_prepared_image(ImagePrepared& image)
+    {
+		if (image.cooked) {
+			deserialize_end(*image.cooked);
+			SV_FREE_STRUCT(image.cooked);
+		}
+		else SV_FREE_MEMORY(image.data);
+
+		image = {};
+    }
+
+    SV_INTERNAL bool create_prepared_image(GPUImage** image, const ImagePrepared& data)
+    {
 		GPUImageDesc desc;
 
-		desc.data = data;
-		desc.size = width * height * 4u;
-		desc.format = Format_R8G8B8A8_UNORM;
+		desc.data = data.data;
+		desc.size = data.size;
+		desc.format = data.format;
 		desc.layout = GPUImageLayout_ShaderResource;
 		desc.type = GPUImageType_ShaderResource;
 		desc.usage = ResourceUsage_Static;
 		desc.cpu_access = CPUAccess_None;
-		desc.width = width;
-		desc.height = height;
+		desc.width = data.width;
+		desc.height = data.height;
+		desc.mip_levels = data.mip_levels;
+		desc.async_upload = true;
+
+		return graphics_image_create(&desc, image);
+    }
 
-		bool res = graphics_image_create(&desc, &image);
+    SV_INTERNAL bool load_image_asset(void* asset, const char* name, const char* filepath)
+    {
+		GPUImage*& image = *reinterpret_cast<GPUImage**>(asset);
 
-		SV_FREE_MEMORY(data);
+		ImagePrepared data;
+		if (!prepare_image(filepath, data)) return false;
+
+		bool res = create_prepared_image(&image, data);
+
+		free_prepared_image(data);
+		return res;
+    }
+
+    SV_INTERNAL void* prepare_image_asset(const char* filepath)
+    {
+		ImagePrepared image;
+		if (!prepare_image(filepath, image)) return NULL;
+
+		ImagePrepared* prepared = SV_ALLOCATE_STRUCT(ImagePrepared, "Asset");
+		*prepared = image;
+		return prepared;
+    }
+
+    SV_INTERNAL bool load_prepared_image_asset(void* asset, const char* name, const char* filepath, void* prepared)
+    {
+		GPUImage*& image = *reinterpret_cast<GPUImage**>(asset);
+		ImagePrepared* data = reinterpret_cast<ImagePrepared*>(prepared);
+
+		image = nullptr;
+		bool res = create_prepared_image(&image, *data);
+
+		free_prepared_image(*data);
+		SV_FREE_STRUCT(data);
 		return res;
     }
 
@@ -115,6 +218,27 @@ namespace sv {
 		return load_image_asset(asset, name, filepath);
     }
 
+    SV_INTERNAL void image_asset_size(void* asset, size_t* cpu_size, size_t* gpu_size)
+    {
+		GPUImage* image = *reinterpret_cast<GPUImage**>(asset);
+		if (image == nullptr) return;
+
+		const GPUImageInfo& info = graphics_image_info(image);
+
+		u32 width = info.width;
+		u32 height = info.height;
+
+		foreach(i, SV_MAX(info.mip_levels, 1u)) {
+
+			*gpu_size += graphics_image_level_size(info.format, width, height);
+			width = SV_MAX(width / 2u, 1u);
+			height = SV_MAX(height / 2u, 1u);
+		}
+    }
+
+    // The editor needs the vertices in the cpu to pick the entities
+    constexpr bool MESH_CPU_DATA = SV_EDITOR;
+
     SV_INTERNAL bool create_mesh_asset(void* asset, const char* name)
     {
 		Mesh* mesh = new(asset) Mesh();
@@ -142,11 +266,74 @@ namespace sv {
 		}
 			
 		Mesh& mesh = *new(asset) Mesh();
+
+		MeshFile file;
+		
+		f64 begin = timer_now();
+		bool binary = mesh_file_open(file, filepath);
+		
+		if (binary) {
+
+			mesh_file_prefetch(file);
+			asset_telemetry_read(timer_now() - begin, file.mapping.size);
+			
+			bool res = mesh_create_from_file(mesh, file, filepath, MESH_CPU_DATA);
+			mesh_file_close(file);
+			return res;
+		}
+		
 		SV_CHECK(load_mesh(mesh, filepath));
 		SV_CHECK(mesh_create_buffers(mesh));
 		return true;
     }
 
+    // The binary meshes are mapped in the worker thread and copied to the GPU in the main thread, the legacy ones are loaded in the worker thread
+    struct MeshPrepared {
+		Mesh     mesh;
+		MeshFile file;
+		bool     binary;
+    };
+
+    SV_INTERNAL void* prepare_mesh_asset(const char* filepath)
+    {
+		MeshPrepared* prepared = SV_ALLOCATE_STRUCT(MeshPrepared, "Asset");
+
+		f64 begin = timer_now();
+		prepared->binary = mesh_file_open(prepared->file, filepath);
+
+		if (prepared->binary) {
+			mesh_file_prefetch(prepared->file);
+			asset_telemetry_read(timer_now() - begin, prepared->file.mapping.size);
+		}
+		else if (!load_mesh(prepared->mesh, filepath)) {
+			SV_FREE_STRUCT(prepared);
+			return NULL;
+		}
+		
+		return prepared;
+    }
+
+    SV_INTERNAL bool load_prepared_mesh_asset(void* asset, const char* name, const char* filepath, void* prepared)
+    {
+		MeshPrepared* data = reinterpret_cast<MeshPrepared*>(prepared);
+		bool res;
+
+		if (data->binary) {
+
+			Mesh& mesh = *new(asset) Mesh();
+			res = mesh_create_from_file(mesh, data->file, filepath, MESH_CPU_DATA);
+			mesh_file_close(data->file);
+		}
+		else {
+			
+			Mesh& mesh = *new(asset) Mesh(std::move(data->mesh));
+			res = mesh_create_buffers(mesh);
+		}
+		
+		SV_FREE_STRUCT(data);
+		return res;
+    }
+
     SV_INTERNAL bool free_mesh_asset(void* asset, const char* name)
     {
 		Mesh& mesh = *reinterpret_cast<Mesh*>(asset);
@@ -167,6 +354,67 @@ namespace sv {
 		return true;
     }
 
+    // The file is read and parsed in the worker thread
+    SV_INTERNAL void* prepare_material_asset(const char* filepath)
+    {
+		Deserializer d;
+
+		f64 begin = timer_now();
+		
+		if (!deserialize_begin(d, filepath))
+			return NULL;
+
+		asset_telemetry_read(timer_now() - begin, d.buff.size());
+
+		MaterialFile* file = SV_ALLOCATE_STRUCT(MaterialFile, "Asset");
+
+		bool res = read_material(*file, d);
+		deserialize_end(d);
+
+		if (!res) {
+			SV_FREE_STRUCT(file);
+			return NULL;
+		}
+		
+		return file;
+    }
+
+    // The textures are requested with the same priority, they are decoded in worker threads and the material is ready before them
+    SV_INTERNAL bool load_prepared_material_asset(void* asset, const char* name, const char* filepath, void* prepared)
+    {
+		MaterialFile* file = reinterpret_cast<MaterialFile*>(prepared);
+		
+		Material& material = *new(asset) Material(file->material);
+		load_material_textures(material, *file, AssetLoadingPriority_KeepItLoading);
+		
+		SV_FREE_STRUCT(file);
+		return true;
+    }
+
+    SV_INTERNAL void mesh_asset_size(void* asset, size_t* cpu_size, size_t* gpu_size)
+    {
+		Mesh& mesh = *reinterpret_cast<Mesh*>(asset);
+
+		*cpu_size += mesh.positions.size() * sizeof(v3_f32);
+		*cpu_size += mesh.normals.size() * sizeof(v3_f32);
+		*cpu_size += mesh.tangents.size() * sizeof(v4_f32);
+		*cpu_size += mesh.texcoords.size() * sizeof(v2_f32);
+		*cpu_size += (mesh.indices.size() + mesh.lod_indices.size()) * sizeof(MeshIndex);
+
+		if (mesh.vbuffer) *gpu_size += graphics_buffer_info(mesh.vbuffer).size;
+		if (mesh.ibuffer) *gpu_size += graphics_buffer_info(mesh.ibuffer).size;
+    }
+
+    SV_INTERNAL void material_asset_dependencies(void* asset, List<AssetPtr>& dependencies)
+    {
+		Material& mat = *reinterpret_cast<Material*>(asset);
+
+		if (mat.diffuse_map.asset_ptr.ptr) dependencies.push_back(mat.diffuse_map.asset_ptr);
+		if (mat.normal_map.asset_ptr.ptr) dependencies.push_back(mat.normal_map.asset_ptr);
+		if (mat.specular_map.asset_ptr.ptr) dependencies.push_back(mat.specular_map.asset_ptr);
+		if (mat.emissive_map.asset_ptr.ptr) dependencies.push_back(mat.emissive_map.asset_ptr);
+    }
+
     SV_INTERNAL bool free_material_asset(void* asset, const char* name)
     {
 		Material& mat = *reinterpret_cast<Material*>(asset);
@@ -179,7 +427,7 @@ namespace sv {
 		// Register assets
 	
 		AssetTypeDesc desc;
-		const char* extensions[5u];
+		const char* extensions[6u];
 		desc.extensions = extensions;
 
 
@@ -189,14 +437,18 @@ namespace sv {
 		extensions[2] = "jpg";
 		extensions[3] = "jpeg";
 		extensions[4] = "JPG";
+		extensions[5] = "tex";
 
 		desc.name = "Texture";
 		desc.asset_size = sizeof(GPUImage*);
-		desc.extension_count = 5u;
+		desc.extension_count = 6u;
 		desc.create_fn = create_image_asset;
 		desc.load_file_fn = load_image_asset;
 		desc.free_fn = destroy_image_asset;
 		desc.reload_file_fn = reload_image_asset;
+		desc.prepare_file_fn = prepare_image_asset;
+		desc.load_prepared_fn = load_prepared_image_asset;
+		desc.size_fn = image_asset_size;
 		desc.unused_time = 3.f;
 
 		SV_CHECK(register_asset_type(&desc));
@@ -211,6 +463,9 @@ namespace sv {
 		desc.load_file_fn = load_mesh_asset;
 		desc.free_fn = free_mesh_asset;
 		desc.reload_file_fn = nullptr;
+		desc.prepare_file_fn = prepare_mesh_asset;
+		desc.load_prepared_fn = load_prepared_mesh_asset;
+		desc.size_fn = mesh_asset_size;
 		desc.unused_time = 5.f;
 
 		SV_CHECK(register_asset_type(&desc));
@@ -225,6 +480,10 @@ namespace sv {
 		desc.load_file_fn = load_material_asset;
 		desc.free_fn = free_material_asset;
 		desc.reload_file_fn = nullptr;
+		desc.prepare_file_fn = prepare_material_asset;
+		desc.load_prepared_fn = load_prepared_material_asset;
+		desc.dependencies_fn = material_asset_dependencies;
+		desc.size_fn = nullptr;
 		desc.unused_time = 2.5f;
 
 		SV_CHECK(register_asset_type(&desc));
@@ -259,7 +518,18 @@ namespace sv {
 		
 		_terrain_register_events();
 		_particle_initialize();
-		// TODO task_initialize();
+
+		if (!_task_initialize()) {
+			SV_LOG_ERROR("Can't initialize the task system");
+			return false;
+		}
+
+#if !SV_EDITOR
+		// The packed assets are resolved before the loose files
+		if (file_exists("assets.pack")) {
+			pack_mount("assets.pack");
+		}
+#endif
 
 		// Initialize Graphics API
 		if (_graphics_initialize()) {
@@ -312,7 +582,19 @@ namespace sv {
 		event_dispatch("initialize_game", nullptr);
 
 #if SV_EDITOR
-		if (reset_game_scene_name[0]) {
+		if (reset_game_snapshot) {
+
+			// The ECS is restored from memory, the scene file is loaded only if the components changed
+			set_scene("");
+
+			if (!scene_snapshot_restore(reset_game_snapshot)) {
+				SV_LOG_WARNING("Can't restore the scene snapshot, the scene '%s' is loaded from file", reset_game_scene_name);
+				set_scene(reset_game_scene_name);
+			}
+
+			reset_game_snapshot = NULL;
+		}
+		else if (reset_game_scene_name[0]) {
 			set_scene(reset_game_scene_name);
 		}
 #endif
@@ -324,6 +606,9 @@ namespace sv {
     {
 		SV_LOG_INFO("Closing SilverEngine");
 
+		// The assets that are loading can create graphics resources
+		_wait_assets();
+
 		_particle_close();
 
 		_physics3D_close();
@@ -338,7 +623,8 @@ namespace sv {
 		_audio_close();
 		if (!_os_shutdown()) { SV_LOG_ERROR("Can't shutdown OS layer properly"); }
 		_close_assets();
-		// if (result_fail(task_close())) { SV_LOG_ERROR("Can't close the task system"); }
+		_task_close();
+		pack_unmount_all();
 
 		_event_close();
 
@@ -425,6 +711,7 @@ namespace sv {
 
 				close_project_request = false;
 				reset_game_request = false;
+				reset_game_snapshot = NULL;
 
 				close_project();
 			}
@@ -488,9 +775,10 @@ namespace sv {
 		close_project_request = true;
     }
     
-    void _engine_reset_game(const char* scene)
+    void _engine_reset_game(const char* scene, const SceneSnapshot* snapshot)
     {
 		reset_game_request = true;
+		reset_game_snapshot = snapshot;
 		string_copy(reset_game_scene_name, string_validate(scene), SCENE_NAME_SIZE + 1); 
     }
     
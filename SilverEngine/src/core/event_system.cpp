@@ -28,6 +28,7 @@ namespace sv {
 
 #if SV_EDITOR
 		Date last_write;
+		bool reload_pending;
 #endif
 		
 	};
@@ -35,12 +36,13 @@ namespace sv {
     struct EventSystemState {
 		
 		Mutex global_mutex;
-		ThickHashTable<EventType, 3000u> table;
+		HashMap<const char*, EventType*> table;
 
 		List<PluginRegister> plugins;
 
 #if SV_EDITOR
-		f32 update_plugins_time;
+		FileWatcher* watcher;
+		char         watcher_path[FILEPATH_SIZE + 1u];
 #endif
 		
     };
@@ -52,7 +54,11 @@ namespace sv {
 		event_system = SV_ALLOCATE_STRUCT(EventSystemState, "EventSystem");
 		
 		SV_CHECK(mutex_create(event_system->global_mutex));
-		event_system->update_plugins_time = 0.f;
+
+#if SV_EDITOR
+		event_system->watcher = file_watcher_create("");
+		string_copy(event_system->watcher_path, engine.project_path, FILEPATH_SIZE + 1u);
+#endif
 	    
 		return true;
     }
@@ -63,9 +69,15 @@ namespace sv {
 
 			mutex_destroy(event_system->global_mutex);
 
-			for (EventType& t : event_system->table) {
-				mutex_destroy(t.mutex);
+#if SV_EDITOR
+			file_watcher_destroy(event_system->watcher);
+#endif
+
+			for (EventType* t : event_system->table) {
+				mutex_destroy(t->mutex);
+				SV_FREE_STRUCT(t);
 			}
+			event_system->table.free();
 
 			SV_FREE_STRUCT(event_system);
 			event_system = nullptr;
@@ -102,11 +114,11 @@ namespace sv {
 	{
 		mutex_lock(event_system->global_mutex);
 
-		for (EventType& type : event_system->table) {
+		for (EventType* type : event_system->table) {
 
-			mutex_lock(type.mutex);
-			update_plugin_functions_type(type, reg, old_lib);
-			mutex_unlock(type.mutex);
+			mutex_lock(type->mutex);
+			update_plugin_functions_type(*type, reg, old_lib);
+			mutex_unlock(type->mutex);
 		}
 		
 		mutex_unlock(event_system->global_mutex);
@@ -116,46 +128,73 @@ namespace sv {
 	{
 		
 #if SV_EDITOR
-		event_system->update_plugins_time += engine.deltatime;
+		// The plugin filepaths are relative to the project
+		if (!string_equals(event_system->watcher_path, engine.project_path)) {
 
-		if (event_system->update_plugins_time > 1.f) {
-			event_system->update_plugins_time -= 1.f;
+			file_watcher_destroy(event_system->watcher);
+			event_system->watcher = file_watcher_create("");
+			string_copy(event_system->watcher_path, engine.project_path, FILEPATH_SIZE + 1u);
+		}
 
-			for (PluginRegister& reg : event_system->plugins) {
+		if (event_system->watcher) {
 
-				Date last_write;
-				if (file_date(reg.filepath, NULL, &last_write, NULL)) {
+			char filepath[FILEPATH_SIZE + 1u];
 
-					if (last_write != reg.last_write) {
+			while (file_watcher_pop(event_system->watcher, filepath)) {
 
-						char filepath[FILEPATH_SIZE + 1u] = "$system/bin/";
-						string_append(filepath, filepath_name(reg.filepath), FILEPATH_SIZE + 1u);
-					
-						if (reg.library) {
-							library_free(reg.library);
-						}
+				for (PluginRegister& reg : event_system->plugins) {
 
-						if (file_copy(reg.filepath, filepath)) {
+					if (string_equals(reg.filepath, filepath))
+						reg.reload_pending = true;
+				}
+			}
+		}
+
+		// The library can be locked while is compiled, in that case is tried again in the next frame
+		for (PluginRegister& reg : event_system->plugins) {
 
-							Library last_library = reg.library;
-							reg.library = library_load(filepath);
+			if (!reg.reload_pending) continue;
 
-							if (reg.library == NULL) {
-								SV_LOG_ERROR("Can't load the dynamic library '%s'", reg.filepath);
-							}
-						
-							reg.last_write = last_write;
-							update_plugin_functions(&reg, last_library);
+			Date last_write;
+			if (!file_date(reg.filepath, NULL, &last_write, NULL)) continue;
 
-							ReloadPluginEvent e;
-							string_copy(e.name, reg.name, PLUGIN_NAME_SIZE + 1u);
-							e.library = reg.library;
+			if (last_write != reg.last_write) {
+
+				char filepath[FILEPATH_SIZE + 1u] = "$system/bin/";
+				string_append(filepath, filepath_name(reg.filepath), FILEPATH_SIZE + 1u);
+
+				Library last_library = reg.library;
+				
+				if (reg.library) {
+					library_free(reg.library);
+					reg.library = 0u;
+				}
 
-							event_dispatch("reload_plugin", &e);
-						}
+				if (file_copy(reg.filepath, filepath)) {
+
+					reg.library = library_load(filepath);
+
+					if (reg.library == NULL) {
+						SV_LOG_ERROR("Can't load the dynamic library '%s'", reg.filepath);
 					}
+						
+					reg.last_write = last_write;
+					reg.reload_pending = false;
+					update_plugin_functions(&reg, last_library);
+
+					ReloadPluginEvent e;
+					string_copy(e.name, reg.name, PLUGIN_NAME_SIZE + 1u);
+					e.library = reg.library;
+
+					event_dispatch("reload_plugin", &e);
+				}
+				else if (last_library) {
+
+					// Remove the functions of the freed library
+					update_plugin_functions(&reg, last_library);
 				}
 			}
+			else reg.reload_pending = false;
 		}
 #endif
 		
@@ -223,11 +262,11 @@ namespace sv {
 			Library old_lib = reg.library;
 			library_free(reg.library);
 
-			for (EventType& type : event_system->table) {
+			for (EventType* type : event_system->table) {
 
-				mutex_lock(type.mutex);
-				update_plugin_functions_type(type, NULL, old_lib);
-				mutex_unlock(type.mutex);
+				mutex_lock(type->mutex);
+				update_plugin_functions_type(*type, NULL, old_lib);
+				mutex_unlock(type->mutex);
 			}
 		}
 
@@ -274,26 +313,39 @@ namespace sv {
 	
 		SV_LOCK_GUARD(event_system->global_mutex, lock);
 
-		EventType* type = event_system->table.find(event_name);
+		EventType** type = event_system->table.find(event_name);
 	
 		if (type == nullptr) {
 
 			if (log_not_found)
 				SV_LOG_ERROR("Event '%s' not found", event_name);
+			
+			return nullptr;
 		}
 	
-		return type;
+		return *type;
     }
 
     void event_unregister_all(const char* event_name)
     {
-		SV_LOCK_GUARD(event_system->global_mutex, lock);
-		event_system->table.erase(event_name);
+		// The type is kept until _event_close, a dispatch in other thread can be using it
+		EventType* type = find_type(event_name, false);
+
+		if (type) {
+			SV_LOCK_GUARD(type->mutex, lock);
+			type->registers.clear();
+		}
     }
 
 	SV_AUX EventType& find_and_create_type(const char* event_name)
 	{
-		EventType& type = event_system->table[event_name];
+		// The types are allocated separately and never freed before _event_close, the pointers remain valid when the table grows
+		EventType*& type_ptr = event_system->table[event_name];
+
+		if (type_ptr == nullptr)
+			type_ptr = SV_ALLOCATE_STRUCT(EventType, "EventSystem");
+
+		EventType& type = *type_ptr;
 
 		if (!mutex_valid(type.mutex)) {
 			mutex_create(type.mutex);
@@ -529,7 +529,7 @@ namespace sv {
 					data.color = color_to_vec4(color);
 
 					graphics_buffer_update(state.gfx.cbuffer_mesh, GPUBufferState_Constant, &data, sizeof(data), 0u, cmd);
-					graphics_draw_indexed((u32)mesh->indices.size(), 1u, 0u, 0u, 0u, cmd);
+					graphics_draw_indexed(mesh->index_count, 1u, mesh->index_offset, 0u, 0u, cmd);
 				}
 				break;
 		
@@ -694,7 +694,7 @@ namespace sv {
 
     void imrend_draw_mesh_wireframe(Mesh* mesh, Color color, CommandList cmd)
     {
-		if (mesh == NULL || mesh->vbuffer == NULL || mesh->ibuffer == NULL)
+		if (mesh == NULL || !mesh_is_resident(*mesh))
 			return;
 		
 		SV_IMREND();
@@ -47,7 +47,7 @@ namespace sv {
 		ind[indexOffset + 5u] = v0_32 + 2u;
     }
 
-    SV_AUX void construct_vertex_data(Mesh& mesh, List<MeshVertex>& vertices)
+    SV_AUX void construct_vertex_data(const Mesh& mesh, List<MeshVertex>& vertices)
     {
 		vertices.resize(mesh.positions.size());
 
@@ -416,6 +416,592 @@ namespace sv {
 		SV_LOG_ERROR("TODO");
     }
 
+	void mesh_calculate_bounds(Mesh& mesh)
+	{
+		if (mesh.positions.empty()) {
+			mesh.bounds_center = {};
+			mesh.bounds_radius = 0.f;
+			return;
+		}
+
+		v3_f32 min = mesh.positions.front();
+		v3_f32 max = min;
+
+		for (const v3_f32& pos : mesh.positions) {
+
+			min.x = SV_MIN(min.x, pos.x);
+			min.y = SV_MIN(min.y, pos.y);
+			min.z = SV_MIN(min.z, pos.z);
+			max.x = SV_MAX(max.x, pos.x);
+			max.y = SV_MAX(max.y, pos.y);
+			max.z = SV_MAX(max.z, pos.z);
+		}
+
+		mesh.bounds_center = min + (max - min) * 0.5f;
+
+		f32 radius = 0.f;
+
+		for (const v3_f32& pos : mesh.positions) {
+
+			f32 distance = vec3_distance(mesh.bounds_center, pos);
+			radius = SV_MAX(radius, distance);
+		}
+
+		mesh.bounds_radius = radius;
+	}
+
+	// LOD GENERATION
+
+	// Triangles per screen height squared. Used to compute the screen size of each level
+	constexpr f32 LOD_TRIANGLE_DENSITY = 16000.f;
+	constexpr f64 LOD_BORDER_WEIGHT = 10.0;
+	constexpr u32 LOD_MIN_TRIANGLES = 32u;
+
+	struct LodQuadric {
+		f64 a2, ab, ac, ad;
+		f64 b2, bc, bd;
+		f64 c2, cd;
+		f64 d2;
+	};
+
+	struct LodEdge {
+		u64 key;
+		u32 triangle;
+	};
+
+	struct LodCollapse {
+		u32 from;
+		u32 to;
+		f64 error;
+	};
+
+	SV_AUX void lod_quadric_add_plane(LodQuadric& q, v3_f32 normal, f32 distance, f64 weight)
+	{
+		f64 a = normal.x;
+		f64 b = normal.y;
+		f64 c = normal.z;
+		f64 d = distance;
+
+		q.a2 += a * a * weight; q.ab += a * b * weight; q.ac += a * c * weight; q.ad += a * d * weight;
+		q.b2 += b * b * weight; q.bc += b * c * weight; q.bd += b * d * weight;
+		q.c2 += c * c * weight; q.cd += c * d * weight;
+		q.d2 += d * d * weight;
+	}
+
+	SV_AUX void lod_quadric_add(LodQuadric& q, const LodQuadric& o)
+	{
+		q.a2 += o.a2; q.ab += o.ab; q.ac += o.ac; q.ad += o.ad;
+		q.b2 += o.b2; q.bc += o.bc; q.bd += o.bd;
+		q.c2 += o.c2; q.cd += o.cd;
+		q.d2 += o.d2;
+	}
+
+	SV_AUX f64 lod_quadric_error(const LodQuadric& q0, const LodQuadric& q1, v3_f32 p)
+	{
+		LodQuadric q = q0;
+		lod_quadric_add(q, q1);
+		
+		f64 x = p.x;
+		f64 y = p.y;
+		f64 z = p.z;
+
+		f64 error = q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x
+			+ q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y
+			+ q.c2 * z * z + 2.0 * q.cd * z
+			+ q.d2;
+
+		return (error < 0.0) ? -error : error;
+	}
+
+	SV_AUX v3_f32 lod_triangle_normal(v3_f32 p0, v3_f32 p1, v3_f32 p2)
+	{
+		return vec3_cross(p1 - p0, p2 - p0);
+	}
+
+	struct LodContext {
+
+		const v3_f32* positions;
+		u32 vertex_count;
+
+		// The vertices with the same position are welded in groups. The group id is the first vertex of the group
+		List<u32> group;
+		List<u32> group_next;
+		List<LodQuadric> quadrics;
+
+		List<u32> adjacency_offset;
+		List<u32> adjacency;
+		List<bool> locked;
+	};
+
+	SV_AUX void lod_weld_vertices(LodContext& ctx)
+	{
+		u32 vertex_count = ctx.vertex_count;
+		const v3_f32* positions = ctx.positions;
+		
+		List<u32> sorted;
+		sorted.resize(vertex_count);
+		foreach(i, vertex_count) sorted[i] = i;
+
+		std::sort(sorted.data(), sorted.data() + vertex_count, [positions](u32 i0, u32 i1) {
+			v3_f32 p0 = positions[i0];
+			v3_f32 p1 = positions[i1];
+			if (p0.x != p1.x) return p0.x < p1.x;
+			if (p0.y != p1.y) return p0.y < p1.y;
+			if (p0.z != p1.z) return p0.z < p1.z;
+			return i0 < i1;
+		});
+
+		ctx.group.resize(vertex_count);
+		ctx.group_next.resize(vertex_count);
+
+		u32 begin = 0u;
+
+		while (begin < vertex_count) {
+
+			v3_f32 p = positions[sorted[begin]];
+			u32 end = begin + 1u;
+
+			while (end < vertex_count) {
+
+				v3_f32 p1 = positions[sorted[end]];
+				if (p.x != p1.x || p.y != p1.y || p.z != p1.z) break;
+				++end;
+			}
+
+			u32 id = sorted[begin];
+
+			for (u32 i = begin; i < end; ++i) {
+
+				u32 v = sorted[i];
+				ctx.group[v] = id;
+				ctx.group_next[v] = (i + 1u == end) ? id : sorted[i + 1u];
+			}
+
+			begin = end;
+		}
+	}
+
+	SV_AUX void lod_compute_quadrics(LodContext& ctx, const MeshIndex* indices, u32 index_count)
+	{
+		const v3_f32* positions = ctx.positions;
+		u32 triangle_count = index_count / 3u;
+		
+		ctx.quadrics.resize(ctx.vertex_count, {});
+
+		// Triangle planes, weighted by area
+		foreach(t, triangle_count) {
+
+			const MeshIndex* tri = indices + t * 3u;
+
+			v3_f32 p0 = positions[tri[0]];
+			v3_f32 normal = lod_triangle_normal(p0, positions[tri[1]], positions[tri[2]]);
+			f32 length = vec3_length(normal);
+
+			if (length <= 0.f) continue;
+
+			normal /= length;
+			f32 distance = -vec3_dot(normal, p0);
+
+			foreach(j, 3u) {
+				lod_quadric_add_plane(ctx.quadrics[ctx.group[tri[j]]], normal, distance, f64(length) * 0.5);
+			}
+		}
+
+		// The edges used by only one triangle are borders or attribute seams. A perpendicular plane keeps them in place
+		List<LodEdge> edges;
+		edges.resize(triangle_count * 3u);
+
+		foreach(t, triangle_count) {
+
+			foreach(j, 3u) {
+
+				u64 i0 = indices[t * 3u + j];
+				u64 i1 = indices[t * 3u + (j + 1u) % 3u];
+
+				LodEdge& edge = edges[t * 3u + j];
+				edge.key = (i0 < i1) ? ((i0 << 32u) | i1) : ((i1 << 32u) | i0);
+				edge.triangle = t;
+			}
+		}
+
+		std::sort(edges.data(), edges.data() + edges.size(), [](const LodEdge& e0, const LodEdge& e1) {
+			return e0.key < e1.key;
+		});
+
+		size_t i = 0u;
+
+		while (i < edges.size()) {
+
+			size_t end = i + 1u;
+			while (end < edges.size() && edges[end].key == edges[i].key) ++end;
+
+			if (end - i == 1u) {
+
+				const MeshIndex* tri = indices + edges[i].triangle * 3u;
+				u32 i0 = u32(edges[i].key >> 32u);
+				u32 i1 = u32(edges[i].key & 0xFFFFFFFF);
+				
+				v3_f32 p0 = positions[i0];
+				v3_f32 edge = positions[i1] - p0;
+				v3_f32 normal = vec3_normalize(lod_triangle_normal(positions[tri[0]], positions[tri[1]], positions[tri[2]]));
+				v3_f32 perpendicular = vec3_cross(edge, normal);
+				f32 length = vec3_length(perpendicular);
+
+				if (length > 0.f) {
+
+					perpendicular /= length;
+					f32 distance = -vec3_dot(perpendicular, p0);
+					f64 weight = f64(vec3_dot(edge, edge)) * LOD_BORDER_WEIGHT;
+
+					lod_quadric_add_plane(ctx.quadrics[ctx.group[i0]], perpendicular, distance, weight);
+					lod_quadric_add_plane(ctx.quadrics[ctx.group[i1]], perpendicular, distance, weight);
+				}
+			}
+
+			i = end;
+		}
+	}
+
+	SV_AUX void lod_compute_adjacency(LodContext& ctx, const List<MeshIndex>& indices)
+	{
+		u32 triangle_count = u32(indices.size() / 3u);
+		
+		ctx.adjacency_offset.resize(ctx.vertex_count + 1u);
+		ctx.adjacency_offset.set_all(0u);
+
+		for (MeshIndex index : indices) {
+			ctx.adjacency_offset[ctx.group[index] + 1u]++;
+		}
+
+		foreach(i, ctx.vertex_count) {
+			ctx.adjacency_offset[i + 1u] += ctx.adjacency_offset[i];
+		}
+
+		ctx.adjacency.resize(indices.size());
+
+		List<u32> count;
+		count.resize(ctx.vertex_count, 0u);
+
+		foreach(t, triangle_count) {
+
+			foreach(j, 3u) {
+
+				u32 g = ctx.group[indices[t * 3u + j]];
+				ctx.adjacency[ctx.adjacency_offset[g] + count[g]++] = t;
+			}
+		}
+	}
+
+	// Checks if moving the group 'from' to the position of 'to' flips some triangle
+	SV_AUX bool lod_collapse_flips(const LodContext& ctx, const List<MeshIndex>& indices, u32 from, u32 to)
+	{
+		const v3_f32* positions = ctx.positions;
+		v3_f32 dst = positions[to];
+		
+		for (u32 i = ctx.adjacency_offset[from]; i < ctx.adjacency_offset[from + 1u]; ++i) {
+
+			const MeshIndex* tri = indices.data() + ctx.adjacency[i] * 3u;
+
+			u32 g0 = ctx.group[tri[0]];
+			u32 g1 = ctx.group[tri[1]];
+			u32 g2 = ctx.group[tri[2]];
+
+			// This triangle is removed
+			if (g0 == to || g1 == to || g2 == to) continue;
+
+			v3_f32 p0 = positions[tri[0]];
+			v3_f32 p1 = positions[tri[1]];
+			v3_f32 p2 = positions[tri[2]];
+
+			v3_f32 n0 = lod_triangle_normal(p0, p1, p2);
+
+			if (g0 == from) p0 = dst;
+			else if (g1 == from) p1 = dst;
+			else p2 = dst;
+
+			v3_f32 n1 = lod_triangle_normal(p0, p1, p2);
+
+			if (vec3_dot(n0, n1) <= 0.f) return true;
+		}
+
+		return false;
+	}
+
+	// Finds the vertex of the group 'to' that replaces the vertex 'v'. Uses a vertex connected by an edge to keep the attributes continuous
+	SV_AUX u32 lod_collapse_target(const LodContext& ctx, const List<MeshIndex>& indices, u32 v, u32 from, u32 to)
+	{
+		u32 fallback = to;
+		
+		for (u32 i = ctx.adjacency_offset[from]; i < ctx.adjacency_offset[from + 1u]; ++i) {
+
+			const MeshIndex* tri = indices.data() + ctx.adjacency[i] * 3u;
+
+			bool contains = tri[0] == v || tri[1] == v || tri[2] == v;
+
+			foreach(j, 3u) {
+
+				if (ctx.group[tri[j]] == to) {
+
+					if (contains) return tri[j];
+					fallback = tri[j];
+				}
+			}
+		}
+
+		return fallback;
+	}
+
+	// Collapses edges until the triangle count is less or equal than target_count. Returns false if the mesh can't be simplified
+	SV_AUX bool lod_simplify(LodContext& ctx, List<MeshIndex>& indices, u32 target_count)
+	{
+		const v3_f32* positions = ctx.positions;
+		
+		List<u64> edges;
+		List<LodCollapse> collapses;
+		List<u32> remap;
+		List<MeshIndex> new_indices;
+		
+		remap.resize(ctx.vertex_count);
+		ctx.locked.resize(ctx.vertex_count);
+
+		u32 triangle_count = u32(indices.size() / 3u);
+		u32 initial_count = triangle_count;
+
+		while (triangle_count > target_count) {
+
+			lod_compute_adjacency(ctx, indices);
+
+			// Candidate edges
+			edges.reset();
+
+			foreach(t, triangle_count) {
+
+				foreach(j, 3u) {
+
+					u64 g0 = ctx.group[indices[t * 3u + j]];
+					u64 g1 = ctx.group[indices[t * 3u + (j + 1u) % 3u]];
+
+					edges.push_back((g0 < g1) ? ((g0 << 32u) | g1) : ((g1 << 32u) | g0));
+				}
+			}
+
+			std::sort(edges.data(), edges.data() + edges.size());
+
+			collapses.reset();
+			
+			foreach(i, edges.size()) {
+
+				if (i && edges[i] == edges[i - 1u]) continue;
+
+				u32 g0 = u32(edges[i] >> 32u);
+				u32 g1 = u32(edges[i] & 0xFFFFFFFF);
+
+				f64 e0 = lod_quadric_error(ctx.quadrics[g0], ctx.quadrics[g1], positions[g1]);
+				f64 e1 = lod_quadric_error(ctx.quadrics[g0], ctx.quadrics[g1], positions[g0]);
+
+				LodCollapse& c = collapses.emplace_back();
+				c.from = (e0 <= e1) ? g0 : g1;
+				c.to = (e0 <= e1) ? g1 : g0;
+				c.error = SV_MIN(e0, e1);
+			}
+
+			std::sort(collapses.data(), collapses.data() + collapses.size(), [](const LodCollapse& c0, const LodCollapse& c1) {
+				return c0.error < c1.error;
+			});
+
+			// Each collapse removes about two triangles
+			u32 max_collapses = (triangle_count - target_count) / 2u + 1u;
+			u32 collapse_count = 0u;
+
+			ctx.locked.set_all(false);
+			foreach(i, ctx.vertex_count) remap[i] = i;
+
+			for (const LodCollapse& c : collapses) {
+
+				if (ctx.locked[c.from] || ctx.locked[c.to]) continue;
+				if (lod_collapse_flips(ctx, indices, c.from, c.to)) continue;
+
+				u32 v = c.from;
+				do {
+					remap[v] = lod_collapse_target(ctx, indices, v, c.from, c.to);
+					v = ctx.group_next[v];
+				}
+				while (v != c.from);
+
+				lod_quadric_add(ctx.quadrics[c.to], ctx.quadrics[c.from]);
+
+				// The triangles around the collapse are modified, the neighbours can't be collapsed in this pass
+				for (u32 i = ctx.adjacency_offset[c.from]; i < ctx.adjacency_offset[c.from + 1u]; ++i) {
+
+					const MeshIndex* tri = indices.data() + ctx.adjacency[i] * 3u;
+					ctx.locked[ctx.group[tri[0]]] = true;
+					ctx.locked[ctx.group[tri[1]]] = true;
+					ctx.locked[ctx.group[tri[2]]] = true;
+				}
+
+				if (++collapse_count >= max_collapses) break;
+			}
+
+			if (collapse_count == 0u) break;
+
+			// Remove the degenerated triangles
+			new_indices.reset();
+
+			foreach(t, triangle_count) {
+
+				u32 i0 = remap[indices[t * 3u + 0u]];
+				u32 i1 = remap[indices[t * 3u + 1u]];
+				u32 i2 = remap[indices[t * 3u + 2u]];
+
+				u32 g0 = ctx.group[i0];
+				u32 g1 = ctx.group[i1];
+				u32 g2 = ctx.group[i2];
+
+				if (g0 == g1 || g1 == g2 || g0 == g2) continue;
+
+				new_indices.push_back(i0);
+				new_indices.push_back(i1);
+				new_indices.push_back(i2);
+			}
+
+			std::swap(indices, new_indices);
+			triangle_count = u32(indices.size() / 3u);
+		}
+
+		return triangle_count < initial_count;
+	}
+
+	void mesh_generate_lods(Mesh& mesh, u32 lod_count)
+	{
+		mesh.lod_indices.clear();
+		mesh.lod_count = 0u;
+		
+		lod_count = SV_MIN(lod_count, MESH_LOD_MAX);
+		
+		u32 vertex_count = u32(mesh.positions.size());
+		u32 triangle_count = u32(mesh.indices.size() / 3u);
+
+		if (lod_count <= 1u || triangle_count < LOD_MIN_TRIANGLES * 2u)
+			return;
+
+		LodContext ctx;
+		ctx.positions = mesh.positions.data();
+		ctx.vertex_count = vertex_count;
+
+		lod_weld_vertices(ctx);
+		lod_compute_quadrics(ctx, mesh.indices.data(), u32(mesh.indices.size()));
+
+		List<MeshIndex> levels[MESH_LOD_MAX];
+		levels[0] = mesh.indices;
+		
+		List<MeshIndex> indices = mesh.indices;
+		u32 count = 1u;
+
+		while (count < lod_count) {
+
+			u32 last_count = u32(levels[count - 1u].size() / 3u);
+			u32 target_count = last_count / 2u;
+
+			if (target_count < LOD_MIN_TRIANGLES)
+				break;
+
+			if (!lod_simplify(ctx, indices, target_count))
+				break;
+
+			u32 new_count = u32(indices.size() / 3u);
+
+			// Not worth it
+			if (new_count * 5u > last_count * 4u)
+				break;
+			
+			levels[count++] = indices;
+		}
+
+		if (count <= 1u)
+			return;
+
+		// Sort the vertices coarse first
+
+		List<u32> remap;
+		remap.resize(vertex_count, u32_max);
+
+		u32 next = 0u;
+
+		for (i32 l = i32(count) - 1; l >= 0; --l) {
+
+			for (MeshIndex index : levels[l]) {
+
+				if (remap[index] == u32_max)
+					remap[index] = next++;
+			}
+
+			mesh.lods[l].vertex_count = next;
+		}
+
+		foreach(i, vertex_count) {
+
+			if (remap[i] == u32_max)
+				remap[i] = next++;
+		}
+
+		auto remap_vertices = [&remap, vertex_count](auto& list) {
+
+			if (list.size() != vertex_count) return;
+
+			auto copy = list;
+			foreach(i, vertex_count) list[remap[i]] = copy[i];
+		};
+
+		remap_vertices(mesh.positions);
+		remap_vertices(mesh.normals);
+		remap_vertices(mesh.tangents);
+		remap_vertices(mesh.texcoords);
+
+		// Write the levels
+		
+		for (i32 l = i32(count) - 1; l >= 0; --l) {
+
+			List<MeshIndex>& dst = (l == 0) ? mesh.indices : mesh.lod_indices;
+			MeshLod& lod = mesh.lods[l];
+
+			lod.index_offset = u32(mesh.lod_indices.size());
+			lod.index_count = u32(levels[l].size());
+
+			if (l == 0) dst.reset();
+
+			for (MeshIndex index : levels[l])
+				dst.push_back(remap[index]);
+
+			// The next level is used when this one has too many triangles for the size in the screen
+			if (l == i32(count) - 1) lod.screen_size = 0.f;
+			else lod.screen_size = sqrtf(f32(levels[l + 1].size() / 3u) / LOD_TRIANGLE_DENSITY);
+		}
+
+		mesh.lod_count = count;
+	}
+
+	u32 mesh_select_lod(const Mesh& mesh, f32 screen_size)
+	{
+		foreach(i, mesh.lod_count) {
+
+			if (screen_size >= mesh.lods[i].screen_size)
+				return i;
+		}
+		
+		return 0u;
+	}
+
+	// The lod indices are placed before the full mesh indices
+	SV_AUX const MeshIndex* get_index_data(const Mesh& mesh, List<MeshIndex>& index_data)
+	{
+		if (mesh.lod_indices.empty())
+			return mesh.indices.data();
+
+		index_data.insert(mesh.lod_indices);
+		index_data.insert(mesh.indices);
+		return index_data.data();
+	}
+
     bool mesh_create_buffers(Mesh& mesh, ResourceUsage usage)
     {
 		//ASSERT_VERTICES();
@@ -431,19 +1017,27 @@ namespace sv {
 		desc.cpu_access = (usage == ResourceUsage_Static) ? CPUAccess_None : CPUAccess_Write;
 		desc.size = u32(vertex_data.size() * sizeof(MeshVertex));
 		desc.data = vertex_data.data();
+		desc.async_upload = (usage == ResourceUsage_Static);
 
 		SV_CHECK(graphics_buffer_create(&desc, &mesh.vbuffer));
 
+		List<MeshIndex> index_data;
+		const MeshIndex* indices = get_index_data(mesh, index_data);
+
 		desc.index_type = IndexType_32;
 		desc.buffer_type = GPUBufferType_Index;
-		desc.size = u32(mesh.indices.size() * sizeof(MeshIndex));
-		desc.data = mesh.indices.data();
+		desc.size = u32((mesh.lod_indices.size() + mesh.indices.size()) * sizeof(MeshIndex));
+		desc.data = indices;
 
 		SV_CHECK(graphics_buffer_create(&desc, &mesh.ibuffer));
 
 		graphics_name_set(mesh.vbuffer, "MeshVertexBuffer");
 		graphics_name_set(mesh.ibuffer, "MeshIndexBuffer");
 
+		mesh.vertex_count = u32(mesh.positions.size());
+		mesh.index_offset = u32(mesh.lod_indices.size());
+		mesh.index_count = u32(mesh.indices.size());
+
 		return true;
     }
 
@@ -458,11 +1052,23 @@ namespace sv {
 		construct_vertex_data(mesh, vertex_data);
 
 		graphics_buffer_update(mesh.vbuffer, GPUBufferState_Vertex, vertex_data.data(), (u32)vertex_data.size() * sizeof(MeshVertex), 0u, cmd);
-		graphics_buffer_update(mesh.ibuffer, GPUBufferState_Index, mesh.indices.data(), (u32)mesh.indices.size() * sizeof(MeshIndex), 0u, cmd);
+		List<MeshIndex> index_data;
+		const MeshIndex* indices = get_index_data(mesh, index_data);
+
+		graphics_buffer_update(mesh.ibuffer, GPUBufferState_Index, indices, u32(mesh.lod_indices.size() + mesh.indices.size()) * sizeof(MeshIndex), 0u, cmd);
+
+		mesh.vertex_count = u32(mesh.positions.size());
+		mesh.index_offset = u32(mesh.lod_indices.size());
+		mesh.index_count = u32(mesh.indices.size());
 		
 		return true;
     }
 
+    bool mesh_is_resident(const Mesh& mesh)
+    {
+		return mesh.vbuffer && mesh.ibuffer && graphics_is_resident(mesh.vbuffer) && graphics_is_resident(mesh.ibuffer);
+    }
+
 	void mesh_destroy_buffers(Mesh& mesh)
     {
 		graphics_destroy(mesh.vbuffer);
@@ -477,8 +1083,14 @@ namespace sv {
 		mesh.normals.clear();
 
 		mesh.indices.clear();
+		mesh.lod_indices.clear();
+		mesh.lod_count = 0u;
 
 		mesh_destroy_buffers(mesh);
+
+		mesh.vertex_count = 0u;
+		mesh.index_offset = 0u;
+		mesh.index_count = 0u;
     }
 
     SV_AUX void set_default_material(MaterialInfo* mat)
@@ -814,7 +1426,7 @@ namespace sv {
 		return u32(i);
     }
 
-    bool load_model(const char* filepath, ModelInfo& model_info)
+    SV_AUX bool model_info_begin(const char* filepath, ModelInfo& model_info)
     {
 		const char* model_extension = filepath_extension(filepath);
 
@@ -836,24 +1448,29 @@ namespace sv {
 			model_info.folderpath[folderpath_size] = '\0';
 		}
 
-		// Load .obj file
-		String file;
-	
-		if (file_read_text(filepath, file)) {
-
-			struct ObjTriangle {
-				i32 position_indices[3u];
-				i32 normal_indices[3u];
-				i32 texcoord_indices[3u];
-				bool smooth;
-			};
-	    
-			struct ObjMesh {
-				String name;
-				List<ObjTriangle> triangles;
-				u32 material_index;
-			};
+		return true;
+    }
+
+	struct ObjTriangle {
+		i32 position_indices[3u];
+		i32 normal_indices[3u];
+		i32 texcoord_indices[3u];
+		bool smooth;
+	};
 	    
+	struct ObjMesh {
+		String name;
+		List<ObjTriangle> triangles;
+		u32 material_index;
+	};
+
+	// Serial .obj parser, kept to validate the parallel importer in model_load_benchmark
+    SV_AUX bool load_obj_serial(const char* filepath, ModelInfo& model_info)
+    {
+		String file;
+	
+		if (file_read_text(filepath, file)) {
+
 			List<v3_f32> positions;
 			List<v3_f32> normals;
 			List<v2_f32> texcoords;
@@ -1349,302 +1966,1670 @@ namespace sv {
 		return true;
     }
 
-    SV_AUX void import_texture(Serializer& s, const char* realpath, const char* folderpath, const char* srcpath)
-    {
-		if (realpath == nullptr) {
-			serialize_string(s, "");
-			return;
-		}
-	
-		const char* texname = filepath_name(realpath);
-		char texpath[FILEPATH_SIZE + 1u];
-		strcpy(texpath, folderpath);
-		strcat(texpath, "images/");
-		strcat(texpath, texname);
+	// Parallel .obj importer. The file is split in line aligned chunks parsed in worker threads, the vertex arrays
+	// are concatenated in file order so the raw indices don't change. The statements that change the parser state
+	// (objects, groups, materials) are stored as commands and replayed in file order in the main thread
+
+	constexpr size_t OBJ_CHUNK_SIZE = 1024u * 1024u;
+	constexpr u32 OBJ_POLYGON_COUNT = 4u;
+
+	enum ObjCommandType : u32 {
+		ObjCommandType_Triangles, // The next triangles of the chunk, value is the count
+		ObjCommandType_Object,
+		ObjCommandType_Group,
+		ObjCommandType_UseMtl,
+		ObjCommandType_MtlLib,
+		ObjCommandType_Smooth,
+		ObjCommandType_Error, // Stops the import, value is the message
+		ObjCommandType_Warning,
+	};
+
+	enum ObjMessage : u32 {
+		ObjMessage_Vector,
+		ObjMessage_MtlName,
+		ObjMessage_MtlPath,
+		ObjMessage_ObjectName,
+		ObjMessage_FaceVertices,
+		ObjMessage_Face,
+	};
+
+	struct ObjCommand {
+		ObjCommandType type;
+		u32            line; // Relative to the chunk
+		u32            value;
+		const char*    name; // Points to the file text
+		size_t         name_size;
+	};
+
+	struct ObjChunk {
+		const char*       begin;
+		const char*       end;
+		u32               line_count = 0u;
+		List<v3_f32>      positions;
+		List<v3_f32>      normals;
+		List<v2_f32>      texcoords;
+		List<ObjTriangle> triangles;
+		List<ObjCommand>  commands;
+	};
+
+	SV_AUX void obj_push_command(ObjChunk& chunk, ObjCommandType type, u32 line, u32 value = 0u, const char* name = nullptr, size_t name_size = 0u)
+	{
+		ObjCommand& c = chunk.commands.emplace_back();
+		c.type = type;
+		c.line = line;
+		c.value = value;
+		c.name = name;
+		c.name_size = name_size;
+	}
 
-		char srctexpath[FILEPATH_SIZE + 1u];
-		strcpy(srctexpath, srcpath);
-		strcat(srctexpath, realpath);
-	
-		if (!file_exists(texpath)) {
-	    
-			if (!file_copy(srctexpath, texpath)) {
-				SV_LOG_ERROR("Can't copy the file from '%s' to '%s'", srctexpath, texpath);
-			}
-			else SV_LOG_INFO("Texture imported '%s'", texpath);
-		}
-	
-		serialize_string(s, texpath);
-    }
+	SV_AUX ObjTriangle& obj_push_triangle(ObjChunk& chunk, u32 line)
+	{
+		if (chunk.commands.empty() || chunk.commands.back().type != ObjCommandType_Triangles)
+			obj_push_command(chunk, ObjCommandType_Triangles, line);
 
-    bool import_model(const char* filepath, const ModelInfo& model_info)
-    {
-		Serializer s;
+		++chunk.commands.back().value;
+		return chunk.triangles.emplace_back();
+	}
 
-		// Preparing folder path
-	
-		size_t folderpath_size = strlen(filepath);
-		if (folderpath_size >= FILEPATH_SIZE - 3u) {
-			SV_LOG_ERROR("This filepath is too large '%s'", filepath);
-			return false;
-		}
+	SV_AUX size_t obj_read_name(const char*& line)
+	{
+		line_jump_spaces(line);
+		return string_split(line, " \n\r", 3u);
+	}
 
-		char folderpath[FILEPATH_SIZE + 1u] = "";
-		if (folderpath_size) {
+	SV_INTERNAL void obj_parse_chunk_task(void* data)
+	{
+		ObjChunk& chunk = **reinterpret_cast<ObjChunk**>(data);
 
-			if (folderpath[folderpath_size - 1u] != '/') {
-				sprintf(folderpath, "%s/", filepath);
-			}
-			else strcpy(folderpath, filepath);
-		}
+		LineProcessor p;
+		line_begin(p, chunk.begin);
 
-		folderpath_size = strlen(folderpath);
-		if (folderpath_size >= FILEPATH_SIZE) {
-			SV_LOG_ERROR("This filepath is too large '%s'", filepath);
-			return false;
-		}
+		while (chunk.begin + p.offset < chunk.end && line_next(p)) {
 
-		// Creating mesh files
-	
-		for (const MeshInfo& mesh : model_info.meshes) {
+			u32 line = p.line_count;
+			line_jump_spaces(p.line);
 
-			if (!mesh.import)
-				continue;
+			switch (*p.line) {
 
-			size_t meshpath_size = folderpath_size + mesh.name.size() + strlen(".mesh");
-			if (meshpath_size >= FILEPATH_SIZE) {
-				SV_LOG_ERROR("This filepath is too large '%s'", filepath);
-				return false;
-			}
-	    
-			serialize_begin(s);
+			case 'u': // use mtl
+			{
+				++p.line;
+				if (p.line[0] == 's' && p.line[1] == 'e' && p.line[2] == 'm' && p.line[3] == 't' && p.line[4] == 'l') {
 
-			serialize_u32(s, 1u); // VERSION
+					p.line += 5u;
+					size_t name_size = obj_read_name(p.line);
+
+					if (name_size == 0u) {
+						obj_push_command(chunk, ObjCommandType_Error, line, ObjMessage_MtlName);
+						chunk.line_count = p.line_count;
+						return;
+					}
 
-			serialize_v3_f32_array(s, mesh.positions);
-			serialize_v3_f32_array(s, mesh.normals);
-			serialize_v2_f32_array(s, mesh.texcoords);
-			serialize_u32_array(s, mesh.indices);
+					obj_push_command(chunk, ObjCommandType_UseMtl, line, 0u, p.line, name_size);
+				}
+			}
+			break;
 
-			if (mesh.material_index == u32_max)
-				serialize_string(s, "");
-			else
-				serialize_string(s, model_info.materials[mesh.material_index].name);
+			case 'm': // .mtl path
+			{
+				++p.line;
+				if (p.line[0] == 't' && p.line[1] == 'l' && p.line[2] == 'l' && p.line[3] == 'i' && p.line[4] == 'b') {
 
-			serialize_xmmatrix(s, mesh.transform_matrix);
+					p.line += 5u;
+					size_t name_size = obj_read_name(p.line);
 
-			char meshpath[FILEPATH_SIZE + 1u];
-			sprintf(meshpath, "%s%s.mesh", folderpath, mesh.name.c_str());
+					if (name_size == 0u) {
+						obj_push_command(chunk, ObjCommandType_Error, line, ObjMessage_MtlPath);
+						chunk.line_count = p.line_count;
+						return;
+					}
 
-			if (!serialize_end(s, meshpath)) {
-				SV_LOG_ERROR("Can't save the mesh '%s'", meshpath);
-				return false;
-			}
-			else {
-				SV_LOG_INFO("Mesh imported '%s'", meshpath);
+					obj_push_command(chunk, ObjCommandType_MtlLib, line, 0u, p.line, name_size);
+				}
 			}
-		}
+			break;
 
-		// Creating material files
+			case 'o': // New Object
+			case 'g': // New Group
+			{
+				ObjCommandType type = (*p.line == 'o') ? ObjCommandType_Object : ObjCommandType_Group;
 
-		for (const MaterialInfo& mat : model_info.materials) {
+				++p.line;
+				size_t name_size = obj_read_name(p.line);
 
-			if (!mat.import)
-				continue;
+				if (name_size == 0u) {
+					obj_push_command(chunk, ObjCommandType_Error, line, ObjMessage_ObjectName);
+					chunk.line_count = p.line_count;
+					return;
+				}
 
-			size_t matpath_size = folderpath_size + mat.name.size() + strlen(".mat");
-			if (matpath_size >= FILEPATH_SIZE) {
-				SV_LOG_ERROR("This filepath is too large '%s'", filepath);
-				return false;
+				obj_push_command(chunk, type, line, 0u, p.line, name_size);
 			}
-	    
-			serialize_begin(s);
-
-			serialize_u32(s, 1u); // VERSION
+			break;
 
-			// Renderer settings
+			case 's':
 			{
-				serialize_bool(s, mat.transparent);
-				serialize_u32(s, mat.culling);
+				++p.line;
+				line_jump_spaces(p.line);
+				obj_push_command(chunk, ObjCommandType_Smooth, line, (*p.line != 1) ? 0u : 1u);
 			}
+			break;
 
-			serialize_color(s, mat.ambient_color);
-			serialize_color(s, mat.diffuse_color);
-			serialize_color(s, mat.specular_color);
-			serialize_color(s, mat.emissive_color);
-			serialize_f32(s, mat.shininess);
+			case 'v': // Vertex info
+			{
+				++p.line;
 
-			import_texture(s, mat.diffuse_map_path.c_str(), folderpath, model_info.folderpath);
-			import_texture(s, mat.normal_map_path.c_str(), folderpath, model_info.folderpath);
-			import_texture(s, mat.specular_map_path.c_str(), folderpath, model_info.folderpath);
-			import_texture(s, mat.emissive_map_path.c_str(), folderpath, model_info.folderpath);
+				bool res = true;
 
-			char matpath[FILEPATH_SIZE + 1u];
-			sprintf(matpath, "%s%s.mat", folderpath, mat.name.c_str());
+				switch(*p.line) {
 
-			if (!serialize_end(s, matpath)) {
-				SV_LOG_ERROR("Can't save the material '%s'", matpath);
-				return false;
-			}
-			else {
-				SV_LOG_INFO("Material imported '%s'", matpath);
-			}	    
-		}
-	
-		return true;
-    }
+				case ' ': // Position
+				{
+					v3_f32& v = chunk.positions.emplace_back();
+					res = line_read_v3_f32(p.line, v);
+				}
+				break;
 
-	bool save_mesh(const Mesh& mesh, const char* filepath)
-	{
-		Serializer s;
-		serialize_begin(s);
+				case 'n': // Normal
+				{
+					++p.line;
+					v3_f32& v = chunk.normals.emplace_back();
+					res = line_read_v3_f32(p.line, v);
+				}
+				break;
 
-		serialize_u32(s, 1u); // VERSION
+				case 't': // Texcoord
+				{
+					++p.line;
+					v2_f32& v = chunk.texcoords.emplace_back();
 
-		serialize_v3_f32_array(s, mesh.positions);
-		serialize_v3_f32_array(s, mesh.normals);
-		serialize_v2_f32_array(s, mesh.texcoords);
-		serialize_u32_array(s, mesh.indices);
+					res = line_read_f32(p.line, v.x);
 
-		serialize_string(s, mesh.model_material_filepath);
+					// v coord is optional
+					if (res) {
+						line_read_f32(p.line, v.y);
+						v.y = 1.f - v.y;
+					}
+				}
+				break;
+				}
 
-		serialize_xmmatrix(s, mesh.model_transform_matrix);
+				if (!res) {
+					obj_push_command(chunk, ObjCommandType_Error, line, ObjMessage_Vector);
+					chunk.line_count = p.line_count;
+					return;
+				}
+			}
+			break;
 
-		if (!serialize_end(s, filepath)) {
-			SV_LOG_ERROR("Can't save the mesh '%s'", filepath);
-			return false;
-		}
-		else SV_LOG_INFO("Mesh saved at '%s' filepath");
+			case 'f': // Face
+			{
+				++p.line;
+				line_jump_spaces(p.line);
 
-		return true;
-	}
-	
-    bool save_material(const Material& mat, const char* filepath)
-	{
-		Serializer s;
-		serialize_begin(s);
+				u32 vertex_count = 0u;
+		    
+				i32 position_index[OBJ_POLYGON_COUNT] = {};
+				i32 normal_index[OBJ_POLYGON_COUNT] = {};
+				i32 texcoord_index[OBJ_POLYGON_COUNT] = {};
 
-		serialize_u32(s, 1u); // VERSION
+				const char delimiters[] = { ' ', '/' };
 
-		// Renderer settings
-		{
-			serialize_bool(s, mat.transparent);
-			serialize_u32(s, mat.culling);
-		}
+				bool res;
 
-		serialize_color(s, mat.ambient_color);
-		serialize_color(s, mat.diffuse_color);
-		serialize_color(s, mat.specular_color);
-		serialize_color(s, mat.emissive_color);
-		serialize_f32(s, mat.shininess);
+				foreach(i, OBJ_POLYGON_COUNT) {
 
-		serialize_string(s, string_validate(mat.diffuse_map.get_filepath()));
-		serialize_string(s, string_validate(mat.normal_map.get_filepath()));
-		serialize_string(s, string_validate(mat.specular_map.get_filepath()));
-		serialize_string(s, string_validate(mat.emissive_map.get_filepath()));
+					res = line_read_i32(p.line, position_index[i], delimiters, 2u);
+					if (res && *p.line == '/') {
 
-		if (!serialize_end(s, filepath)) {
-			SV_LOG_ERROR("Can't save the material '%s'", filepath);
-			return false;
-		}
-		else {
-			SV_LOG_INFO("Material saved at '%s'", filepath);
-		}
-		return true;
-	}
+						++p.line;
 
-    bool load_mesh(Mesh& mesh, const char* filepath)
-    {
-		Deserializer d;
+						if (*p.line == '/') {
+							res = line_read_i32(p.line, normal_index[i], delimiters, 2u);
+						}
+						else {
+							res = line_read_i32(p.line, texcoord_index[i], delimiters, 2u);
 
-		if (deserialize_begin(d, filepath)) {
+							if (res && *p.line == '/') {
+								++p.line;
+								res = line_read_i32(p.line, normal_index[i], delimiters, 2u);
+							}
+						}
+					}
 
-			u32 version;
-			deserialize_u32(d, version);
-	    
-			deserialize_v3_f32_array(d, mesh.positions);
-			deserialize_v3_f32_array(d, mesh.normals);
-			deserialize_v2_f32_array(d, mesh.texcoords);
-			deserialize_u32_array(d, mesh.indices);
+					if (!res) break;
 
-			char matname[FILEPATH_SIZE + 1u];
-			deserialize_string(d, matname, FILEPATH_SIZE + 1u);
+					++vertex_count;
 
-			if (strlen(filepath)) {
+					line_jump_spaces(p.line);
+					if (*p.line == '\r' || *p.line == '\n') break;
+				}
 
-				strcat(matname, ".mat");
-				char matpath[FILEPATH_SIZE + 1u];
+				if (*p.line != '\r' && *p.line != '\n')
+					obj_push_command(chunk, ObjCommandType_Warning, line, ObjMessage_FaceVertices);
 
-				size_t s = strlen(filepath) - 1u;
-				while (s && filepath[s] != '/') --s;
+				if (!res || vertex_count < 3u) {
+					obj_push_command(chunk, ObjCommandType_Warning, line, ObjMessage_Face);
+					break;
+				}
 
-				if (s) s++;
-		
-				memcpy(matpath, filepath, s);
-				matpath[s] = '\0';
-		
-				strcat(matpath, matname);
+				// Quads are split in (0, 1, 2) and (0, 2, 3)
+				const u32 triangle_vertices[2u][3u] = { { 0u, 1u, 2u }, { 0u, 2u, 3u } };
+			    
+				foreach(j, vertex_count - 2u) {
 
-				string_copy(mesh.model_material_filepath, matpath, FILEPATH_SIZE + 1u);
+					ObjTriangle& t = obj_push_triangle(chunk, line);
+
+					foreach(k, 3u) {
+
+						u32 i = triangle_vertices[j][k];
+						t.position_indices[k] = position_index[i];
+						t.normal_indices[k] = normal_index[i];
+						t.texcoord_indices[k] = texcoord_index[i];
+					}
+				}
 			}
+			break;
 
-			if (version != 0) {
-				deserialize_xmmatrix(d, mesh.model_transform_matrix);
 			}
-	    
-			deserialize_end(d);
-		}
-		else {
-			SV_LOG_ERROR("Mesh file '%s', not found", filepath);
-			return false;
 		}
 
-		mesh_calculate_tangents(mesh);
-	
-		return true;
-    }
+		chunk.line_count = p.line_count;
+	}
 
-    bool load_material(Material& mat, const char* filepath)
-    {
-		Deserializer d;
+	SV_AUX void log_obj_message(ObjMessage message, u32 line)
+	{
+		switch (message) {
 
-		if (deserialize_begin(d, filepath)) {
+		case ObjMessage_Vector:
+			SV_LOG_ERROR("Can't read the vector at line %u", line);
+			break;
 
-			u32 version;
-			deserialize_u32(d, version);
+		case ObjMessage_MtlName:
+			SV_LOG_ERROR("Can't read the mtl name in line %u", line);
+			break;
 
-			if (version != 0u) {
-				deserialize_bool(d, mat.transparent);
-				deserialize_u32(d, (u32&)mat.culling);
-			}
+		case ObjMessage_MtlPath:
+			SV_LOG_ERROR("Can't read the mtl path in line %u", line);
+			break;
 
-			deserialize_color(d, mat.ambient_color);
-			deserialize_color(d, mat.diffuse_color);
-			deserialize_color(d, mat.specular_color);
-			deserialize_color(d, mat.emissive_color);
-			deserialize_f32(d, mat.shininess);
+		case ObjMessage_ObjectName:
+			SV_LOG_ERROR("Can't read the object name in line %u", line);
+			break;
 
-			constexpr size_t buff_size = FILEPATH_SIZE + 1u;
-			char texpath[buff_size];
+		case ObjMessage_FaceVertices:
+			SV_LOG_ERROR("Can't read more than %u vertices in one face. Try to triangulate this .obj. Line %u", OBJ_POLYGON_COUNT, line);
+			break;
 
-			// TODO: Check errors
-			deserialize_string(d, texpath, buff_size);
-			if (texpath[0])
-				load_asset_from_file(mat.diffuse_map, texpath);
-	    
-			deserialize_string(d, texpath, buff_size);
-			if (texpath[0])
-				load_asset_from_file(mat.normal_map, texpath);
+		case ObjMessage_Face:
+			SV_LOG_ERROR("Can't read the face at line %u", line);
+			break;
+
+		}
+	}
+
+	// Builds the meshes in file order as the serial parser does
+	SV_AUX bool obj_replay_commands(const char* filepath, const List<ObjChunk>& chunks, List<ObjMesh>& meshes, ModelInfo& model_info)
+	{
+		ObjMesh* mesh = &meshes.emplace_back();
+		mesh->material_index = u32_max;
+		bool using_default = true;
+		bool smooth = true;
 
-			deserialize_string(d, texpath, buff_size);
-			if (texpath[0])
-				load_asset_from_file(mat.specular_map, texpath);
+		u32 line_offset = 0u;
 
-			deserialize_string(d, texpath, buff_size);
-			if (texpath[0])
-				load_asset_from_file(mat.emissive_map, texpath);
-	    
+		for (const ObjChunk& chunk : chunks) {
+
+			const ObjTriangle* triangle = chunk.triangles.data();
+
+			for (const ObjCommand& c : chunk.commands) {
+
+				u32 line = line_offset + c.line;
+
+				switch (c.type) {
+
+				case ObjCommandType_Triangles:
+				{
+					mesh->triangles.reserve(c.value);
+
+					foreach(i, c.value) {
+						
+						ObjTriangle& t = mesh->triangles.emplace_back(*triangle++);
+						t.smooth = smooth;
+					}
+				}
+				break;
+
+				case ObjCommandType_Object:
+				{
+					if (using_default) {
+						using_default = false;
+					}
+					else {
+						mesh = &meshes.emplace_back();
+						mesh->material_index = u32_max;
+					}
+
+					mesh->name.set(c.name, 0u, c.name_size);
+				}
+				break;
+
+				case ObjCommandType_Group:
+				{
+					if (mesh->triangles.empty()) {
+						mesh->name.set(c.name, 0u, c.name_size);
+					}
+					else {
+						mesh = &meshes.emplace_back();
+						mesh->material_index = u32_max;
+					}
+				}
+				break;
+
+				case ObjCommandType_UseMtl:
+				{
+					char texpath[FILEPATH_SIZE + 1u];
+					size_t name_size = SV_MIN(c.name_size, size_t(FILEPATH_SIZE));
+					memcpy(texpath, c.name, name_size);
+					texpath[name_size] = '\0';
+
+					u32 index = u32_max;
+			    
+					foreach(i, model_info.materials.size()) {
+
+						if (strcmp(model_info.materials[i].name.c_str(), texpath) == 0) {
+							index = i;
+							break;
+						}
+					}
+
+					if (index == u32_max) {
+						SV_LOG_ERROR("Material %s not found, line %u", texpath, line);
+						return false;
+					}
+
+					mesh->material_index = index;
+				}
+				break;
+
+				case ObjCommandType_MtlLib:
+				{
+					char mtlname[FILEPATH_SIZE + 1u] = "";
+					size_t name_size = SV_MIN(c.name_size, size_t(FILEPATH_SIZE));
+					memcpy(mtlname, c.name, name_size);
+					mtlname[name_size] = '\0';
+
+					char mtlpath[FILEPATH_SIZE + 1u] = "";
+					strcat(mtlpath, filepath);
+
+					size_t s = strlen(mtlpath) - 1u;
+
+					while (s && mtlpath[s] != '/') --s;
+					mtlpath[s + 1u] = '\0';
+					strcat(mtlpath, mtlname);
+
+					read_mtl(mtlpath, model_info);
+				}
+				break;
+
+				case ObjCommandType_Smooth:
+					smooth = c.value != 0u;
+					break;
+
+				case ObjCommandType_Error:
+					log_obj_message(ObjMessage(c.value), line);
+					return false;
+
+				case ObjCommandType_Warning:
+					log_obj_message(ObjMessage(c.value), line);
+					break;
+
+				}
+			}
+
+			line_offset += chunk.line_count;
+		}
+
+		return true;
+	}
+
+	struct ObjMergeTaskData {
+		const ObjChunk* chunk;
+		v3_f32*         positions;
+		v3_f32*         normals;
+		v2_f32*         texcoords;
+	};
+
+	SV_INTERNAL void obj_merge_task(void* data)
+	{
+		ObjMergeTaskData& d = *reinterpret_cast<ObjMergeTaskData*>(data);
+		const ObjChunk& chunk = *d.chunk;
+
+		if (chunk.positions.size()) memcpy(d.positions, chunk.positions.data(), chunk.positions.size() * sizeof(v3_f32));
+		if (chunk.normals.size()) memcpy(d.normals, chunk.normals.data(), chunk.normals.size() * sizeof(v3_f32));
+		if (chunk.texcoords.size()) memcpy(d.texcoords, chunk.texcoords.data(), chunk.texcoords.size() * sizeof(v2_f32));
+	}
+
+	struct ObjMeshTaskData {
+		const ObjMesh*       obj_mesh;
+		MeshInfo*            mesh;
+		const List<v3_f32>*  positions;
+		const List<v3_f32>*  normals;
+		const List<v2_f32>*  texcoords;
+	};
+
+	// The vertices are keyed by the position index, the normal and the texcoord of the last face that uses the position are kept.
+	// The meshes are independent, each one is built and centralized in a worker thread
+	SV_INTERNAL void obj_mesh_task(void* data)
+	{
+		ObjMeshTaskData& d = *reinterpret_cast<ObjMeshTaskData*>(data);
+
+		const ObjMesh& obj_mesh = *d.obj_mesh;
+		MeshInfo& mesh = *d.mesh;
+		const List<v3_f32>& positions = *d.positions;
+		const List<v3_f32>& normals = *d.normals;
+		const List<v2_f32>& texcoords = *d.texcoords;
+
+		// Compute min and max position indices
+		u32 min_position_index = u32_max;
+		u32 max_position_index = 0u;
+		
+		for (const ObjTriangle& t : obj_mesh.triangles) {
+
+			foreach(j, 3u) {
+			    
+				i32 i = t.position_indices[j];
+				SV_ASSERT(i != 0);
+
+				if (i > 0) {
+					--i;
+				}
+				else if (i < 0) {
+					i = i32(positions.size()) + i;
+				}
+				else i = min_position_index;
+
+				min_position_index = SV_MIN(u32(i), min_position_index);
+				max_position_index = SV_MAX(u32(i), max_position_index);
+			}
+		}
+
+		u32 elements = max_position_index - min_position_index + 1u;
+
+		mesh.positions.resize(elements);
+		mesh.normals.resize(elements);
+		mesh.texcoords.resize(elements);
+
+		mesh.indices.resize(obj_mesh.triangles.size() * 3u);
+
+		memcpy(mesh.positions.data(), positions.data() + min_position_index, elements * sizeof(v3_f32));
+
+		MeshIndex* index_it = mesh.indices.data();
+		i32 max = i32(positions.size());
+		u32 min = min_position_index;
+
+		for (const ObjTriangle& t : obj_mesh.triangles) {
+
+			foreach(j, 3u) {
+			    
+				u32 index = parse_objindex_to_absolute(t.position_indices[j], max) - min;
+				u32 normal_index = parse_objindex_to_absolute(t.normal_indices[j], max);
+				u32 texcoord_index = parse_objindex_to_absolute(t.texcoord_indices[j], max);
+
+				if (normal_index < normals.size()) mesh.normals[index] = normals[normal_index];
+				if (texcoord_index < texcoords.size()) mesh.texcoords[index] = texcoords[texcoord_index];
+			
+				*index_it++ = index;
+			}
+		}
+
+		// Centralize mesh
+		f32 min_x = f32_max;
+		f32 min_y = f32_max;
+		f32 min_z = f32_max;
+		f32 max_x = -f32_max;
+		f32 max_y = -f32_max;
+		f32 max_z = -f32_max;
+
+		for (const v3_f32& pos : mesh.positions) {
+
+			min_x = SV_MIN(min_x, pos.x);
+			min_y = SV_MIN(min_y, pos.y);
+			min_z = SV_MIN(min_z, pos.z);
+
+			max_x = SV_MAX(max_x, pos.x);
+			max_y = SV_MAX(max_y, pos.y);
+			max_z = SV_MAX(max_z, pos.z);
+		}
+
+		v3_f32 center = v3_f32(min_x + (max_x - min_x) * 0.5f, min_y + (max_y - min_y) * 0.5f, min_z + (max_z - min_z) * 0.5f);
+		f32 dim = SV_MAX(SV_MAX(max_x - min_x, max_y - min_y), max_z - min_z);
+
+		for (v3_f32& pos : mesh.positions) {
+
+			pos -= center;
+			pos /= dim;
+		}
+
+		mesh.transform_matrix = XMMatrixScaling(dim, dim, dim) * XMMatrixTranslation(center.x, center.y, center.z);
+	}
+
+    bool load_model(const char* filepath, ModelInfo& model_info)
+    {
+		SV_CHECK(model_info_begin(filepath, model_info));
+
+		String file;
+	
+		if (!file_read_text(filepath, file)) {
+			SV_LOG_ERROR("Can't load the model '%s', not found", filepath);
+			return false;
+		}
+
+		const char* text = file.c_str();
+		const char* text_end = text + file.size();
+
+		// Line aligned chunks
+		List<ObjChunk> chunks;
+
+		for (const char* it = text; it < text_end;) {
+
+			ObjChunk& chunk = chunks.emplace_back();
+			chunk.begin = it;
+
+			if (size_t(text_end - it) > OBJ_CHUNK_SIZE) {
+
+				it = string_scan(it + OBJ_CHUNK_SIZE, "\n", 1u);
+				if (*it == '\n') ++it;
+			}
+			else it = text_end;
+
+			chunk.end = it;
+		}
+
+		TaskContext context;
+
+		for (ObjChunk& chunk : chunks) {
+
+			ObjChunk* ptr = &chunk;
+			
+			if (chunks.size() == 1u) obj_parse_chunk_task(&ptr);
+			else task_dispatch(obj_parse_chunk_task, &ptr, sizeof(ptr), &context);
+		}
+
+		task_wait(context);
+
+		List<ObjMesh> meshes;
+
+		if (!obj_replay_commands(filepath, chunks, meshes, model_info))
+			return false;
+
+		// Vertex arrays, the chunk offsets are prefix sums of the chunk sizes
+		List<v3_f32> positions;
+		List<v3_f32> normals;
+		List<v2_f32> texcoords;
+
+		{
+			size_t position_count = 0u;
+			size_t normal_count = 0u;
+			size_t texcoord_count = 0u;
+
+			for (const ObjChunk& chunk : chunks) {
+				position_count += chunk.positions.size();
+				normal_count += chunk.normals.size();
+				texcoord_count += chunk.texcoords.size();
+			}
+
+			positions.resize(position_count);
+			normals.resize(normal_count);
+			texcoords.resize(texcoord_count);
+
+			position_count = 0u;
+			normal_count = 0u;
+			texcoord_count = 0u;
+
+			for (const ObjChunk& chunk : chunks) {
+
+				ObjMergeTaskData d;
+				d.chunk = &chunk;
+				d.positions = positions.data() + position_count;
+				d.normals = normals.data() + normal_count;
+				d.texcoords = texcoords.data() + texcoord_count;
+
+				task_dispatch(obj_merge_task, &d, sizeof(d), &context);
+
+				position_count += chunk.positions.size();
+				normal_count += chunk.normals.size();
+				texcoord_count += chunk.texcoords.size();
+			}
+
+			task_wait(context);
+		}
+
+		// Meshes
+		{
+			u32 first_mesh = u32(model_info.meshes.size());
+
+			for (const ObjMesh& obj_mesh : meshes) {
+
+				if (obj_mesh.triangles.empty())
+					continue;
+
+				MeshInfo& mesh = model_info.meshes.emplace_back();
+
+				if (obj_mesh.name.size())
+					mesh.name.set(obj_mesh.name.c_str());
+
+				mesh.material_index = obj_mesh.material_index;
+			}
+
+			u32 mesh_index = first_mesh;
+
+			for (const ObjMesh& obj_mesh : meshes) {
+
+				if (obj_mesh.triangles.empty())
+					continue;
+
+				ObjMeshTaskData d;
+				d.obj_mesh = &obj_mesh;
+				d.mesh = &model_info.meshes[mesh_index++];
+				d.positions = &positions;
+				d.normals = &normals;
+				d.texcoords = &texcoords;
+
+				task_dispatch(obj_mesh_task, &d, sizeof(d), &context);
+			}
+
+			task_wait(context);
+		}
+
+		return true;
+    }
+
+    SV_AUX void import_texture(Serializer& s, const char* realpath, const char* folderpath, const char* srcpath)
+    {
+		if (realpath == nullptr) {
+			serialize_string(s, "");
+			return;
+		}
+	
+		const char* texname = filepath_name(realpath);
+		char texpath[FILEPATH_SIZE + 1u];
+		strcpy(texpath, folderpath);
+		strcat(texpath, "images/");
+		strcat(texpath, texname);
+
+		char srctexpath[FILEPATH_SIZE + 1u];
+		strcpy(srctexpath, srcpath);
+		strcat(srctexpath, realpath);
+	
+		if (!file_exists(texpath)) {
+	    
+			if (!file_copy(srctexpath, texpath)) {
+				SV_LOG_ERROR("Can't copy the file from '%s' to '%s'", srctexpath, texpath);
+			}
+			else SV_LOG_INFO("Texture imported '%s'", texpath);
+		}
+	
+		serialize_string(s, texpath);
+    }
+
+    /*
+      Legacy mesh file, still supported by load_mesh:
+      - Version 0: positions, normals, texcoords, indices and material name
+      - Version 1: model transform matrix
+      - Version 2: lod table and lod indices before the vertices. The vertices and the lods are sorted coarse first,
+                   the coarse levels can be read without the whole vertex arrays
+    */
+	constexpr u32 MESH_VERSION = 2u;
+
+	SV_AUX void serialize_mesh(Serializer& s, const Mesh& mesh, const char* material_name)
+	{
+		serialize_u32(s, MESH_VERSION);
+
+		serialize_u32(s, mesh.lod_count);
+
+		foreach(i, mesh.lod_count) {
+
+			const MeshLod& lod = mesh.lods[i];
+			serialize_u32(s, lod.index_offset);
+			serialize_u32(s, lod.index_count);
+			serialize_u32(s, lod.vertex_count);
+			serialize_f32(s, lod.screen_size);
+		}
+
+		serialize_u32_array(s, mesh.lod_indices);
+
+		serialize_v3_f32_array(s, mesh.positions);
+		serialize_v3_f32_array(s, mesh.normals);
+		serialize_v2_f32_array(s, mesh.texcoords);
+		serialize_u32_array(s, mesh.indices);
+
+		serialize_string(s, material_name);
+
+		serialize_xmmatrix(s, mesh.model_transform_matrix);
+	}
+
+    /*
+      Binary mesh file:
+      - Header (MeshFileHeader)
+      - Vertex blob: MeshVertex array, aligned to MESH_FILE_ALIGNMENT
+      - Index blob: lod indices (coarse first) followed by the mesh indices, aligned to MESH_FILE_ALIGNMENT
+    */
+	constexpr u32 MESH_FILE_MAGIC = 0x424D5653; // SVMB
+	constexpr u32 MESH_FILE_VERSION = 0u;
+	constexpr u32 MESH_FILE_ALIGNMENT = 16u;
+
+	struct MeshFileHeader {
+		u32        magic;
+		u32        version;
+		u32        vertex_count;
+		u32        index_count;
+		u32        mesh_index_offset;
+		u32        mesh_index_count;
+		u32        lod_count;
+		u32        _padding;
+		MeshLod    lods[MESH_LOD_MAX];
+		v3_f32     bounds_center;
+		f32        bounds_radius;
+		XMFLOAT4X4 transform_matrix;
+		u64        vertex_offset;
+		u64        index_offset;
+		char       material_name[FILEPATH_SIZE + 1u];
+	};
+
+	SV_AUX u64 mesh_file_align(u64 offset)
+	{
+		return (offset + MESH_FILE_ALIGNMENT - 1u) & ~u64(MESH_FILE_ALIGNMENT - 1u);
+	}
+
+	SV_AUX bool write_mesh_file(const Mesh& mesh, const char* material_name, const char* filepath, bool compress = false)
+	{
+		if (strlen(material_name) > FILEPATH_SIZE) {
+			SV_LOG_ERROR("The material name is too large '%s'", material_name);
+			return false;
+		}
+		
+		List<MeshVertex> vertices;
+		construct_vertex_data(mesh, vertices);
+
+		List<MeshIndex> index_data;
+		const MeshIndex* indices = get_index_data(mesh, index_data);
+		u32 index_count = u32(mesh.lod_indices.size() + mesh.indices.size());
+
+		MeshFileHeader header;
+		SV_ZERO_MEMORY(&header, sizeof(MeshFileHeader));
+
+		header.magic = MESH_FILE_MAGIC;
+		header.version = MESH_FILE_VERSION;
+		header.vertex_count = u32(vertices.size());
+		header.index_count = index_count;
+		header.mesh_index_offset = u32(mesh.lod_indices.size());
+		header.mesh_index_count = u32(mesh.indices.size());
+		header.lod_count = mesh.lod_count;
+		memcpy(header.lods, mesh.lods, sizeof(MeshLod) * mesh.lod_count);
+		header.bounds_center = mesh.bounds_center;
+		header.bounds_radius = mesh.bounds_radius;
+		XMStoreFloat4x4(&header.transform_matrix, mesh.model_transform_matrix);
+		header.vertex_offset = mesh_file_align(sizeof(MeshFileHeader));
+		header.index_offset = mesh_file_align(header.vertex_offset + vertices.size() * sizeof(MeshVertex));
+		strcpy(header.material_name, material_name);
+
+		size_t size = size_t(header.index_offset) + size_t(index_count) * sizeof(MeshIndex);
+		
+		u8* data = (u8*)SV_ALLOCATE_MEMORY(size, "Mesh");
+		SV_ZERO_MEMORY(data, size);
+
+		memcpy(data, &header, sizeof(MeshFileHeader));
+		memcpy(data + header.vertex_offset, vertices.data(), vertices.size() * sizeof(MeshVertex));
+		memcpy(data + header.index_offset, indices, size_t(index_count) * sizeof(MeshIndex));
+
+		bool res;
+
+		// The compressed files can't be mapped, mesh_file_open decompresses them
+		if (compress) {
+
+			RawList compressed;
+			compress_data(data, size, compressed);
+			res = file_write_binary(filepath, compressed.data(), compressed.size());
+		}
+		else res = file_write_binary(filepath, data, size);
+
+		SV_FREE_MEMORY(data);
+		return res;
+	}
+
+	bool mesh_file_open(MeshFile& file, const char* filepath)
+	{
+		file = {};
+		
+		if (!file_map(filepath, file.mapping))
+			return false;
+
+		if (data_is_compressed(file.mapping.data, file.mapping.size)) {
+
+			RawList raw;
+			bool res = decompress_data(file.mapping.data, file.mapping.size, raw);
+			
+			file_unmap(file.mapping);
+
+			if (!res) {
+				SV_LOG_ERROR("The compressed mesh file '%s' is corrupted", filepath);
+				return false;
+			}
+
+			// The mapping points to the owned buffer, file_unmap doesn't free the memory without file
+			file._decompressed = raw._data;
+			file.mapping.data = raw._data;
+			file.mapping.size = raw._size;
+
+			raw._data = NULL;
+			raw._size = 0u;
+			raw._capacity = 0u;
+		}
+
+		const MeshFileHeader* header = (const MeshFileHeader*)file.mapping.data;
+		size_t size = file.mapping.size;
+
+		// Legacy mesh file
+		if (size < sizeof(MeshFileHeader) || header->magic != MESH_FILE_MAGIC) {
+			mesh_file_close(file);
+			return false;
+		}
+
+		bool valid = header->version == MESH_FILE_VERSION
+			&& header->lod_count <= MESH_LOD_MAX
+			&& u64(header->mesh_index_offset) + header->mesh_index_count <= header->index_count
+			&& header->vertex_offset + u64(header->vertex_count) * sizeof(MeshVertex) <= size
+			&& header->index_offset + u64(header->index_count) * sizeof(MeshIndex) <= size
+			&& header->material_name[FILEPATH_SIZE] == '\0';
+
+		if (valid) {
+
+			foreach(i, header->lod_count) {
+
+				const MeshLod& lod = header->lods[i];
+				valid = valid && u64(lod.index_offset) + lod.index_count <= header->index_count;
+			}
+		}
+
+		// The indices are used by the GPU and the CPU data without more checks
+		if (valid) {
+
+			const MeshIndex* indices = (const MeshIndex*)(file.mapping.data + header->index_offset);
+			MeshIndex max_index = 0u;
+
+			foreach(i, header->index_count)
+				max_index = SV_MAX(max_index, indices[i]);
+
+			valid = header->index_count == 0u || max_index < header->vertex_count;
+		}
+
+		if (!valid) {
+			SV_LOG_ERROR("Invalid mesh file '%s'", filepath);
+			mesh_file_close(file);
+			return false;
+		}
+
+		file.header = header;
+		file.vertices = (const MeshVertex*)(file.mapping.data + header->vertex_offset);
+		file.indices = (const MeshIndex*)(file.mapping.data + header->index_offset);
+		file.vertex_count = header->vertex_count;
+		file.index_count = header->index_count;
+		
+		return true;
+	}
+
+	void mesh_file_close(MeshFile& file)
+	{
+		file_unmap(file.mapping);
+		if (file._decompressed) SV_FREE_MEMORY(file._decompressed);
+		file = {};
+	}
+
+	void mesh_file_prefetch(const MeshFile& file)
+	{
+		// The copy to the staging buffer doesn't stall in page faults
+		file_prefetch(file.mapping);
+	}
+
+	SV_AUX void set_mesh_material_filepath(Mesh& mesh, const char* filepath, const char* material_name)
+	{
+		if (strlen(filepath) == 0u || strlen(material_name) + strlen(".mat") > FILEPATH_SIZE)
+			return;
+
+		char matname[FILEPATH_SIZE + 1u];
+		strcpy(matname, material_name);
+		strcat(matname, ".mat");
+		
+		char matpath[FILEPATH_SIZE + 1u];
+
+		size_t s = strlen(filepath) - 1u;
+		while (s && filepath[s] != '/') --s;
+
+		if (s) s++;
+		
+		memcpy(matpath, filepath, s);
+		matpath[s] = '\0';
+
+		if (strlen(matpath) + strlen(matname) > FILEPATH_SIZE)
+			return;
+		
+		strcat(matpath, matname);
+
+		string_copy(mesh.model_material_filepath, matpath, FILEPATH_SIZE + 1u);
+	}
+
+	SV_AUX void read_mesh_file(Mesh& mesh, const MeshFile& file, const char* filepath, bool cpu_data)
+	{
+		const MeshFileHeader& header = *(const MeshFileHeader*)file.header;
+
+		mesh.lod_count = header.lod_count;
+		memcpy(mesh.lods, header.lods, sizeof(MeshLod) * header.lod_count);
+		mesh.bounds_center = header.bounds_center;
+		mesh.bounds_radius = header.bounds_radius;
+		mesh.model_transform_matrix = XMLoadFloat4x4(&header.transform_matrix);
+
+		set_mesh_material_filepath(mesh, filepath, header.material_name);
+
+		if (cpu_data) {
+
+			u32 vertex_count = file.vertex_count;
+			
+			mesh.positions.resize(vertex_count);
+			mesh.normals.resize(vertex_count);
+			mesh.tangents.resize(vertex_count);
+			mesh.texcoords.resize(vertex_count);
+
+			foreach(i, vertex_count) {
+
+				const MeshVertex& v = file.vertices[i];
+				mesh.positions[i] = v.position;
+				mesh.normals[i] = v.normal;
+				mesh.tangents[i] = v.tangents;
+				mesh.texcoords[i] = v.texcoord;
+			}
+
+			mesh.lod_indices.resize(header.mesh_index_offset);
+			memcpy(mesh.lod_indices.data(), file.indices, header.mesh_index_offset * sizeof(MeshIndex));
+
+			mesh.indices.resize(header.mesh_index_count);
+			memcpy(mesh.indices.data(), file.indices + header.mesh_index_offset, header.mesh_index_count * sizeof(MeshIndex));
+		}
+	}
+
+	bool mesh_create_from_file(Mesh& mesh, const MeshFile& file, const char* filepath, bool cpu_data)
+	{
+		if (mesh.vbuffer || mesh.ibuffer) return false;
+		
+		const MeshFileHeader& header = *(const MeshFileHeader*)file.header;
+
+		read_mesh_file(mesh, file, filepath, cpu_data);
+
+		GPUBufferDesc desc;
+		desc.buffer_type = GPUBufferType_Vertex;
+		desc.usage = ResourceUsage_Static;
+		desc.cpu_access = CPUAccess_None;
+		desc.size = file.vertex_count * sizeof(MeshVertex);
+		desc.data = file.vertices;
+		desc.async_upload = true;
+
+		SV_CHECK(graphics_buffer_create(&desc, &mesh.vbuffer));
+
+		desc.index_type = IndexType_32;
+		desc.buffer_type = GPUBufferType_Index;
+		desc.size = file.index_count * sizeof(MeshIndex);
+		desc.data = file.indices;
+
+		SV_CHECK(graphics_buffer_create(&desc, &mesh.ibuffer));
+
+		graphics_name_set(mesh.vbuffer, "MeshVertexBuffer");
+		graphics_name_set(mesh.ibuffer, "MeshIndexBuffer");
+
+		mesh.vertex_count = file.vertex_count;
+		mesh.index_offset = header.mesh_index_offset;
+		mesh.index_count = header.mesh_index_count;
+		
+		return true;
+	}
+
+    bool import_model(const char* filepath, const ModelInfo& model_info)
+    {
+		Serializer s;
+
+		// Preparing folder path
+	
+		size_t folderpath_size = strlen(filepath);
+		if (folderpath_size >= FILEPATH_SIZE - 3u) {
+			SV_LOG_ERROR("This filepath is too large '%s'", filepath);
+			return false;
+		}
+
+		char folderpath[FILEPATH_SIZE + 1u] = "";
+		if (folderpath_size) {
+
+			if (folderpath[folderpath_size - 1u] != '/') {
+				sprintf(folderpath, "%s/", filepath);
+			}
+			else strcpy(folderpath, filepath);
+		}
+
+		folderpath_size = strlen(folderpath);
+		if (folderpath_size >= FILEPATH_SIZE) {
+			SV_LOG_ERROR("This filepath is too large '%s'", filepath);
+			return false;
+		}
+
+		// Creating mesh files
+	
+		for (const MeshInfo& mesh : model_info.meshes) {
+
+			if (!mesh.import)
+				continue;
+
+			size_t meshpath_size = folderpath_size + mesh.name.size() + strlen(".mesh");
+			if (meshpath_size >= FILEPATH_SIZE) {
+				SV_LOG_ERROR("This filepath is too large '%s'", filepath);
+				return false;
+			}
+	    
+			Mesh lod_mesh;
+			lod_mesh.positions = mesh.positions;
+			lod_mesh.normals = mesh.normals;
+			lod_mesh.texcoords = mesh.texcoords;
+			lod_mesh.indices = mesh.indices;
+			lod_mesh.model_transform_matrix = mesh.transform_matrix;
+
+			mesh_generate_lods(lod_mesh);
+			mesh_calculate_tangents(lod_mesh);
+			mesh_calculate_bounds(lod_mesh);
+
+			const char* material_name = (mesh.material_index == u32_max) ? "" : model_info.materials[mesh.material_index].name.c_str();
+
+			char meshpath[FILEPATH_SIZE + 1u];
+			sprintf(meshpath, "%s%s.mesh", folderpath, mesh.name.c_str());
+
+			if (!write_mesh_file(lod_mesh, material_name, meshpath, model_info.compress_meshes)) {
+				SV_LOG_ERROR("Can't save the mesh '%s'", meshpath);
+				return false;
+			}
+			else {
+				SV_LOG_INFO("Mesh imported '%s'", meshpath);
+			}
+		}
+
+		// Creating material files
+
+		for (const MaterialInfo& mat : model_info.materials) {
+
+			if (!mat.import)
+				continue;
+
+			size_t matpath_size = folderpath_size + mat.name.size() + strlen(".mat");
+			if (matpath_size >= FILEPATH_SIZE) {
+				SV_LOG_ERROR("This filepath is too large '%s'", filepath);
+				return false;
+			}
+	    
+			serialize_begin(s);
+
+			serialize_u32(s, 1u); // VERSION
+
+			// Renderer settings
+			{
+				serialize_bool(s, mat.transparent);
+				serialize_u32(s, mat.culling);
+			}
+
+			serialize_color(s, mat.ambient_color);
+			serialize_color(s, mat.diffuse_color);
+			serialize_color(s, mat.specular_color);
+			serialize_color(s, mat.emissive_color);
+			serialize_f32(s, mat.shininess);
+
+			import_texture(s, mat.diffuse_map_path.c_str(), folderpath, model_info.folderpath);
+			import_texture(s, mat.normal_map_path.c_str(), folderpath, model_info.folderpath);
+			import_texture(s, mat.specular_map_path.c_str(), folderpath, model_info.folderpath);
+			import_texture(s, mat.emissive_map_path.c_str(), folderpath, model_info.folderpath);
+
+			char matpath[FILEPATH_SIZE + 1u];
+			sprintf(matpath, "%s%s.mat", folderpath, mat.name.c_str());
+
+			if (!serialize_end(s, matpath)) {
+				SV_LOG_ERROR("Can't save the material '%s'", matpath);
+				return false;
+			}
+			else {
+				SV_LOG_INFO("Material imported '%s'", matpath);
+			}	    
+		}
+	
+		return true;
+    }
+
+	bool save_mesh(const Mesh& mesh, const char* filepath, bool compress)
+	{
+		// The file only stores the material name, the folder is the same as the mesh
+		char material_name[FILEPATH_SIZE + 1u];
+		string_copy(material_name, filepath_name(mesh.model_material_filepath), FILEPATH_SIZE + 1u);
+
+		char* extension = filepath_extension(material_name);
+		if (extension) *extension = '\0';
+
+		if (!write_mesh_file(mesh, material_name, filepath, compress)) {
+			SV_LOG_ERROR("Can't save the mesh '%s'", filepath);
+			return false;
+		}
+		else SV_LOG_INFO("Mesh saved at '%s'", filepath);
+
+		return true;
+	}
+	
+    bool save_material(const Material& mat, const char* filepath)
+	{
+		Serializer s;
+		serialize_begin(s);
+
+		serialize_u32(s, 1u); // VERSION
+
+		// Renderer settings
+		{
+			serialize_bool(s, mat.transparent);
+			serialize_u32(s, mat.culling);
+		}
+
+		serialize_color(s, mat.ambient_color);
+		serialize_color(s, mat.diffuse_color);
+		serialize_color(s, mat.specular_color);
+		serialize_color(s, mat.emissive_color);
+		serialize_f32(s, mat.shininess);
+
+		serialize_string(s, string_validate(mat.diffuse_map.get_filepath()));
+		serialize_string(s, string_validate(mat.normal_map.get_filepath()));
+		serialize_string(s, string_validate(mat.specular_map.get_filepath()));
+		serialize_string(s, string_validate(mat.emissive_map.get_filepath()));
+
+		if (!serialize_end(s, filepath)) {
+			SV_LOG_ERROR("Can't save the material '%s'", filepath);
+			return false;
+		}
+		else {
+			SV_LOG_INFO("Material saved at '%s'", filepath);
+		}
+		return true;
+	}
+
+    bool load_mesh(Mesh& mesh, const char* filepath)
+    {
+		MeshFile file;
+
+		if (mesh_file_open(file, filepath)) {
+
+			read_mesh_file(mesh, file, filepath, true);
+			mesh_file_close(file);
+			return true;
+		}
+		
+		Deserializer d;
+
+		if (deserialize_begin_mapped(d, filepath)) {
+
+			u32 version;
+			deserialize_u32(d, version);
+
+			// The arrays are read as views and copied after validating the whole file
+			const u32* lod_indices = NULL;
+			const v3_f32* positions = NULL;
+			const v3_f32* normals = NULL;
+			const v2_f32* texcoords = NULL;
+			const u32* indices = NULL;
+			u32 lod_index_count = 0u;
+			u32 position_count = 0u;
+			u32 normal_count = 0u;
+			u32 texcoord_count = 0u;
+			u32 index_count = 0u;
+
+			bool res = true;
+
+			if (version >= 2u) {
+
+				deserialize_u32(d, mesh.lod_count);
+
+				if (mesh.lod_count > MESH_LOD_MAX) {
+					SV_LOG_ERROR("Mesh file '%s' has an invalid lod count", filepath);
+					deserialize_end(d);
+					return false;
+				}
+
+				foreach(i, mesh.lod_count) {
+
+					MeshLod& lod = mesh.lods[i];
+					deserialize_u32(d, lod.index_offset);
+					deserialize_u32(d, lod.index_count);
+					deserialize_u32(d, lod.vertex_count);
+					deserialize_f32(d, lod.screen_size);
+				}
+
+				res = deserialize_pod_array_view(d, lod_indices, lod_index_count);
+			}
+	    
+			res = res && deserialize_pod_array_view(d, positions, position_count);
+			res = res && deserialize_pod_array_view(d, normals, normal_count);
+			res = res && deserialize_pod_array_view(d, texcoords, texcoord_count);
+			res = res && deserialize_pod_array_view(d, indices, index_count);
+
+			if (!res) {
+				SV_LOG_ERROR("Mesh file '%s' is truncated", filepath);
+				deserialize_end(d);
+				mesh_clear(mesh);
+				return false;
+			}
+
+			bool valid = (normal_count == 0u || normal_count == position_count) && (texcoord_count == 0u || texcoord_count == position_count);
+
+			foreach(i, mesh.lod_count) {
+
+				const MeshLod& lod = mesh.lods[i];
+				valid = valid && u64(lod.index_offset) + lod.index_count <= u64(lod_index_count) + index_count;
+			}
+
+			// The views can be unaligned
+			u32 max_index = 0u;
+			u32 index;
+
+			foreach(i, lod_index_count) {
+				memcpy(&index, lod_indices + i, sizeof(u32));
+				max_index = SV_MAX(max_index, index);
+			}
+			foreach(i, index_count) {
+				memcpy(&index, indices + i, sizeof(u32));
+				max_index = SV_MAX(max_index, index);
+			}
+
+			valid = valid && (lod_index_count + index_count == 0u || max_index < position_count);
+
+			if (!valid) {
+				SV_LOG_ERROR("Invalid mesh file '%s'", filepath);
+				deserialize_end(d);
+				mesh_clear(mesh);
+				return false;
+			}
+
+			deserialize_pod_array_copy(mesh.lod_indices, lod_indices, lod_index_count);
+			deserialize_pod_array_copy(mesh.positions, positions, position_count);
+			deserialize_pod_array_copy(mesh.normals, normals, normal_count);
+			deserialize_pod_array_copy(mesh.texcoords, texcoords, texcoord_count);
+			deserialize_pod_array_copy(mesh.indices, indices, index_count);
+
+			char matname[FILEPATH_SIZE + 1u];
+			deserialize_string(d, matname, FILEPATH_SIZE + 1u);
+
+			set_mesh_material_filepath(mesh, filepath, matname);
+
+			if (version != 0) {
+				deserialize_xmmatrix(d, mesh.model_transform_matrix);
+			}
+	    
+			deserialize_end(d);
+		}
+		else {
+			SV_LOG_ERROR("Mesh file '%s', not found", filepath);
+			return false;
+		}
+
+		mesh_calculate_tangents(mesh);
+		mesh_calculate_bounds(mesh);
+	
+		return true;
+    }
+
+	struct MeshBenchmarkFile {
+		char filepath[FILEPATH_SIZE + 1u];
+	};
+
+	SV_AUX void mesh_collect_files(const char* folder, List<MeshBenchmarkFile>& files)
+	{
+		FolderIterator it;
+		FolderElement e;
+
+		if (folder_iterator_begin(folder, &it, &e)) {
+
+			do {
+
+				if (string_equals(e.name, ".") || string_equals(e.name, "..")) continue;
+
+				char filepath[FILEPATH_SIZE + 1u];
+				string_copy(filepath, folder, FILEPATH_SIZE + 1u);
+				
+				size_t size = string_size(filepath);
+				if (size && filepath[size - 1u] != '/') string_append(filepath, "/", FILEPATH_SIZE + 1u);
+				string_append(filepath, e.name, FILEPATH_SIZE + 1u);
+
+				if (e.is_file) {
+
+					if (e.extension && string_equals(e.extension, "mesh")) {
+						
+						MeshBenchmarkFile& file = files.emplace_back();
+						string_copy(file.filepath, filepath, FILEPATH_SIZE + 1u);
+					}
+				}
+				else mesh_collect_files(filepath, files);
+			}
+			while (folder_iterator_next(&it, &e));
+
+			folder_iterator_close(&it);
+		}
+	}
+
+	bool mesh_load_benchmark(const char* folderpath)
+	{
+		List<MeshBenchmarkFile> files;
+		mesh_collect_files(folderpath, files);
+
+		if (files.empty()) {
+			SV_LOG_ERROR("There are no meshes in '%s'", folderpath);
+			return false;
+		}
+
+		// Each mesh is written in both formats and loaded from the same place
+		const char* legacy_path = "bin/mesh_benchmark_legacy.mesh";
+		const char* binary_path = "bin/mesh_benchmark_binary.mesh";
+
+		f64 legacy_time = 0.0;
+		f64 binary_time = 0.0;
+		u64 legacy_bytes = 0u;
+		u64 binary_bytes = 0u;
+		u32 count = 0u;
+
+		for (const MeshBenchmarkFile& file : files) {
+
+			{
+				Mesh mesh;
+				if (!load_mesh(mesh, file.filepath))
+					continue;
+
+				Serializer s;
+				serialize_begin(s);
+				serialize_mesh(s, mesh, "");
+				legacy_bytes += s.buff.size();
+
+				if (!serialize_end(s, legacy_path) || !write_mesh_file(mesh, "", binary_path)) {
+					SV_LOG_ERROR("Can't write the benchmark files");
+					return false;
+				}
+			}
+
+			// Legacy: deserialize the arrays, compute the tangents and interleave the vertices
+			{
+				Mesh mesh;
+				f64 begin = timer_now();
+				
+				bool res = load_mesh(mesh, legacy_path) && mesh_create_buffers(mesh);
+				
+				legacy_time += timer_now() - begin;
+				mesh_clear(mesh);
+
+				if (!res) continue;
+			}
+
+			// Binary: map the file and copy the blobs to the GPU
+			{
+				Mesh mesh;
+				MeshFile mesh_file;
+				f64 begin = timer_now();
+
+				bool res = mesh_file_open(mesh_file, binary_path);
+				if (res) {
+					res = mesh_create_from_file(mesh, mesh_file, binary_path, false);
+					binary_bytes += mesh_file.mapping.size;
+					mesh_file_close(mesh_file);
+				}
+				
+				binary_time += timer_now() - begin;
+				mesh_clear(mesh);
+
+				if (!res) continue;
+			}
+
+			++count;
+		}
+
+		file_remove(legacy_path);
+		file_remove(binary_path);
+
+		SV_LOG_INFO("Mesh load benchmark '%s', %u meshes", folderpath, count);
+		SV_LOG_INFO("Legacy: %zu bytes, %.2f ms", size_t(legacy_bytes), f32(legacy_time * 1000.0));
+		SV_LOG_INFO("Binary: %zu bytes, %.2f ms", size_t(binary_bytes), f32(binary_time * 1000.0));
+
+		return true;
+	}
+
+	// The text parsers before the SSE2 scanner: byte by byte line split and the token copied to call atof
+	SV_AUX size_t legacy_line_size(const char* str)
+	{
+		const char* it = str;
+		while (*it != '\0' && *it != '\n') ++it;
+		return it - str;
+	}
+
+	SV_AUX f32 legacy_read_f32(const char* token)
+	{
+		char value_str[20u];
+		size_t size = SV_MIN(string_split(token, " \r\n", 3u), sizeof(value_str) - 1u);
+		memcpy(value_str, token, size);
+		value_str[size] = '\0';
+		return (f32)atof(value_str);
+	}
+
+	template<typename T>
+	SV_AUX bool list_bytes_equal(const List<T>& a, const List<T>& b)
+	{
+		return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+	}
+
+	SV_AUX bool model_info_equals(const ModelInfo& a, const ModelInfo& b)
+	{
+		if (a.meshes.size() != b.meshes.size() || a.materials.size() != b.materials.size())
+			return false;
+
+		foreach(i, a.meshes.size()) {
+
+			const MeshInfo& m0 = a.meshes[i];
+			const MeshInfo& m1 = b.meshes[i];
+
+			if (!string_equals(string_validate(m0.name.c_str()), string_validate(m1.name.c_str()))
+				|| m0.material_index != m1.material_index
+				|| !list_bytes_equal(m0.positions, m1.positions)
+				|| !list_bytes_equal(m0.normals, m1.normals)
+				|| !list_bytes_equal(m0.texcoords, m1.texcoords)
+				|| !list_bytes_equal(m0.indices, m1.indices)
+				|| memcmp(&m0.transform_matrix, &m1.transform_matrix, sizeof(XMMATRIX)) != 0)
+				return false;
+		}
+
+		foreach(i, a.materials.size()) {
+
+			if (!string_equals(string_validate(a.materials[i].name.c_str()), string_validate(b.materials[i].name.c_str())))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool model_load_benchmark(const char* filepath)
+	{
+		String file;
+
+		if (!file_read_text(filepath, file)) {
+			SV_LOG_ERROR("Can't read the file '%s'", filepath);
+			return false;
+		}
+
+		constexpr f64 MB = 1024.0 * 1024.0;
+		const char* text = file.c_str();
+
+		// Line scanning
+		u32 legacy_lines = 0u;
+		f64 begin = timer_now();
+
+		for (const char* it = text; *it != '\0'; ++legacy_lines) {
+			it += legacy_line_size(it);
+			if (*it == '\n') ++it;
+		}
+
+		f64 legacy_scan_time = timer_now() - begin;
+
+		LineProcessor p;
+		begin = timer_now();
+
+		line_begin(p, text);
+		while (line_next(p));
+
+		f64 scan_time = timer_now() - begin;
+
+		if (p.line_count != legacy_lines) {
+			SV_LOG_ERROR("The line count doesn't match: %u, expected %u", p.line_count, legacy_lines);
+			return false;
+		}
+
+		// Number parsing of the vertex lines
+		List<const char*> tokens;
+		line_begin(p, text);
+
+		while (line_next(p)) {
+
+			const char* line = p.line;
+			if (*line++ != 'v') continue;
+			if (*line == 'n' || *line == 't') ++line;
+
+			while (1) {
+				line_jump_spaces(line);
+				if (*line == '\0' || *line == '\n' || *line == '\r') break;
+
+				tokens.push_back(line);
+				line += string_split(line, " \r\n", 3u);
+			}
+		}
+
+		List<f32> legacy_values;
+		List<f32> values;
+		legacy_values.resize(tokens.size());
+		values.resize(tokens.size());
+
+		begin = timer_now();
+
+		foreach(i, tokens.size())
+			legacy_values[i] = legacy_read_f32(tokens[i]);
+
+		f64 legacy_parse_time = timer_now() - begin;
+		begin = timer_now();
+
+		foreach(i, tokens.size()) {
+			const char* token = tokens[i];
+			if (!line_read_f32(token, values[i])) values[i] = 0.f;
+		}
+
+		f64 parse_time = timer_now() - begin;
+
+		// The legacy values are rounded twice (to f64 and to f32), strtof is the correctly rounded reference
+		u32 mismatches = 0u;
+		u32 legacy_mismatches = 0u;
+
+		foreach(i, tokens.size()) {
+			
+			f32 ref = strtof(tokens[i], nullptr);
+			if (memcmp(&ref, &values[i], sizeof(f32)) != 0) ++mismatches;
+			if (memcmp(&ref, &legacy_values[i], sizeof(f32)) != 0) ++legacy_mismatches;
+		}
+
+		// Full import, the parallel importer must produce the same data as the serial one
+		ModelInfo serial_info;
+		begin = timer_now();
+
+		bool serial_res = model_info_begin(filepath, serial_info) && load_obj_serial(filepath, serial_info);
+
+		f64 serial_time = timer_now() - begin;
+
+		ModelInfo model_info;
+		begin = timer_now();
+
+		bool res = load_model(filepath, model_info);
+
+		f64 load_time = timer_now() - begin;
+
+		SV_LOG_INFO("Model load benchmark '%s': %.2f MB, %u lines, %zu numbers", filepath, f32(f64(file.size()) / MB), legacy_lines, tokens.size());
+		SV_LOG_INFO("Line scan: legacy %.2f ms, SSE2 %.2f ms", f32(legacy_scan_time * 1000.0), f32(scan_time * 1000.0));
+		SV_LOG_INFO("Float parse: legacy %.2f ms (%u not correctly rounded), fast %.2f ms (%u not correctly rounded)", f32(legacy_parse_time * 1000.0), legacy_mismatches, f32(parse_time * 1000.0), mismatches);
+
+		if (!res || !serial_res) {
+			SV_LOG_ERROR("Can't load the model '%s'", filepath);
+			return false;
+		}
+
+		SV_LOG_INFO("load_model: serial %.2f ms, parallel %.2f ms, %zu meshes", f32(serial_time * 1000.0), f32(load_time * 1000.0), model_info.meshes.size());
+
+		if (!model_info_equals(serial_info, model_info)) {
+			SV_LOG_ERROR("The parallel importer doesn't match the serial importer");
+			return false;
+		}
+
+		return mismatches == 0u;
+	}
+
+    bool read_material(MaterialFile& file, Deserializer& d)
+    {
+		Material& mat = file.material;
+		
+		u32 version;
+		deserialize_u32(d, version);
+
+		if (version != 0u) {
+			deserialize_bool(d, mat.transparent);
+			deserialize_u32(d, (u32&)mat.culling);
+		}
+
+		deserialize_color(d, mat.ambient_color);
+		deserialize_color(d, mat.diffuse_color);
+		deserialize_color(d, mat.specular_color);
+		deserialize_color(d, mat.emissive_color);
+		deserialize_f32(d, mat.shininess);
+
+		// TODO: Check errors
+		deserialize_string(d, file.diffuse_map, FILEPATH_SIZE + 1u);
+		deserialize_string(d, file.normal_map, FILEPATH_SIZE + 1u);
+		deserialize_string(d, file.specular_map, FILEPATH_SIZE + 1u);
+		deserialize_string(d, file.emissive_map, FILEPATH_SIZE + 1u);
+
+		return true;
+    }
+
+    void load_material_textures(Material& mat, const MaterialFile& file, AssetLoadingPriority priority)
+    {
+		if (file.diffuse_map[0]) load_asset_from_file(mat.diffuse_map, file.diffuse_map, priority);
+		if (file.normal_map[0]) load_asset_from_file(mat.normal_map, file.normal_map, priority);
+		if (file.specular_map[0]) load_asset_from_file(mat.specular_map, file.specular_map, priority);
+		if (file.emissive_map[0]) load_asset_from_file(mat.emissive_map, file.emissive_map, priority);
+    }
+
+    bool load_material(Material& mat, Deserializer& d)
+    {
+		MaterialFile file;
+		SV_CHECK(read_material(file, d));
+
+		mat = file.material;
+		load_material_textures(mat, file, AssetLoadingPriority_RightNow);
+		
+		return true;
+    }
+
+    bool load_material(Material& mat, const char* filepath)
+    {
+		Deserializer d;
+
+		if (deserialize_begin(d, filepath)) {
+
+			bool res = load_material(mat, d);
 			deserialize_end(d);
+			return res;
 		}
 		else {
 			SV_LOG_ERROR("Mesh file '%s', not found", filepath);
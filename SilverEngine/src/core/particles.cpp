@@ -92,7 +92,7 @@ namespace sv {
 				if (version >= 4)
 					deserialize_bool(s, e.show);
 			
-				deserialize_asset(s, e.texture);
+				deserialize_asset(s, e.texture, AssetLoadingPriority_KeepItLoading);
 				deserialize_v4_f32(s, e.texcoord);
 
 				if (version >= 4) {
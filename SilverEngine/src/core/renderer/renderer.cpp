@@ -871,6 +871,8 @@ namespace sv {
 		XMMATRIX world_matrix;
 		Mesh* mesh;
 		Material* material;
+		u32 index_offset;
+		u32 index_count;
 
     };
 
@@ -1210,6 +1212,29 @@ namespace sv {
 		graphics_buffer_update(gfx.cbuffer_material, GPUBufferState_Constant, &material_data, sizeof(GPU_MaterialData), 0u, cmd);
 	}
 
+	// Size of the bounding sphere relative to the screen height
+	SV_AUX f32 mesh_projected_size(const Mesh& mesh, const XMMATRIX& world_matrix, const CameraComponent& camera)
+	{
+		f32 scale = XMVectorGetX(XMVector3Length(world_matrix.r[0]));
+		scale = SV_MAX(scale, XMVectorGetX(XMVector3Length(world_matrix.r[1])));
+		scale = SV_MAX(scale, XMVectorGetX(XMVector3Length(world_matrix.r[2])));
+
+		f32 diameter = mesh.bounds_radius * scale * 2.f;
+
+		if (camera.projection_type == ProjectionType_Perspective) {
+
+			XMVECTOR center = XMVector3Transform(vec3_to_dx(mesh.bounds_center), world_matrix);
+			f32 depth = XMVectorGetZ(XMVector3Transform(center, camera.view_matrix));
+
+			if (depth - diameter * 0.5f <= camera.near)
+				return f32_max;
+
+			return (diameter * camera.near) / (depth * camera.height);
+		}
+
+		return diameter / camera.height;
+	}
+
 	static void draw_scene(CameraComponent& camera, v3_f32 camera_position, v4_f32 camera_rotation)
 	{
 		auto& gfx = renderer->gfx;
@@ -1450,7 +1475,7 @@ namespace sv {
 					Entity entity = it.entity;
 						
 					Mesh* m = mesh.mesh.get();
-					if (m == nullptr || m->vbuffer == nullptr || m->ibuffer == nullptr) continue;
+					if (m == nullptr || !mesh_is_resident(*m)) continue;
 						
 					//XMMATRIX tm = get_entity_world_matrix(entity);
 						
@@ -1458,6 +1483,17 @@ namespace sv {
 					inst.world_matrix = get_entity_world_matrix(entity);
 					inst.mesh = m;
 					inst.material = mesh.material.get();
+
+					if (m->lod_count > 1u) {
+
+						u32 lod = mesh_select_lod(*m, mesh_projected_size(*m, inst.world_matrix, camera));
+						inst.index_offset = m->lods[lod].index_offset;
+						inst.index_count = m->lods[lod].index_count;
+					}
+					else {
+						inst.index_offset = m->index_offset;
+						inst.index_count = m->index_count;
+					}
 				}
 			}
 
@@ -1595,7 +1631,7 @@ namespace sv {
 								graphics_vertex_buffer_bind(mesh.mesh->vbuffer, 0u, 0u, cmd);
 								graphics_index_buffer_bind(mesh.mesh->ibuffer, 0u, cmd);
 
-								graphics_draw_indexed(u32(mesh.mesh->indices.size()), 1u, 0u, 0u, 0u, cmd);
+								graphics_draw_indexed(mesh.index_count, 1u, mesh.index_offset, 0u, 0u, cmd);
 							}
 						
 							graphics_renderpass_end(cmd);
@@ -1724,7 +1760,7 @@ namespace sv {
 								graphics_buffer_update(instance_buffer, GPUBufferState_Constant, &data, sizeof(GPU_MeshInstanceData), 0u, cmd);
 							}
 
-							graphics_draw_indexed(u32(inst.mesh->indices.size()), 1u, 0u, 0u, 0u, cmd);
+							graphics_draw_indexed(inst.index_count, 1u, inst.index_offset, 0u, 0u, cmd);
 						}
 
 						graphics_event_end(cmd);
@@ -105,6 +105,8 @@ namespace sv {
 		DeserializeComponentFn deserialize_fn;
 		Library                library;
 		char		           struct_name[COMPONENT_NAME_SIZE + 1u];
+		bool                   parallel_deserialize;
+		bool                   snapshot_copy;
 
     };
 	
@@ -120,7 +122,7 @@ namespace sv {
 		List<Entity>     entity_free_list;
 		
 		List<PrefabInternal> prefabs;
-		ThickHashTable<Prefab, 100> prefab_table;
+		HashMap<const char*, Prefab> prefab_table;
 		u32                  prefab_free_count = 0u;
 
 		TagInternal tags[TAG_MAX];
@@ -141,7 +143,7 @@ namespace sv {
 
     struct SceneState {
 
-		static constexpr u32 VERSION = 4u;
+		static constexpr u32 VERSION = 5u;
 
 		char next_scene_name[SCENE_NAME_SIZE + 1u] = {};
 		Scene* scene = nullptr;
@@ -262,6 +264,67 @@ namespace sv {
 		deserialize_u32(d, entity);
     }
 
+	// The files are saved in '<filepath>.tmp' and renamed when everything is written
+
+	SV_AUX bool temp_save_filepath(char* dst, const char* filepath)
+	{
+		if (string_size(filepath) + 4u > FILEPATH_SIZE) {
+			SV_LOG_ERROR("The filepath '%s' is too long", filepath);
+			return false;
+		}
+
+		string_copy(dst, filepath, FILEPATH_SIZE + 1u);
+		string_append(dst, ".tmp", FILEPATH_SIZE + 1u);
+		return true;
+	}
+
+	SV_AUX bool temp_save_commit(bool res, const char* temp_filepath, const char* filepath)
+	{
+		if (res && file_rename(temp_filepath, filepath))
+			return true;
+
+		SV_LOG_ERROR("Can't save '%s'", filepath);
+		file_remove(temp_filepath);
+		return false;
+	}
+
+	// The asset dependencies are serialized at the end of the file, the offset is saved at the beginning
+
+	SV_AUX size_t serialize_dependencies_begin(Serializer& s)
+	{
+		size_t pos = serialize_size(s);
+		serialize_u64(s, 0u);
+
+		asset_dependencies_record_begin();
+		return pos;
+	}
+
+	SV_AUX void serialize_dependencies_end(Serializer& s, size_t pos)
+	{
+		u64 offset = u64(serialize_size(s));
+		asset_dependencies_record_end(s);
+
+		serialize_patch(s, pos, &offset, sizeof(u64));
+	}
+
+	SV_AUX void prefetch_dependencies(Deserializer& d, const char* name)
+	{
+		u64 offset;
+		deserialize_u64(d, offset);
+
+		if (offset == 0u || offset >= d.buff.size()) {
+			SV_LOG_ERROR("Invalid dependency table in '%s'", name);
+			return;
+		}
+
+		size_t pos = d.pos;
+		d.pos = size_t(offset);
+
+		asset_dependencies_prefetch(d, name);
+
+		d.pos = pos;
+	}
+
     bool _start_scene(const char* name_)
     {
 		Scene*& scene_ptr = scene_state->scene;
@@ -294,7 +357,7 @@ namespace sv {
 			string_append(filepath, name, FILEPATH_SIZE + 1u);
 			string_append(filepath, ".scene", FILEPATH_SIZE + 1u);
 
-			bool res = deserialize_begin(d, filepath);
+			bool res = deserialize_begin_mapped(d, filepath);
 
 			if (!res) {
 
@@ -303,6 +366,11 @@ namespace sv {
 			else {
 				u32 scene_version;
 				deserialize_u32(d, scene_version);
+
+				// Start loading all the assets before deserializing the entities
+				if (scene_version >= 5u) {
+					prefetch_dependencies(d, filepath);
+				}
 		    
 				deserialize_entity(d, scene.data.main_camera);
 
@@ -396,19 +464,32 @@ namespace sv {
 		string_append(filepath, scene.name, FILEPATH_SIZE + 1u);
 		string_append(filepath, ".scene", FILEPATH_SIZE + 1u);
 		
-		return save_scene(filepath);
+		return save_scene(filepath, file_is_compressed(filepath));
     }
 
-    bool save_scene(const char* filepath)
+    bool save_scene(const char* filepath, bool compress)
     {
 		SV_SCENE();
 	    
+		// Streamed to keep the memory constant with big scenes, the compressed ones are written in memory.
+		// Written to a temporal file, a failed save doesn't destroy the last one
+		char temp_filepath[FILEPATH_SIZE + 1u];
+		if (!temp_save_filepath(temp_filepath, filepath))
+			return false;
+		
 		Serializer s;
 
-		serialize_begin(s);
+		if (compress) {
+			serialize_begin(s);
+			s.compress = true;
+		}
+		else if (!serialize_begin_stream(s, temp_filepath, true))
+			return false;
 
 		serialize_u32(s, SceneState::VERSION);
 
+		size_t dependencies_pos = serialize_dependencies_begin(s);
+
 		serialize_entity(s, scene.data.main_camera);
 
 		// Skybox
@@ -420,9 +501,11 @@ namespace sv {
 
 		serialize_ecs(s);
 
+		serialize_dependencies_end(s, dependencies_pos);
+
 		event_dispatch("save_scene", nullptr);
 		
-		return serialize_end(s, filepath);
+		return temp_save_commit(serialize_end(s, temp_filepath), temp_filepath, filepath);
     }
 
     bool clear_scene()
@@ -462,9 +545,10 @@ namespace sv {
 
 					MeshAsset mesh;
 
-					bool res = load_asset_from_file(mesh, filepath);
+					// The matrix and the material are read from the mesh, the asynchronous load can't be used
+					bool res = load_asset_from_file(mesh, filepath, AssetLoadingPriority_RightNow);
 
-					if (res) {
+					if (res && mesh.get()) {
 					
 						Entity entity = create_entity(parent);
 						MeshComponent* comp = (MeshComponent*)add_entity_component(entity, mesh_id);
@@ -722,6 +806,49 @@ namespace sv {
 		return pool.count < pool.capacity || pool.free_count;
 	}
 
+	SV_AUX ComponentPool* add_component_pool(CompID comp_id, u32 capacity)
+	{
+		SV_ECS();
+
+		ComponentRegister& reg = scene_state->component_register[comp_id];
+		ComponentAllocator& alloc = ecs.component_allocator[comp_id];
+		
+		ComponentPool* new_pools = (ComponentPool*) SV_ALLOCATE_MEMORY(sizeof(ComponentPool) * (alloc.pool_count + 1), "Scene");
+
+		if (alloc.pools) {
+			memcpy(new_pools, alloc.pools, sizeof(ComponentPool) * alloc.pool_count);
+			SV_FREE_MEMORY(alloc.pools);
+		}
+
+		alloc.pools = new_pools;
+		ComponentPool* pool = alloc.pools + alloc.pool_count++;
+
+		pool->count = 0u;
+		pool->capacity = capacity;
+		pool->free_count = 0u;
+		pool->data = (u8*)SV_ALLOCATE_MEMORY(reg.size * pool->capacity, "Scene");
+
+		return pool;
+	}
+
+	// The deserialized blocks are constructed in one pool instead of growing by small pools
+	SV_AUX void reserve_components(CompID comp_id, u32 count)
+	{
+		SV_ECS();
+
+		ComponentAllocator& alloc = ecs.component_allocator[comp_id];
+		u32 available = 0u;
+
+		foreach(i, alloc.pool_count) {
+
+			const ComponentPool& pool = alloc.pools[i];
+			available += pool.capacity - pool.count + pool.free_count;
+		}
+
+		if (available < count)
+			add_component_pool(comp_id, count - available);
+	}
+
 	SV_AUX Component* allocate_component(CompID comp_id)
 	{
 		SV_ECS();
@@ -741,21 +868,7 @@ namespace sv {
 		}
 
 		if (pool == NULL) {
-
-			ComponentPool* new_pools = (ComponentPool*) SV_ALLOCATE_MEMORY(sizeof(ComponentPool) * (alloc.pool_count + 1), "Scene");
-
-			if (alloc.pools) {
-				memcpy(new_pools, alloc.pools, sizeof(ComponentPool) * alloc.pool_count);
-				SV_FREE_MEMORY(alloc.pools);
-			}
-
-			alloc.pools = new_pools;
-			pool = alloc.pools + alloc.pool_count++;
-
-			pool->count = 0u;
-			pool->capacity = 3u;
-			pool->free_count = 0u;
-			pool->data = (u8*)SV_ALLOCATE_MEMORY(reg.size * pool->capacity, "Scene");
+			pool = add_component_pool(comp_id, 3u);
 		}
 
 		Component* component = NULL;
@@ -940,10 +1053,226 @@ namespace sv {
 		e.dirty_physics = true;
 	}
 
+	// Scene strings written once and referenced by index: component names, tag names and prefab filepaths
+	struct SceneStringTable {
+		HashMap<const char*, u32> indices;
+		List<const char*>         strings;
+	};
+
+	SV_AUX u32 intern_string(SceneStringTable& table, const char* str)
+	{
+		u32* index = table.indices.find(str);
+		if (index) return *index;
+
+		u32 i = u32(table.strings.size());
+		table.indices[str] = i;
+		table.strings.push_back(str);
+		return i;
+	}
+
+	enum EntityTransformBit : u8 {
+		EntityTransformBit_Position = SV_BIT(0),
+		EntityTransformBit_Rotation = SV_BIT(1),
+		EntityTransformBit_Scale = SV_BIT(2),
+	};
+
+	struct PrefabOverride {
+		Entity     entity;
+		CompID     comp_id;
+		Component* comp;
+	};
+
+	// Version 3: string table, varints and a block per component type with the entities first.
+	// The entities are written in hierarchy order, the position is the hierarchy index.
+	// Version 4: the size of the component data is written after the entities, the blocks are deserialized in parallel
+	// Version 5: the entity components that override a prefab component are written after the blocks, the
+	// complete component with its size
 	void serialize_ecs(Serializer& s)
 	{
 		SV_ECS();
 
+		constexpr u32 VERSION = 5u;
+		serialize_u32(s, VERSION);
+
+		SceneStringTable table;
+
+		// String table
+		{
+			foreach(id, scene_state->component_register_count)
+				intern_string(table, get_component_name(id));
+
+			foreach(tag, TAG_MAX) {
+				if (scene_state->tag_register[tag].name[0])
+					intern_string(table, scene_state->tag_register[tag].name);
+			}
+
+			foreach(i, ecs.prefabs.size()) {
+				if (ecs.prefabs[i].valid)
+					intern_string(table, ecs.prefabs[i].filepath);
+			}
+
+			serialize_varint(s, table.strings.size());
+
+			for (const char* str : table.strings)
+				serialize_string(s, str);
+		}
+		
+		// Registers
+		{
+			serialize_varint(s, scene_state->component_register_count);
+
+			foreach(id, scene_state->component_register_count) {
+
+				serialize_varint(s, intern_string(table, get_component_name(id)));
+				serialize_varint(s, get_component_size(id));
+				serialize_varint(s, get_component_version(id));
+			}
+
+			u32 tag_count = 0u;
+			
+			foreach(tag, TAG_MAX) {
+				if (scene_state->tag_register[tag].name[0])
+					++tag_count;
+			}
+
+			serialize_varint(s, tag_count);
+
+			foreach(tag, TAG_MAX) {
+				if (scene_state->tag_register[tag].name[0]) {
+					serialize_varint(s, tag);
+					serialize_varint(s, intern_string(table, scene_state->tag_register[tag].name));
+				}
+			}
+		}
+
+		// Prefabs
+		{
+			serialize_varint(s, (u32)ecs.prefabs.size() - ecs.prefab_free_count);
+				
+			foreach(i, ecs.prefabs.size()) {
+
+				if (ecs.prefabs[i].valid) {
+				
+					serialize_varint(s, i + 1u);
+					serialize_varint(s, intern_string(table, ecs.prefabs[i].filepath));
+				}
+			}
+		}
+
+		// Entity data
+		{
+			u32 entity_count = u32(ecs.entity_hierarchy.size());
+
+			serialize_varint(s, entity_count);
+			serialize_varint(s, ecs.entity_size);
+
+			foreach(i, entity_count) {
+
+				Entity entity = ecs.entity_hierarchy[i];
+				
+				const EntityInternal& internal = ecs.entity_internal[entity - 1u];
+				const EntityMisc& misc = ecs.entity_misc[entity - 1u];
+				const EntityTransform& transform = ecs.entity_transform[entity - 1u];
+
+				serialize_varint(s, entity);
+				serialize_varint(s, internal.child_count);
+				serialize_varint(s, internal.prefab);
+				serialize_varint(s, internal.tag_mask);
+				serialize_varint(s, misc.flags);
+				serialize_string(s, misc.name);
+
+				// Only the values that differ from the default transform
+				const v3_f32& p = transform.position;
+				const v4_f32& r = transform.rotation;
+				const v3_f32& sc = transform.scale;
+				
+				u8 mask = 0u;
+				if (p.x != 0.f || p.y != 0.f || p.z != 0.f) mask |= EntityTransformBit_Position;
+				if (r.x != 0.f || r.y != 0.f || r.z != 0.f || r.w != 1.f) mask |= EntityTransformBit_Rotation;
+				if (sc.x != 1.f || sc.y != 1.f || sc.z != 1.f) mask |= EntityTransformBit_Scale;
+
+				serialize_u8(s, mask);
+				if (mask & EntityTransformBit_Position) serialize_v3_f32(s, p);
+				if (mask & EntityTransformBit_Rotation) serialize_v4_f32(s, r);
+				if (mask & EntityTransformBit_Scale) serialize_v3_f32(s, sc);
+			}
+		}
+
+		// Components
+		List<PrefabOverride> overrides;
+		
+		{
+			List<Entity> entities;
+			List<Component*> components;
+			
+			foreach(id, scene_state->component_register_count) {
+
+				entities.reset();
+				components.reset();
+
+				for (CompIt it = comp_it_begin(id, CompItFlag_Once);
+					 it.has_next;
+					 comp_it_next(it))
+				{
+					if (it.prefab != 0) continue;
+
+					Prefab prefab = ecs.entity_internal[it.entity - 1u].prefab;
+
+					if (prefab && has_prefab_component(prefab, id)) {
+						overrides.push_back({ it.entity, id, it.comp });
+					}
+					else {
+						entities.push_back(it.entity);
+						components.push_back(it.comp);
+					}
+				}
+
+				serialize_varint(s, entities.size());
+
+				// Delta encoded, the pools are usually sorted by entity
+				Entity last = 0u;
+
+				for (Entity entity : entities) {
+					serialize_varint_signed(s, i64(entity) - i64(last));
+					last = entity;
+				}
+
+				size_t size_pos = serialize_size(s);
+				serialize_u64(s, 0u);
+
+				foreach(i, components.size())
+					serialize_component(id, components[i], s);
+
+				u64 data_size = u64(serialize_size(s) - size_pos - sizeof(u64));
+				serialize_patch(s, size_pos, &data_size, sizeof(u64));
+			}
+		}
+
+		// Prefab overrides
+		{
+			serialize_varint(s, overrides.size());
+
+			for (const PrefabOverride& o : overrides) {
+
+				serialize_varint(s, o.entity);
+				serialize_varint(s, o.comp_id);
+
+				size_t size_pos = serialize_size(s);
+				serialize_u64(s, 0u);
+
+				serialize_component(o.comp_id, o.comp, s);
+
+				u64 data_size = u64(serialize_size(s) - size_pos - sizeof(u64));
+				serialize_patch(s, size_pos, &data_size, sizeof(u64));
+			}
+		}
+	}
+
+	// Version 2 writer, kept to compare the formats in scene_serialize_benchmark
+	SV_AUX void serialize_ecs_legacy(Serializer& s)
+	{
+		SV_ECS();
+
 		constexpr u32 VERSION = 2u;
 		serialize_u32(s, VERSION);
 		
@@ -1041,6 +1370,34 @@ namespace sv {
 		}
 	}
 
+	// Component data deserialized in a worker thread, the components are created in the main thread
+	struct ComponentBlock {
+		CompID             comp_id = INVALID_COMP_ID;
+		u32                version = 0u;
+		const u8*          data = NULL;
+		size_t             size = 0u;
+		List<Component*>   components;
+		List<AssetRequest> requests; // Executed in the main thread when all the blocks are finished
+		bool               failed = false;
+	};
+
+	SV_INTERNAL void component_block_task(void* data)
+	{
+		ComponentBlock& block = **reinterpret_cast<ComponentBlock**>(data);
+
+		asset_requests_bind(&block.requests);
+
+		Deserializer d;
+		deserialize_begin_view(d, block.data, block.size);
+
+		for (Component* comp : block.components)
+			deserialize_component(block.comp_id, comp, d, block.version);
+
+		block.failed = d.pos != block.size;
+
+		asset_requests_bind(NULL);
+	}
+
 	bool deserialize_ecs(Deserializer& d)
 	{
 		SV_ECS();
@@ -1048,7 +1405,7 @@ namespace sv {
 		u32 version;
 		deserialize_u32(d, version);
 
-		if (version <= 0) {
+		if (version <= 0 || version > 5u) {
 
 			SV_LOG_ERROR("ECS version %u not supported", version);
 			return false;
@@ -1069,8 +1426,72 @@ namespace sv {
 		// Registers
 		List<TempComponentRegister> component_registers;
 		List<TempTagRegister> tag_registers;
-		
-		{
+
+		// Views to the deserializer buffer
+		List<const char*> strings;
+
+		if (version >= 3u) {
+
+			u32 string_count = 0u;
+			
+			if (!deserialize_varint(d, string_count) || !deserialize_assert(d, string_count)) {
+				SV_LOG_ERROR("Invalid scene string table");
+				return false;
+			}
+
+			strings.resize(string_count);
+
+			foreach(i, string_count) {
+
+				size_t size = deserialize_string_size(d);
+
+				if (d.pos + size >= d.buff.size()) {
+					SV_LOG_ERROR("Invalid scene string table");
+					return false;
+				}
+
+				strings[i] = (const char*)(d.buff.data() + d.pos);
+				d.pos += size + 1u;
+			}
+
+			u32 register_count = 0u;
+			deserialize_varint(d, register_count);
+
+			foreach(i, register_count) {
+
+				TempComponentRegister& reg = component_registers.emplace_back();
+
+				u32 name;
+				deserialize_varint(d, name);
+				deserialize_varint(d, reg.size);
+				
+				if (!deserialize_varint(d, reg.version) || name >= string_count) {
+					SV_LOG_ERROR("Invalid component register");
+					return false;
+				}
+
+				string_copy(reg.name, strings[name], COMPONENT_NAME_SIZE + 1u);
+			}
+
+			u32 tag_count = 0u;
+			deserialize_varint(d, tag_count);
+
+			foreach(i, tag_count) {
+
+				TempTagRegister& reg = tag_registers.emplace_back();
+
+				u32 name;
+				deserialize_varint(d, reg.id);
+
+				if (!deserialize_varint(d, name) || name >= string_count || reg.id >= TAG_MAX) {
+					SV_LOG_ERROR("Invalid tag register");
+					return false;
+				}
+				
+				string_copy(reg.name, strings[name], TAG_NAME_SIZE + 1u);
+			}
+		}
+		else {
 			u32 register_count = 0u;
 			deserialize_u32(d, register_count);
 			
@@ -1117,208 +1538,831 @@ namespace sv {
 			Prefab current_prefab;
 		};
 		
-		List<PrefabRef> prefabs;
-		{
-			u32 prefab_count;
-			deserialize_u32(d, prefab_count);
+		List<PrefabRef> prefabs;
+		
+		if (version >= 3u) {
+
+			u32 prefab_count = 0u;
+			deserialize_varint(d, prefab_count);
+
+			foreach(i, prefab_count) {
+
+				PrefabRef ref;
+				u32 filepath;
+				
+				deserialize_varint(d, ref.old_prefab);
+
+				if (!deserialize_varint(d, filepath) || filepath >= strings.size()) {
+					SV_LOG_ERROR("Invalid prefab filepath");
+					return false;
+				}
+
+				ref.current_prefab = load_prefab(strings[filepath]);
+
+				if (ref.old_prefab && ref.current_prefab) {
+					prefabs.push_back(ref);
+				}
+			}
+		}
+		else {
+			u32 prefab_count;
+			deserialize_u32(d, prefab_count);
+
+			foreach(i, prefab_count) {
+
+				PrefabRef ref;
+				
+				deserialize_u32(d, ref.old_prefab);
+
+				if (ref.old_prefab) {
+					
+					char filepath[FILEPATH_SIZE + 1u];
+					deserialize_string(d, filepath, FILEPATH_SIZE + 1u);
+				
+					ref.current_prefab = load_prefab(filepath);
+
+					if (ref.current_prefab) {
+						prefabs.push_back(ref);
+					}
+				}
+			}
+		}
+
+		// Entity data
+		u32 entity_count = 0u;
+		u32 entity_data_count = 0u;
+
+		if (version >= 3u) {
+			deserialize_varint(d, entity_count);
+			deserialize_varint(d, entity_data_count);
+		}
+		else {
+			deserialize_u32(d, entity_count);
+			deserialize_u32(d, entity_data_count);
+		}
+
+		if (entity_count > entity_data_count || !deserialize_assert(d, entity_count)) {
+			SV_LOG_ERROR("Invalid entity count");
+			return false;
+		}
+
+		ecs.entity_hierarchy.resize(entity_count);
+		EntityInternal* entity_internal = (EntityInternal*)SV_ALLOCATE_MEMORY(sizeof(EntityInternal) * entity_data_count, "Scene");
+		EntityMisc* entity_misc = (EntityMisc*)SV_ALLOCATE_MEMORY(sizeof(EntityMisc) * entity_data_count, "Scene");
+		EntityTransform* entity_transform = (EntityTransform*)SV_ALLOCATE_MEMORY(sizeof(EntityTransform) * entity_data_count, "Scene");
+
+		foreach(i, entity_data_count) initialize_entity_internal(entity_internal[i]);
+		foreach(i, entity_data_count) initialize_entity_misc(entity_misc[i]);
+		foreach(i, entity_data_count) initialize_entity_transform(entity_transform[i]);
+
+		foreach(i, entity_count) {
+
+			Entity entity;
+
+			if (version >= 3u) {
+
+				u64 entity0;
+				deserialize_varint(d, entity0);
+				entity = Entity(entity0);
+
+				if (entity0 == 0u || entity0 > entity_data_count || entity_internal[entity - 1u].hierarchy_index != u32_max) {
+					
+					SV_LOG_ERROR("Invalid entity handle");
+					SV_FREE_MEMORY(entity_internal);
+					SV_FREE_MEMORY(entity_misc);
+					SV_FREE_MEMORY(entity_transform);
+					ecs.entity_hierarchy.clear();
+					return false;
+				}
+			}
+			else deserialize_entity(d, entity);
+
+			EntityInternal& internal = entity_internal[entity - 1u];
+			EntityMisc& misc = entity_misc[entity - 1u];
+			EntityTransform& transform = entity_transform[entity - 1u];
+
+			if (version >= 3u) {
+
+				internal.hierarchy_index = i;
+				deserialize_varint(d, internal.child_count);
+
+				// The childs are the next entities in the hierarchy
+				if (u64(i) + u64(internal.child_count) >= u64(entity_count)) {
+
+					SV_LOG_ERROR("Invalid entity child count");
+					SV_FREE_MEMORY(entity_internal);
+					SV_FREE_MEMORY(entity_misc);
+					SV_FREE_MEMORY(entity_transform);
+					ecs.entity_hierarchy.clear();
+					return false;
+				}
+				deserialize_varint(d, internal.prefab);
+				deserialize_varint(d, internal.tag_mask);
+				deserialize_varint(d, misc.flags);
+				deserialize_string(d, misc.name, ENTITY_NAME_SIZE + 1u);
+
+				u8 mask;
+				deserialize_u8(d, mask);
+				if (mask & EntityTransformBit_Position) deserialize_v3_f32(d, transform.position);
+				if (mask & EntityTransformBit_Rotation) deserialize_v4_f32(d, transform.rotation);
+				if (mask & EntityTransformBit_Scale) deserialize_v3_f32(d, transform.scale);
+			}
+			else {
+				
+				if (version >= 2)
+					deserialize_u64(d, internal.tag_mask);
+
+				deserialize_u32(d, internal.child_count);
+				deserialize_u32(d, internal.hierarchy_index);
+				deserialize_u32(d, internal.prefab);
+			
+				deserialize_string(d, misc.name, ENTITY_NAME_SIZE + 1u);
+				deserialize_u64(d, misc.flags);
+			
+				deserialize_v3_f32(d, transform.position);
+				deserialize_v4_f32(d, transform.rotation);
+				deserialize_v3_f32(d, transform.scale);
+
+				if (version == 1u) {
+
+					char tag_name[TAG_NAME_SIZE + 1u];
+					deserialize_string(d, tag_name, TAG_NAME_SIZE + 1u);
+				}
+			}
+			
+			internal.component_mask = 0u;
+			internal.component_count = 0u;
+			transform.dirty = true;
+			transform.dirty_physics = true;
+
+			// Notify tags
+			if (internal.tag_mask) {
+
+				u64 mask = 0u;
+
+				foreach(tag, tag_registers.size()) {
+
+					TempTagRegister& reg = tag_registers[tag];
+					
+					if (internal.tag_mask & SV_BIT(reg.id)) {
+
+						foreach(i, TAG_MAX) {
+
+							if (string_equals(scene_state->tag_register[i].name, reg.name)) {
+								mask |= SV_BIT(i);
+								ecs.tags[i].entities.push_back(entity);
+								break;
+							}
+						}
+					}
+				}
+
+				internal.tag_mask = mask;
+			}
+
+			// Find prefab
+			if (internal.prefab) {
+
+				for (PrefabRef ref : prefabs) {
+
+					if (ref.old_prefab == internal.prefab) {
+						internal.prefab = ref.current_prefab;
+						ecs.prefabs[internal.prefab - 1u].entities.push_back(entity);
+						break;
+					}
+				}
+			}
+		}
+
+		// Create entity list and free list
+		foreach(i, entity_data_count) {
+
+			EntityInternal& internal = entity_internal[i];
+
+			if (internal.hierarchy_index != u32_max) {
+				ecs.entity_hierarchy[internal.hierarchy_index] = i + 1u;
+			}
+			else ecs.entity_free_list.push_back(i + 1u);
+		}
+
+		// Set entity parents
+		{
+			EntityInternal* it = entity_internal;
+			EntityInternal* end = it + entity_data_count;
+
+			while (it != end) {
+
+				if (it->hierarchy_index != u32_max && it->child_count) {
+
+					Entity* eIt = ecs.entity_hierarchy.data() + it->hierarchy_index;
+					Entity* eEnd = eIt + it->child_count;
+					Entity parent = *eIt++;
+
+					while (eIt <= eEnd) {
+
+						EntityInternal& ed = entity_internal[*eIt - 1u];
+						ed.parent = parent;
+						if (ed.child_count) {
+							eIt += ed.child_count + 1u;
+						}
+						else ++eIt;
+					}
+				}
+
+				++it;
+			}
+		}
+
+		// Set entity data
+		SV_ASSERT(ecs.entity_internal == NULL);
+		ecs.entity_internal = entity_internal;
+		ecs.entity_misc = entity_misc;
+		ecs.entity_transform = entity_transform;
+		ecs.entity_capacity = entity_data_count;
+		ecs.entity_size = entity_data_count;
+
+		// Components
+		{
+			List<Entity> block_entities;
+
+			// Version 4: the components are created in file order and the blocks that allow it are
+			// deserialized in worker threads while the main thread continues with the next blocks
+			List<ComponentBlock> blocks;
+			TaskContext context;
+
+			if (version >= 4u)
+				blocks.resize(component_registers.size());
+			
+			foreach(reg_index, component_registers.size()) {
+
+				TempComponentRegister& reg = component_registers[reg_index];
+				CompID comp_id = reg.id;
+				u32 comp_version = reg.version;
+				u32 comp_count;
+				u64 data_size = 0u;
+
+				if (version >= 3u) {
+
+					if (!deserialize_varint(d, comp_count) || !deserialize_assert(d, comp_count)) {
+						SV_LOG_ERROR("Invalid component block");
+						task_wait(context);
+						return false;
+					}
+
+					block_entities.resize(comp_count);
+					Entity last = 0u;
+
+					foreach(i, comp_count) {
+
+						i64 delta;
+						deserialize_varint_signed(d, delta);
+
+						i64 entity = i64(last) + delta;
+
+						if (entity <= 0 || entity > i64(entity_data_count) || entity_internal[entity - 1].hierarchy_index == u32_max) {
+							SV_LOG_ERROR("Invalid component entity");
+							task_wait(context);
+							return false;
+						}
+
+						block_entities[i] = Entity(entity);
+						last = Entity(entity);
+					}
+
+					if (version >= 4u) {
+
+						if (!deserialize_assert(d, sizeof(u64))) {
+							SV_LOG_ERROR("Invalid component block");
+							task_wait(context);
+							return false;
+						}
+
+						deserialize_u64(d, data_size);
+
+						if (!deserialize_assert(d, size_t(data_size))) {
+							SV_LOG_ERROR("Invalid component block");
+							task_wait(context);
+							return false;
+						}
+					}
+
+					reserve_components(comp_id, comp_count);
+				}
+				else deserialize_u32(d, comp_count);
+
+				size_t data_begin = d.pos;
+				ComponentBlock* block = NULL;
+
+				if (version >= 4u && comp_count && scene_state->component_register[comp_id].parallel_deserialize) {
+
+					block = &blocks[reg_index];
+					block->comp_id = comp_id;
+					block->version = comp_version;
+					block->data = d.buff.data() + d.pos;
+					block->size = size_t(data_size);
+					block->components.reserve(comp_count);
+				}
+
+				foreach(i, comp_count) {
+
+					Entity entity;
+
+					if (version >= 3u) entity = block_entities[i];
+					else deserialize_entity(d, entity);
+
+					if (entity == 0) continue;
+
+					Component* comp = allocate_component(comp_id);
+					create_entity_component(comp_id, comp, entity);
+
+					if (block) block->components.push_back(comp);
+					else deserialize_component(comp_id, comp, d, comp_version);
+
+					EntityInternal& internal = ecs.entity_internal[entity - 1u];
+
+					if (internal.component_count < ENTITY_COMPONENTS_MAX) {
+						
+						CompRef& ref = internal.components[internal.component_count++];
+						ref.comp_id = comp_id;
+						ref.comp = comp;
+						
+						internal.component_mask |= (1ULL << (u64)comp_id);
+					}
+					else {
+						SV_LOG_ERROR("A deserialized entity have more than %u components", ENTITY_COMPONENTS_MAX);
+						task_wait(context);
+						return false;
+					}
+				}
+
+				if (block) {
+
+					d.pos += block->size;
+					task_dispatch(component_block_task, &block, sizeof(block), &context);
+				}
+				else if (version >= 4u && d.pos - data_begin != data_size) {
+					
+					SV_LOG_ERROR("The component block '%s' is corrupted", reg.name);
+					task_wait(context);
+					return false;
+				}
+			}
+
+			task_wait(context);
+
+			foreach(i, blocks.size()) {
+
+				if (blocks[i].failed) {
+					SV_LOG_ERROR("The component block '%s' is corrupted", component_registers[i].name);
+					return false;
+				}
+			}
+
+			// The assets referenced by the parallel blocks are requested at once
+			for (const ComponentBlock& block : blocks) {
+				asset_requests_execute(block.requests.data(), u32(block.requests.size()));
+			}
+		}
+
+		// Prefab overrides
+		if (version >= 5u) {
+
+			u32 override_count;
+
+			if (!deserialize_varint(d, override_count) || !deserialize_assert(d, override_count)) {
+				SV_LOG_ERROR("Invalid prefab overrides");
+				return false;
+			}
+
+			foreach(i, override_count) {
+
+				u32 entity, reg_index;
+				u64 data_size;
+
+				deserialize_varint(d, entity);
+				deserialize_varint(d, reg_index);
+
+				if (!deserialize_assert(d, sizeof(u64))) {
+					SV_LOG_ERROR("Invalid prefab override");
+					return false;
+				}
+
+				deserialize_u64(d, data_size);
+
+				if (!deserialize_assert(d, size_t(data_size))
+					|| entity == 0 || entity > entity_data_count || entity_internal[entity - 1u].hierarchy_index == u32_max
+					|| reg_index >= component_registers.size()) {
+					
+					SV_LOG_ERROR("Invalid prefab override");
+					return false;
+				}
+
+				size_t data_end = d.pos + size_t(data_size);
+				
+				TempComponentRegister& reg = component_registers[reg_index];
+				CompID comp_id = reg.id;
+				EntityInternal& internal = ecs.entity_internal[entity - 1u];
+
+				if (internal.prefab == 0 || !has_prefab_component(internal.prefab, comp_id) || (internal.component_mask & SV_BIT(comp_id)) || internal.component_count == ENTITY_COMPONENTS_MAX) {
+					
+					SV_LOG_WARNING("The entity '%s' can't override the prefab component '%s'", ecs.entity_misc[entity - 1u].name, reg.name);
+					d.pos = data_end;
+					continue;
+				}
+
+				Component* comp = allocate_component(comp_id);
+				create_entity_component(comp_id, comp, entity);
+
+				Deserializer view;
+				deserialize_begin_view(view, d.buff.data() + d.pos, size_t(data_size));
+				deserialize_component(comp_id, comp, view, reg.version);
+
+				d.pos = data_end;
+
+				CompRef& ref = internal.components[internal.component_count++];
+				ref.comp_id = comp_id;
+				ref.comp = comp;
+						
+				internal.component_mask |= SV_BIT(comp_id);
+			}
+		}
+
+		// TODO: dispath all events at once
+		for (Entity entity : ecs.entity_hierarchy) {
+
+			EntityCreateEvent e;
+			e.entity = entity;
+			
+			event_dispatch("on_entity_create", &e);
+		}
+
+		return true;
+	}
+
+	void scene_serialize_benchmark(u32 entity_count)
+	{
+		if (!there_is_scene()) {
+			SV_LOG_ERROR("The scene benchmark needs a scene");
+			return;
+		}
+		
+		SV_ECS();
+
+		SV_LOG_INFO("Scene serialize benchmark, %u entities. The current entities are replaced", entity_count);
+
+		clear_ecs();
+
+		// Groups of a root with 9 children, a component per entity
+		u32 register_count = scene_state->component_register_count;
+		Entity root = 0;
+		
+		foreach(i, entity_count) {
+
+			Entity entity = create_entity((i % 10u) ? root : 0, "Entity");
+			if (i % 10u == 0u) root = entity;
+
+			if (i % 3u == 0u) {
+				Transform transform;
+				transform.position = v3_f32(f32(i), 0.f, f32(i % 100u));
+				set_entity_transform(entity, transform);
+			}
+
+			if (register_count) add_entity_component(entity, CompID(i % register_count));
+		}
+
+		constexpr f64 MB = 1024.0 * 1024.0;
+		
+		foreach(format, 2u) {
+
+			Serializer s;
+
+			f64 begin = timer_now();
+			
+			if (format == 0u) serialize_ecs_legacy(s);
+			else serialize_ecs(s);
+			
+			f64 save_time = timer_now() - begin;
+			size_t size = s.buff.size();
+
+			clear_ecs();
+
+			Deserializer d;
+			d.buff.write_back(s.buff.data(), size);
+			d.pos = 0u;
+
+			begin = timer_now();
+			bool res = deserialize_ecs(d);
+			f64 load_time = timer_now() - begin;
+
+			if (!res) {
+				SV_LOG_ERROR("Can't deserialize the benchmark scene");
+				return;
+			}
+
+			SV_LOG_INFO("%s: %.2f MB, save %.2f ms, load %.2f ms", format == 0u ? "Version 2" : "Version 5", f32(f64(size) / MB), f32(save_time * 1000.0), f32(load_time * 1000.0));
+		}
+	}
+
+	/////////////////////////////////////// SNAPSHOT //////////////////////////////////////////////////////////
+
+	struct ComponentTypeSnapshot {
+		char               name[COMPONENT_NAME_SIZE + 1u];
+		u32                size;
+		u32                version;
+		bool               snapshot_copy;
+		DestroyComponentFn destroy_fn; // The snapshot can be freed after the components are unregistered
+		ComponentPool*     pools;
+		u32                pool_count;
+	};
+
+	struct SceneSnapshot {
+
+		char                 name[SCENE_NAME_SIZE + 1u] = {};
+		SceneData            data;
+
+		EntityInternal*      entity_internal = NULL;
+		EntityMisc*          entity_misc = NULL;
+		EntityTransform*     entity_transform = NULL;
+		u32                  entity_size = 0u;
+		List<Entity>         entity_hierarchy;
+		List<Entity>         entity_free_list;
+
+		List<PrefabInternal> prefabs;
+		u32                  prefab_free_count = 0u;
+
+		List<Entity>         tags[TAG_MAX];
+
+		ComponentTypeSnapshot components[COMPONENT_MAX];
+		u32                   component_count = 0u;
+
+		RawList serialized; // The components without snapshot_copy, in pool order
+	};
+
+	// Source and destination pools with the same layout
+	struct PoolRemap {
+		const ComponentPool* src;
+		const ComponentPool* dst;
+		u32                  pool_count;
+		u32                  size;
+	};
+
+	SV_AUX ComponentPool* allocate_pools_like(const ComponentPool* src, u32 pool_count, u32 size)
+	{
+		if (pool_count == 0u) return NULL;
+		
+		ComponentPool* pools = (ComponentPool*)SV_ALLOCATE_MEMORY(sizeof(ComponentPool) * pool_count, "Scene");
+
+		foreach(i, pool_count) {
+
+			pools[i] = src[i];
+			pools[i].data = (u8*)SV_ALLOCATE_MEMORY(size_t(size) * src[i].capacity, "Scene");
+
+			// The free slots have id 0
+			memset(pools[i].data, 0, size_t(size) * src[i].capacity);
+		}
+
+		return pools;
+	}
+
+	SV_AUX void remap_component_refs(CompRef* refs, u32 count, const PoolRemap* remap)
+	{
+		foreach(i, count) {
+
+			CompRef& ref = refs[i];
+			const PoolRemap& r = remap[ref.comp_id];
+			const u8* comp = (const u8*)ref.comp;
+
+			foreach(j, r.pool_count) {
+
+				const u8* begin = r.src[j].data;
+
+				if (comp >= begin && comp < begin + size_t(r.size) * r.src[j].capacity) {
+					ref.comp = (Component*)(r.dst[j].data + (comp - begin));
+					break;
+				}
+			}
+		}
+	}
+
+	// The components are duplicated with the copy_fn or serialized, the prefab components keep the prefab id
+	SV_AUX void copy_pool_components(CompID comp_id, const PoolRemap& remap, bool snapshot_copy, Serializer* s, Deserializer* d, u32 version)
+	{
+		foreach(i, remap.pool_count) {
+
+			const ComponentPool& src = remap.src[i];
+			const ComponentPool& dst = remap.dst[i];
+
+			foreach(j, src.count) {
+
+				Component* from = (Component*)(src.data + size_t(j) * remap.size);
+				Component* to = (Component*)(dst.data + size_t(j) * remap.size);
+
+				u32 id = from->id;
+				if (id == 0u) continue;
+
+				if (s && !snapshot_copy) {
+					serialize_component(comp_id, from, *s);
+					to->id = id;
+					continue;
+				}
+
+				if (id & SV_BIT(31)) create_prefab_component(comp_id, to, id & ~SV_BIT(31));
+				else create_entity_component(comp_id, to, id);
+
+				if (snapshot_copy) {
+					copy_component(comp_id, to, from, (id & SV_BIT(31)) ? 0 : id);
+					to->id = id;
+					to->flags = from->flags;
+				}
+				else deserialize_component(comp_id, to, *d, version);
+			}
+		}
+	}
+
+	SceneSnapshot* scene_snapshot_capture()
+	{
+		if (!there_is_scene()) return NULL;
+		
+		SV_ECS();
 
-			foreach(i, prefab_count) {
+		SceneSnapshot* snapshot = SV_ALLOCATE_STRUCT(SceneSnapshot, "Scene");
 
-				PrefabRef ref;
-				
-				deserialize_u32(d, ref.old_prefab);
+		string_copy(snapshot->name, scene.name, SCENE_NAME_SIZE + 1u);
+		snapshot->data = scene.data;
 
-				if (ref.old_prefab) {
-					
-					char filepath[FILEPATH_SIZE + 1u];
-					deserialize_string(d, filepath, FILEPATH_SIZE + 1u);
-				
-					ref.current_prefab = load_prefab(filepath);
+		// Entities
+		u32 entity_size = ecs.entity_size;
+		snapshot->entity_size = entity_size;
 
-					if (ref.current_prefab) {
-						prefabs.push_back(ref);
-					}
-				}
-			}
+		if (entity_size) {
+			
+			snapshot->entity_internal = (EntityInternal*)SV_ALLOCATE_MEMORY(sizeof(EntityInternal) * entity_size, "Scene");
+			snapshot->entity_misc = (EntityMisc*)SV_ALLOCATE_MEMORY(sizeof(EntityMisc) * entity_size, "Scene");
+			snapshot->entity_transform = (EntityTransform*)SV_ALLOCATE_MEMORY(sizeof(EntityTransform) * entity_size, "Scene");
+
+			memcpy(snapshot->entity_internal, ecs.entity_internal, sizeof(EntityInternal) * entity_size);
+			memcpy(snapshot->entity_misc, ecs.entity_misc, sizeof(EntityMisc) * entity_size);
+			memcpy(snapshot->entity_transform, ecs.entity_transform, sizeof(EntityTransform) * entity_size);
 		}
 
-		// Entity data
-		u32 entity_count;
-		u32 entity_data_count;
+		snapshot->entity_hierarchy = ecs.entity_hierarchy;
+		snapshot->entity_free_list = ecs.entity_free_list;
 
-		deserialize_u32(d, entity_count);
-		deserialize_u32(d, entity_data_count);
+		// Copy constructed, the prefabs contain lists
+		for (const PrefabInternal& p : ecs.prefabs)
+			snapshot->prefabs.push_back(p);
+		
+		snapshot->prefab_free_count = ecs.prefab_free_count;
 
-		ecs.entity_hierarchy.resize(entity_count);
-		EntityInternal* entity_internal = (EntityInternal*)SV_ALLOCATE_MEMORY(sizeof(EntityInternal) * entity_data_count, "Scene");
-		EntityMisc* entity_misc = (EntityMisc*)SV_ALLOCATE_MEMORY(sizeof(EntityMisc) * entity_data_count, "Scene");
-		EntityTransform* entity_transform = (EntityTransform*)SV_ALLOCATE_MEMORY(sizeof(EntityTransform) * entity_data_count, "Scene");
+		foreach(i, TAG_MAX)
+			snapshot->tags[i] = ecs.tags[i].entities;
 
-		foreach(i, entity_data_count) initialize_entity_internal(entity_internal[i]);
-		foreach(i, entity_data_count) initialize_entity_misc(entity_misc[i]);
-		foreach(i, entity_data_count) initialize_entity_transform(entity_transform[i]);
+		// Components
+		PoolRemap remap[COMPONENT_MAX];
+		Serializer s;
+		
+		snapshot->component_count = scene_state->component_register_count;
 
-		foreach(i, entity_count) {
+		foreach(comp_id, snapshot->component_count) {
 
-			Entity entity;
-			deserialize_entity(d, entity);
+			const ComponentRegister& reg = scene_state->component_register[comp_id];
+			const ComponentAllocator& alloc = ecs.component_allocator[comp_id];
+			ComponentTypeSnapshot& type = snapshot->components[comp_id];
 
-			EntityInternal& internal = entity_internal[entity - 1u];
-			EntityMisc& misc = entity_misc[entity - 1u];
-			EntityTransform& transform = entity_transform[entity - 1u];
+			string_copy(type.name, reg.name, COMPONENT_NAME_SIZE + 1u);
+			type.size = reg.size;
+			type.version = reg.version;
+			type.snapshot_copy = reg.snapshot_copy;
+			type.destroy_fn = reg.destroy_fn;
+			type.pool_count = alloc.pool_count;
+			type.pools = allocate_pools_like(alloc.pools, alloc.pool_count, reg.size);
 
-			if (version >= 2)
-				deserialize_u64(d, internal.tag_mask);
+			remap[comp_id] = { alloc.pools, type.pools, alloc.pool_count, reg.size };
 
-			deserialize_u32(d, internal.child_count);
-			deserialize_u32(d, internal.hierarchy_index);
-			deserialize_u32(d, internal.prefab);
-			internal.component_mask = 0u;
-			internal.component_count = 0u;
-			
-			deserialize_string(d, misc.name, ENTITY_NAME_SIZE + 1u);
-			deserialize_u64(d, misc.flags);
-			
-			deserialize_v3_f32(d, transform.position);
-			deserialize_v4_f32(d, transform.rotation);
-			deserialize_v3_f32(d, transform.scale);
-			transform.dirty = true;
-			transform.dirty_physics = true;
+			copy_pool_components(comp_id, remap[comp_id], reg.snapshot_copy, &s, NULL, reg.version);
+		}
 
-			if (version == 1u) {
+		snapshot->serialized.write_back(s.buff.data(), s.buff.size());
 
-				char tag_name[TAG_NAME_SIZE + 1u];
-				deserialize_string(d, tag_name, TAG_NAME_SIZE + 1u);
-			}
+		foreach(i, entity_size)
+			remap_component_refs(snapshot->entity_internal[i].components, snapshot->entity_internal[i].component_count, remap);
 
-			// Notify tags
-			if (internal.tag_mask) {
+		for (PrefabInternal& p : snapshot->prefabs)
+			remap_component_refs(p.components, p.component_count, remap);
 
-				u64 mask = 0u;
+		return snapshot;
+	}
 
-				foreach(tag, tag_registers.size()) {
+	bool scene_snapshot_restore(const SceneSnapshot* snapshot)
+	{
+		if (snapshot == NULL) return false;
 
-					TempTagRegister& reg = tag_registers[tag];
-					
-					if (internal.tag_mask & SV_BIT(reg.id)) {
+		// Without scene the snapshot is restored in a new one, used when the game is reset
+		bool new_scene = !there_is_scene();
 
-						foreach(i, TAG_MAX) {
+		if (!new_scene && !string_equals(scene_state->scene->name, snapshot->name)) {
+			SV_LOG_ERROR("The snapshot of the scene '%s' can't be restored in '%s'", snapshot->name, scene_state->scene->name);
+			return false;
+		}
 
-							if (string_equals(scene_state->tag_register[i].name, reg.name)) {
-								mask |= SV_BIT(i);
-								ecs.tags[i].entities.push_back(entity);
-								break;
-							}
-						}
-					}
-				}
+		bool valid_registers = snapshot->component_count == scene_state->component_register_count;
 
-				internal.tag_mask = mask;
-			}
+		foreach(comp_id, snapshot->component_count) {
 
-			// Find prefab
-			if (internal.prefab) {
+			if (!valid_registers) break;
+			
+			const ComponentRegister& reg = scene_state->component_register[comp_id];
+			const ComponentTypeSnapshot& type = snapshot->components[comp_id];
 
-				for (PrefabRef ref : prefabs) {
+			valid_registers = string_equals(reg.name, type.name) && reg.size == type.size && reg.snapshot_copy == type.snapshot_copy;
+		}
 
-					if (ref.old_prefab == internal.prefab) {
-						internal.prefab = ref.current_prefab;
-						ecs.prefabs[internal.prefab - 1u].entities.push_back(entity);
-						break;
-					}
-				}
-			}
+		if (!valid_registers) {
+			SV_LOG_ERROR("The components changed since the scene snapshot");
+			return false;
 		}
 
-		// Create entity list and free list
-		foreach(i, entity_data_count) {
+		if (new_scene) {
 
-			EntityInternal& internal = entity_internal[i];
+			scene_state->scene = SV_ALLOCATE_STRUCT(Scene, "Scene");
+			strcpy(scene_state->scene->name, snapshot->name);
 
-			if (internal.hierarchy_index != u32_max) {
-				ecs.entity_hierarchy[internal.hierarchy_index] = i + 1u;
-			}
-			else ecs.entity_free_list.push_back(i + 1u);
+			initialize_ecs();
+		}
+		else {
+			event_dispatch("close_scene", nullptr);
+			clear_ecs();
 		}
 
-		// Set entity parents
-		{
-			EntityInternal* it = entity_internal;
-			EntityInternal* end = it + entity_data_count;
+		SV_ECS();
 
-			while (it != end) {
+		scene.data = snapshot->data;
 
-				if (it->hierarchy_index != u32_max && it->child_count) {
+		// Entities
+		u32 entity_size = snapshot->entity_size;
 
-					Entity* eIt = ecs.entity_hierarchy.data() + it->hierarchy_index;
-					Entity* eEnd = eIt + it->child_count;
-					Entity parent = *eIt++;
+		if (entity_size) {
+			
+			ecs.entity_internal = (EntityInternal*)SV_ALLOCATE_MEMORY(sizeof(EntityInternal) * entity_size, "Scene");
+			ecs.entity_misc = (EntityMisc*)SV_ALLOCATE_MEMORY(sizeof(EntityMisc) * entity_size, "Scene");
+			ecs.entity_transform = (EntityTransform*)SV_ALLOCATE_MEMORY(sizeof(EntityTransform) * entity_size, "Scene");
 
-					while (eIt <= eEnd) {
+			memcpy(ecs.entity_internal, snapshot->entity_internal, sizeof(EntityInternal) * entity_size);
+			memcpy(ecs.entity_misc, snapshot->entity_misc, sizeof(EntityMisc) * entity_size);
+			memcpy(ecs.entity_transform, snapshot->entity_transform, sizeof(EntityTransform) * entity_size);
+		}
 
-						EntityInternal& ed = entity_internal[*eIt - 1u];
-						ed.parent = parent;
-						if (ed.child_count) {
-							eIt += ed.child_count + 1u;
-						}
-						else ++eIt;
-					}
-				}
+		ecs.entity_size = entity_size;
+		ecs.entity_capacity = entity_size;
+		ecs.entity_hierarchy = snapshot->entity_hierarchy;
+		ecs.entity_free_list = snapshot->entity_free_list;
 
-				++it;
-			}
+		for (const PrefabInternal& p : snapshot->prefabs)
+			ecs.prefabs.push_back(p);
+		
+		ecs.prefab_free_count = snapshot->prefab_free_count;
+
+		foreach(i, TAG_MAX)
+			ecs.tags[i].entities = snapshot->tags[i];
+
+		// The prefabs loaded in play mode are discarded
+		ecs.prefab_table.clear();
+
+		foreach(i, ecs.prefabs.size()) {
+			if (ecs.prefabs[i].valid)
+				ecs.prefab_table[ecs.prefabs[i].filepath] = i + 1u;
 		}
 
-		// Set entity data
-		SV_ASSERT(ecs.entity_internal == NULL);
-		ecs.entity_internal = entity_internal;
-		ecs.entity_misc = entity_misc;
-		ecs.entity_transform = entity_transform;
-		ecs.entity_capacity = entity_data_count;
-		ecs.entity_size = entity_data_count;
+		// The pools are allocated and the references updated before creating the components,
+		// the creation of some components gets other components of the entity (colliders)
+		PoolRemap remap[COMPONENT_MAX];
 
-		// Components
-		{
-			foreach(reg_index, component_registers.size()) {
+		foreach(comp_id, snapshot->component_count) {
 
-				TempComponentRegister& reg = component_registers[reg_index];
-				CompID comp_id = reg.id;
-				u32 version = reg.version;
-				u32 comp_count;
-				deserialize_u32(d, comp_count);
+			const ComponentTypeSnapshot& type = snapshot->components[comp_id];
+			ComponentAllocator& alloc = ecs.component_allocator[comp_id];
 
-				if (comp_count == 0u) continue;
+			alloc.pool_count = type.pool_count;
+			alloc.pools = allocate_pools_like(type.pools, type.pool_count, type.size);
 
-				while (comp_count-- != 0u) {
+			remap[comp_id] = { type.pools, alloc.pools, type.pool_count, type.size };
+		}
 
-					Entity entity;
-					deserialize_entity(d, entity);
+		foreach(i, entity_size)
+			remap_component_refs(ecs.entity_internal[i].components, ecs.entity_internal[i].component_count, remap);
 
-					if (entity == 0) continue;
+		for (PrefabInternal& p : ecs.prefabs)
+			remap_component_refs(p.components, p.component_count, remap);
 
-					Component* comp = allocate_component(comp_id);
-					create_entity_component(comp_id, comp, entity);
-					deserialize_component(comp_id, comp, d, version);
+		Deserializer d;
+		deserialize_begin_view(d, snapshot->serialized.data(), snapshot->serialized.size());
 
-					EntityInternal& internal = ecs.entity_internal[entity - 1u];
+		foreach(comp_id, snapshot->component_count) {
 
-					if (internal.component_count < ENTITY_COMPONENTS_MAX) {
-						
-						CompRef& ref = internal.components[internal.component_count++];
-						ref.comp_id = comp_id;
-						ref.comp = comp;
-						
-						internal.component_mask |= (1ULL << (u64)comp_id);
-					}
-					else {
-						SV_LOG_ERROR("A deserialized entity have more than %u components", ENTITY_COMPONENTS_MAX);
-						return false;
-					}
-				}
-			}
+			const ComponentTypeSnapshot& type = snapshot->components[comp_id];
+			copy_pool_components(comp_id, remap[comp_id], type.snapshot_copy, NULL, &d, type.version);
 		}
 
-		// TODO: dispath all events at once
 		for (Entity entity : ecs.entity_hierarchy) {
 
 			EntityCreateEvent e;
@@ -1327,9 +2371,50 @@ namespace sv {
 			event_dispatch("on_entity_create", &e);
 		}
 
+		event_dispatch("initialize_scene", nullptr);
+		
 		return true;
 	}
 
+	void scene_snapshot_free(SceneSnapshot* snapshot)
+	{
+		if (snapshot == NULL) return;
+
+		foreach(comp_id, snapshot->component_count) {
+
+			ComponentTypeSnapshot& type = snapshot->components[comp_id];
+
+			foreach(i, type.pool_count) {
+
+				ComponentPool& pool = type.pools[i];
+
+				// The serialized components only have the id
+				if (type.snapshot_copy) {
+
+					foreach(j, pool.count) {
+
+						Component* comp = (Component*)(pool.data + size_t(j) * type.size);
+						
+						if (comp->id != 0u)
+							type.destroy_fn(comp, (comp->id & SV_BIT(31)) ? 0 : comp->id);
+					}
+				}
+
+				SV_FREE_MEMORY(pool.data);
+			}
+
+			if (type.pools) SV_FREE_MEMORY(type.pools);
+		}
+
+		if (snapshot->entity_internal) {
+			SV_FREE_MEMORY(snapshot->entity_internal);
+			SV_FREE_MEMORY(snapshot->entity_misc);
+			SV_FREE_MEMORY(snapshot->entity_transform);
+		}
+
+		SV_FREE_STRUCT(snapshot);
+	}
+
 	SV_AUX void allocate_entities()
 	{
 		SV_ECS();
@@ -1687,6 +2772,13 @@ namespace sv {
 		SV_ASSERT(entity_exists(entity));
 		return ecs.entity_internal[entity - 1u].parent;
 	}
+
+	Prefab get_entity_prefab(Entity entity)
+	{
+		SV_ECS();
+		SV_ASSERT(entity_exists(entity));
+		return ecs.entity_internal[entity - 1u].prefab;
+	}
 	
     u32 get_entity_component_count(Entity entity)
 	{
@@ -1700,7 +2792,12 @@ namespace sv {
 		if (internal.prefab) {
 
 			PrefabInternal& p = ecs.prefabs[internal.prefab - 1u];
-			count += p.component_count;
+
+			// The overridden prefab components are not counted twice
+			foreach(i, p.component_count) {
+				if (!(internal.component_mask & SV_BIT(p.components[i].comp_id)))
+					++count;
+			}
 		}
 
 		return count;
@@ -1722,7 +2819,14 @@ namespace sv {
 			PrefabInternal& p = ecs.prefabs[internal.prefab - 1u];
 			index -= internal.component_count;
 
-			return p.components[index];
+			foreach(i, p.component_count) {
+
+				const CompRef& ref = p.components[i];
+				if (internal.component_mask & SV_BIT(ref.comp_id)) continue;
+
+				if (index-- == 0u)
+					return ref;
+			}
 		}
 
 		SV_ASSERT(0);
@@ -1839,6 +2943,46 @@ namespace sv {
 		}
 	}
 	
+	Component* override_entity_component(Entity entity, CompID comp_id)
+	{
+		SV_ECS();
+		SV_ASSERT(entity_exists(entity));
+
+		if (!component_exists(comp_id))
+			return NULL;
+
+		EntityInternal& internal = ecs.entity_internal[entity - 1u];
+
+		if (internal.prefab == 0 || !has_prefab_component(internal.prefab, comp_id)) {
+			SV_LOG_ERROR("The entity prefab doesn't have the component '%s'", get_component_name(comp_id));
+			return NULL;
+		}
+
+		if (internal.component_mask & SV_BIT(comp_id)) {
+			SV_LOG_ERROR("The prefab component is already overridden");
+			return NULL;
+		}
+
+		if (internal.component_count == ENTITY_COMPONENTS_MAX) {
+			SV_LOG_ERROR("A entity can't have more than %u components", ENTITY_COMPONENTS_MAX);
+			return NULL;
+		}
+
+		Component* component = allocate_component(comp_id);
+		
+		create_entity_component(comp_id, component, entity);
+		copy_component(comp_id, component, get_prefab_component(internal.prefab, comp_id), entity);
+
+		internal.components[internal.component_count].comp_id = comp_id;
+		internal.components[internal.component_count].comp = component;
+		
+		++internal.component_count;
+
+		internal.component_mask |= SV_BIT(comp_id);
+
+		return component;
+	}
+	
 	Component* get_entity_component(Entity entity, CompID comp_id)
 	{
 		SV_ECS();
@@ -2144,7 +3288,7 @@ namespace sv {
 		Deserializer s;
 		Entity entity = 0;
 
-		if (deserialize_begin(s, filepath)) {
+		if (deserialize_begin_mapped(s, filepath)) {
 
 			u32 version;
 			deserialize_u32(s, version); // VERSION
@@ -2239,11 +3383,14 @@ namespace sv {
 		Prefab prefab = 0;
 		
 		Deserializer d;
-		if (deserialize_begin(d, filepath)) {
+		if (deserialize_begin_mapped(d, filepath)) {
 
 			u32 version;
 			deserialize_u32(d, version);
 
+			if (version >= 3u) {
+				prefetch_dependencies(d, filepath);
+			}
 			
 			prefab = allocate_prefab();
 			
@@ -2318,23 +3465,36 @@ namespace sv {
 		SV_ASSERT(prefab_exists(prefab));
 
 		PrefabInternal& p = ecs.prefabs[prefab - 1u];
-		return save_prefab(prefab, p.filepath);
+		return save_prefab(prefab, p.filepath, file_is_compressed(p.filepath));
 	}
 	
-	bool save_prefab(Prefab prefab, const char* filepath)
+	bool save_prefab(Prefab prefab, const char* filepath, bool compress)
 	{
 		SV_ECS();
 		SV_ASSERT(prefab_exists(prefab));
 
 		PrefabInternal& p = ecs.prefabs[prefab - 1u];
 		
+		char temp_filepath[FILEPATH_SIZE + 1u];
+		if (!temp_save_filepath(temp_filepath, filepath))
+			return false;
+		
 		Serializer s;
-		serialize_begin(s);
 
-		serialize_u32(s, 2u); // VERSION
+		if (compress) {
+			serialize_begin(s);
+			s.compress = true;
+		}
+		else if (!serialize_begin_stream(s, temp_filepath))
+			return false;
+
+		serialize_u32(s, 3u); // VERSION
+
+		size_t dependencies_pos = serialize_dependencies_begin(s);
 		serialize_components(s, p.component_count, p.components);
+		serialize_dependencies_end(s, dependencies_pos);
 		
-		return serialize_end(s, filepath);
+		return temp_save_commit(serialize_end(s, temp_filepath), temp_filepath, filepath);
 	}
 
 	bool prefab_exists(Prefab prefab)
@@ -2399,14 +3559,9 @@ namespace sv {
 		
 		++internal.component_count;
 
+		// The instances that already have the component keep it as an override
 		internal.component_mask |= SV_BIT(comp_id);
 
-		// Remove repeated components
-		for (Entity entity : internal.entities) {
-
-			remove_entity_component(entity, comp_id);
-		}
-
 		return component;
 	}
 	
@@ -2496,6 +3651,17 @@ namespace sv {
 		return {};
 	}
 
+	// The instances that override the prefab component are iterated with their own component
+	SV_AUX u32 next_shared_instance(const List<Entity>& entities, u32 index, CompID comp_id)
+	{
+		SV_ECS();
+
+		while (index < entities.size() && (ecs.entity_internal[entities[index] - 1u].component_mask & SV_BIT(comp_id)))
+			++index;
+
+		return index;
+	}
+
 	CompIt comp_it_begin(CompID comp_id, u32 flags)
 	{
 		SV_ECS();
@@ -2552,10 +3718,13 @@ namespace sv {
 			SV_ASSERT(prefab_exists(it.prefab));
 			PrefabInternal& internal = ecs.prefabs[it.prefab - 1u];
 
-			if (++it.entity_index < internal.entities.size() && !(it.flags & CompItFlag_Once)) {
+			u32 index = next_shared_instance(internal.entities, it.entity_index + 1u, it.comp_id);
+
+			if (index < internal.entities.size() && !(it.flags & CompItFlag_Once)) {
 
 				next_component = false;
-				it.entity = internal.entities[it.entity_index];
+				it.entity_index = index;
+				it.entity = internal.entities[index];
 			}
 			else it.prefab = 0;
 		}
@@ -2610,13 +3779,18 @@ namespace sv {
 						it.prefab = prefab;
 						break;
 					}
-					else if (entities.size()) {
+					else {
 
-						it.comp = c;
-						it.entity = entities.front();
-						it.entity_index = 0u;
-						it.prefab = prefab;
-						break;
+						u32 index = next_shared_instance(entities, 0u, comp_id);
+
+						if (index < entities.size()) {
+							
+							it.comp = c;
+							it.entity = entities[index];
+							it.entity_index = index;
+							it.prefab = prefab;
+							break;
+						}
 					}
 				}
 				else {
@@ -2800,6 +3974,8 @@ namespace sv {
 		DeserializeComponentFn deserialize_fn;
 		Library                library;
 		const char*            struct_name;
+		bool                   parallel_deserialize; // The deserialize_fn can run in a worker thread
+		bool                   snapshot_copy; // The copy_fn doesn't share owned memory or objects, the snapshots use it instead of serializing
 
     };
 
@@ -2818,6 +3994,8 @@ namespace sv {
 		reg.deserialize_fn = desc.deserialize_fn;
 		reg.library = desc.library;
 		string_copy(reg.struct_name, desc.struct_name, COMPONENT_NAME_SIZE + 1u);
+		reg.parallel_deserialize = desc.parallel_deserialize;
+		reg.snapshot_copy = desc.snapshot_copy;
 		
 		return true;
 	}
@@ -2882,7 +4060,7 @@ namespace sv {
 #endif
 
 	template<typename T>
-	SV_AUX bool register_component(const char* name)
+	SV_AUX bool register_component(const char* name, bool snapshot_copy = true)
 	{
 		ComponentRegisterDesc desc;
 		desc.name = name;
@@ -2890,6 +4068,8 @@ namespace sv {
 		desc.version = T::VERSION;
 		desc.library = 0;
 		desc.struct_name = "";
+		desc.parallel_deserialize = true;
+		desc.snapshot_copy = snapshot_copy;
 
 		desc.create_fn = [](Component* comp, Entity entity)
 			{
@@ -2932,14 +4112,17 @@ namespace sv {
 		register_component<AnimatedSpriteComponent>("Animated Sprite");
 		register_component<CameraComponent>("Camera");
 		register_component<MeshComponent>("Mesh");
-		register_component<TerrainComponent>("Terrain");
-		register_component<ParticleSystem>("Particle System");
+		register_component<TerrainComponent>("Terrain", false); // GPU buffers
+		register_component<ParticleSystem>("Particle System", false); // Particle buffers
 		register_component<ParticleSystemModel>("Particle System Model");
 		register_component<LightComponent>("Light");
 
+		// The physics and audio components create objects in their systems while deserializing
 		ComponentRegisterDesc desc;
 		desc.library = 0;
 		desc.struct_name = "";
+		desc.parallel_deserialize = false;
+		desc.snapshot_copy = false;
 		
 		desc.name = "Body";
 		desc.size = sizeof(BodyComponent);
@@ -3735,9 +4918,8 @@ namespace sv {
     {
 		// TODO: Deprecated
 		if (version == 0u) {
-			TextureAsset tex;
 			v4_f32 texcoord;
-			deserialize_asset(d, tex);
+			deserialize_asset_skip(d);
 			deserialize_v4_f32(d, texcoord);
 			deserialize_color(d, color);
 			deserialize_u32(d, layer);
@@ -3765,10 +4947,9 @@ namespace sv {
     {
 		// TODO: Deprecated
 		if (version == 0u) {
-			TextureAsset texture;
 			u32 t;
 			f32 f;
-			deserialize_asset(d, texture);
+			deserialize_asset_skip(d);
 			deserialize_u32(d, t);
 			deserialize_u32(d, t);
 			deserialize_u32(d, t);
@@ -3887,8 +5068,8 @@ namespace sv {
 
     void MeshComponent::deserialize(Deserializer& d, u32 version)
     {
-		deserialize_asset(d, mesh);
-		deserialize_asset(d, material);
+		deserialize_asset(d, mesh, AssetLoadingPriority_KeepItLoading);
+		deserialize_asset(d, material, AssetLoadingPriority_KeepItLoading);
     }
 
     void LightComponent::serialize(Serializer& s)
@@ -138,9 +138,22 @@ namespace sv {
 			}
 		
 			deserialize_v2_u32(d, resolution);
-			deserialize_f32_array(d, heights);
+
+			// The heights are validated before allocating them
+			const f32* data;
+			u32 count;
+			
+			if (!deserialize_pod_array_view(d, data, count)) {
+				SV_LOG_ERROR("The terrain heights are truncated");
+				terrain_clear(*this);
+			}
+			else if (u64(count) != u64(resolution.x) * u64(resolution.y)) {
+				SV_LOG_ERROR("The terrain heights don't match the resolution");
+				terrain_clear(*this);
+			}
+			else deserialize_pod_array_copy(heights, data, count);
 		
-			deserialize_asset(d, material);
+			deserialize_asset(d, material, AssetLoadingPriority_KeepItLoading);
 
 			dirty = true;
 		}
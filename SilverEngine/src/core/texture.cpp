@@ -0,0 +1,804 @@
+#include "core/texture.h"
+
+#include <emmintrin.h>
+
+namespace sv {
+
+	constexpr u32 TEXTURE_COOKED_VERSION = 0u;
+	constexpr u32 TEXTURE_TASK_ROWS = 16u;
+	constexpr u32 TEXTURE_TASK_BLOCK_ROWS = 8u;
+	constexpr u32 TEXTURE_SIZE_MAX = 16384u; // The level sizes fit in 32 bits
+
+	u32 texture_mip_count(u32 width, u32 height)
+	{
+		u32 count = 1u;
+		u32 size = SV_MAX(width, height);
+
+		while (size > 1u && count < TEXTURE_MIP_MAX) {
+			size /= 2u;
+			++count;
+		}
+
+		return count;
+	}
+
+	/////////////////////////////////////// COLOR SPACE ///////////////////////////////////////
+
+	SV_AUX f32 srgb_to_linear(f32 c)
+	{
+		return (c <= 0.04045f) ? (c / 12.92f) : powf((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	SV_AUX f32 linear_to_srgb(f32 c)
+	{
+		return (c <= 0.0031308f) ? (c * 12.92f) : (1.055f * powf(c, 1.f / 2.4f) - 0.055f);
+	}
+
+	struct SrgbTable {
+		f32 values[256u];
+
+		SrgbTable()
+		{
+			foreach(i, 256u)
+				values[i] = srgb_to_linear(f32(i) / 255.f);
+		}
+	};
+
+	SV_AUX const f32* srgb_table()
+	{
+		static const SrgbTable table;
+		return table.values;
+	}
+
+	SV_AUX __m128 load_pixel(const u8* src, bool srgb)
+	{
+		if (srgb) {
+			const f32* t = srgb_table();
+			return _mm_set_ps(f32(src[3]) * (1.f / 255.f), t[src[2]], t[src[1]], t[src[0]]);
+		}
+
+		i32 pixel;
+		memcpy(&pixel, src, sizeof(i32));
+
+		__m128i zero = _mm_setzero_si128();
+		__m128i v = _mm_cvtsi32_si128(pixel);
+		v = _mm_unpacklo_epi8(v, zero);
+		v = _mm_unpacklo_epi16(v, zero);
+
+		return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1.f / 255.f));
+	}
+
+	SV_AUX void store_pixel(u8* dst, __m128 v, bool srgb)
+	{
+		v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+
+		if (srgb) {
+
+			alignas(16) f32 c[4u];
+			_mm_store_ps(c, v);
+
+			foreach(i, 3u)
+				c[i] = linear_to_srgb(c[i]);
+
+			v = _mm_load_ps(c);
+		}
+
+		__m128i i = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.f)), _mm_set1_ps(0.5f)));
+		i = _mm_packs_epi32(i, i);
+		i = _mm_packus_epi16(i, i);
+
+		i32 pixel = _mm_cvtsi128_si32(i);
+		memcpy(dst, &pixel, sizeof(i32));
+	}
+
+	/////////////////////////////////////// MIPMAPS ///////////////////////////////////////
+
+	struct ConvertTaskData {
+		const u8* src;
+		f32*      dst;
+		u32       begin;
+		u32       end;
+		bool      srgb;
+	};
+
+	SV_INTERNAL void convert_task(void* data)
+	{
+		ConvertTaskData& d = *reinterpret_cast<ConvertTaskData*>(data);
+
+		for (u32 i = d.begin; i < d.end; ++i) {
+			_mm_storeu_ps(d.dst + i * 4u, load_pixel(d.src + i * 4u, d.srgb));
+		}
+	}
+
+	struct MipTaskData {
+		const f32* src;
+		f32*       dst;
+		u8*        dst_rgba;
+		u32        src_width;
+		u32        src_height;
+		u32        dst_width;
+		u32        y_begin;
+		u32        y_end;
+		bool       srgb;
+	};
+
+	// Downsamples with a 4x4 tent filter (1 3 3 1), the edges are clamped
+	SV_INTERNAL void mip_task(void* data)
+	{
+		MipTaskData& d = *reinterpret_cast<MipTaskData*>(data);
+
+		const __m128 weights[4u] = {
+			_mm_set1_ps(1.f / 8.f),
+			_mm_set1_ps(3.f / 8.f),
+			_mm_set1_ps(3.f / 8.f),
+			_mm_set1_ps(1.f / 8.f),
+		};
+
+		i32 max_x = i32(d.src_width) - 1;
+		i32 max_y = i32(d.src_height) - 1;
+
+		for (u32 y = d.y_begin; y < d.y_end; ++y) {
+
+			u32 sy[4u];
+			foreach(k, 4u) sy[k] = u32(SV_MIN(SV_MAX(i32(y * 2u + k) - 1, 0), max_y));
+
+			for (u32 x = 0u; x < d.dst_width; ++x) {
+
+				u32 sx[4u];
+				foreach(k, 4u) sx[k] = u32(SV_MIN(SV_MAX(i32(x * 2u + k) - 1, 0), max_x));
+
+				__m128 acc = _mm_setzero_ps();
+
+				foreach(ky, 4u) {
+
+					const f32* row = d.src + sy[ky] * d.src_width * 4u;
+					__m128 r = _mm_setzero_ps();
+
+					foreach(kx, 4u) {
+						r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(row + sx[kx] * 4u), weights[kx]));
+					}
+
+					acc = _mm_add_ps(acc, _mm_mul_ps(r, weights[ky]));
+				}
+
+				u32 index = y * d.dst_width + x;
+				_mm_storeu_ps(d.dst + index * 4u, acc);
+				store_pixel(d.dst_rgba + index * 4u, acc, d.srgb);
+			}
+		}
+	}
+
+	/////////////////////////////////////// BLOCK COMPRESSION ///////////////////////////////////////
+
+	SV_AUX void fetch_block(const u8* src, u32 width, u32 height, u32 bx, u32 by, u8* block)
+	{
+		foreach(y, 4u) {
+
+			u32 sy = SV_MIN(by * 4u + y, height - 1u);
+
+			foreach(x, 4u) {
+
+				u32 sx = SV_MIN(bx * 4u + x, width - 1u);
+				memcpy(block + (y * 4u + x) * 4u, src + (sy * width + sx) * 4u, 4u);
+			}
+		}
+	}
+
+	// Min and max of each channel
+	SV_AUX void block_bounds(const u8* block, u8* min, u8* max)
+	{
+		__m128i mn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+		__m128i mx = mn;
+
+		for (u32 i = 1u; i < 4u; ++i) {
+
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16u));
+			mn = _mm_min_epu8(mn, v);
+			mx = _mm_max_epu8(mx, v);
+		}
+
+		mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+		mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+		mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+		mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		i32 n = _mm_cvtsi128_si32(mn);
+		i32 m = _mm_cvtsi128_si32(mx);
+		memcpy(min, &n, 4u);
+		memcpy(max, &m, 4u);
+	}
+
+	SV_AUX u16 pack_565(const i32* c)
+	{
+		u32 r = u32(c[0] * 31 + 127) / 255u;
+		u32 g = u32(c[1] * 63 + 127) / 255u;
+		u32 b = u32(c[2] * 31 + 127) / 255u;
+		return u16((r << 11u) | (g << 5u) | b);
+	}
+
+	SV_AUX void unpack_565(u16 v, i32* c)
+	{
+		i32 r = (v >> 11) & 31;
+		i32 g = (v >> 5) & 63;
+		i32 b = v & 31;
+		c[0] = (r << 3) | (r >> 2);
+		c[1] = (g << 2) | (g >> 4);
+		c[2] = (b << 3) | (b >> 2);
+	}
+
+	// The palettes are 16 bit RGBA, two entries per register
+
+	SV_AUX __m128i load_pixel16(const u8* pixel, bool alpha)
+	{
+		i32 v;
+		memcpy(&v, pixel, 4u);
+		if (!alpha) v &= 0x00FFFFFF;
+
+		__m128i x = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), _mm_setzero_si128());
+		return _mm_unpacklo_epi64(x, x);
+	}
+
+	SV_AUX __m128i palette_pair(const i32* c0, const i32* c1, bool alpha)
+	{
+		return _mm_setr_epi16(i16(c0[0u]), i16(c0[1u]), i16(c0[2u]), alpha ? i16(c0[3u]) : 0, i16(c1[0u]), i16(c1[1u]), i16(c1[2u]), alpha ? i16(c1[3u]) : 0);
+	}
+
+	SV_AUX __m128i min_epi32(__m128i a, __m128i b)
+	{
+		__m128i m = _mm_cmplt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+	}
+
+	// Squared distance to 4 entries at a time. The key (distance << 4 | index) keeps the first entry on ties
+	SV_AUX u32 closest_palette_entry(__m128i pixel, const __m128i* palette, u32 count)
+	{
+		__m128i best = _mm_set1_epi32(i32_max);
+
+		for (u32 k = 0u; k < count; k += 4u) {
+
+			__m128i d0 = _mm_sub_epi16(palette[k / 2u], pixel);
+			__m128i d1 = _mm_sub_epi16(palette[k / 2u + 1u], pixel);
+			__m128 a = _mm_castsi128_ps(_mm_madd_epi16(d0, d0));
+			__m128 b = _mm_castsi128_ps(_mm_madd_epi16(d1, d1));
+
+			__m128i dist = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+
+			__m128i index = _mm_setr_epi32(i32(k), i32(k + 1u), i32(k + 2u), i32(k + 3u));
+			__m128i key = _mm_or_si128(_mm_slli_epi32(dist, 4), index);
+
+			// Entries past the count
+			__m128i valid = _mm_cmplt_epi32(index, _mm_set1_epi32(i32(count)));
+			key = _mm_or_si128(_mm_and_si128(valid, key), _mm_andnot_si128(valid, _mm_set1_epi32(i32_max)));
+
+			best = min_epi32(best, key);
+		}
+
+		best = min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+		best = min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+		return u32(_mm_cvtsi128_si32(best)) & 15u;
+	}
+
+	// If punch_alpha is true, the pixels with alpha < 128 are transparent (BC1 3 color mode)
+	SV_AUX void encode_bc1_color(const u8* block, const u8* min, const u8* max, bool punch_alpha, u8* out)
+	{
+		i32 c0[3u], c1[3u];
+
+		// Inset the bounding box to reduce the error
+		foreach(i, 3u) {
+			i32 inset = (i32(max[i]) - i32(min[i])) >> 4;
+			c0[i] = i32(max[i]) - inset;
+			c1[i] = i32(min[i]) + inset;
+		}
+
+		u16 e0 = pack_565(c0);
+		u16 e1 = pack_565(c1);
+
+		// 4 color mode needs e0 > e1 and 3 color mode e0 <= e1
+		if ((e0 < e1) != punch_alpha) std::swap(e0, e1);
+
+		i32 palette[4u][3u] = {};
+		unpack_565(e0, palette[0u]);
+		unpack_565(e1, palette[1u]);
+
+		u32 color_count;
+
+		if (punch_alpha) {
+			foreach(i, 3u) palette[2u][i] = (palette[0u][i] + palette[1u][i]) / 2;
+			color_count = 3u;
+		}
+		else {
+			foreach(i, 3u) {
+				palette[2u][i] = (2 * palette[0u][i] + palette[1u][i]) / 3;
+				palette[3u][i] = (palette[0u][i] + 2 * palette[1u][i]) / 3;
+			}
+			color_count = (e0 == e1) ? 1u : 4u;
+		}
+
+		__m128i palette16[2u];
+		palette16[0u] = palette_pair(palette[0u], palette[1u], false);
+		palette16[1u] = palette_pair(palette[2u], palette[3u], false);
+
+		u32 indices = 0u;
+
+		foreach(p, 16u) {
+
+			const u8* pixel = block + p * 4u;
+			u32 best;
+
+			if (punch_alpha && pixel[3u] < 128u) best = 3u;
+			else best = closest_palette_entry(load_pixel16(pixel, false), palette16, color_count);
+
+			indices |= best << (p * 2u);
+		}
+
+		memcpy(out, &e0, sizeof(u16));
+		memcpy(out + 2u, &e1, sizeof(u16));
+		memcpy(out + 4u, &indices, sizeof(u32));
+	}
+
+	SV_AUX void encode_bc4(const u8* block, u32 channel, u8 min, u8 max, u8* out)
+	{
+		i16 palette[8u];
+		palette[0u] = max;
+		palette[1u] = min;
+
+		foreach(i, 6u) {
+			palette[i + 2u] = i16((i32(6u - i) * max + i32(i + 1u) * min + 3) / 7);
+		}
+
+		u64 bits = 0u;
+
+		if (max != min) {
+
+			// The 8 entries in one register, the key (distance << 3 | index) keeps the first entry on ties
+			__m128i pal = _mm_loadu_si128(reinterpret_cast<const __m128i*>(palette));
+			__m128i index = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+
+			foreach(p, 16u) {
+
+				__m128i d = _mm_sub_epi16(pal, _mm_set1_epi16(i16(block[p * 4u + channel])));
+				d = _mm_max_epi16(d, _mm_sub_epi16(_mm_setzero_si128(), d));
+
+				__m128i key = _mm_or_si128(_mm_slli_epi16(d, 3), index);
+				key = _mm_min_epi16(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(1, 0, 3, 2)));
+				key = _mm_min_epi16(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(2, 3, 0, 1)));
+				key = _mm_min_epi16(key, _mm_srli_epi32(key, 16));
+
+				u32 best = u32(_mm_cvtsi128_si32(key)) & 7u;
+				bits |= u64(best) << u64(p * 3u);
+			}
+		}
+
+		out[0u] = max;
+		out[1u] = min;
+		memcpy(out + 2u, &bits, 6u);
+	}
+
+	struct BitWriter {
+		u64 data[2u];
+		u32 pos;
+	};
+
+	SV_AUX void write_bits(BitWriter& w, u32 value, u32 count)
+	{
+		foreach(i, count) {
+
+			if (value & (1u << i))
+				w.data[w.pos >> 6u] |= u64(1u) << u64(w.pos & 63u);
+			++w.pos;
+		}
+	}
+
+	// 7 bits per channel + one p-bit, the 4 channels are quantized at once for both p-bits
+	SV_AUX void quantize_bc7_endpoint(const i32* c, u32* q, u32* pbit)
+	{
+		__m128i v = _mm_setr_epi16(i16(c[0u]), i16(c[1u]), i16(c[2u]), i16(c[3u]), 0, 0, 0, 0);
+		i32 best_error = i32_max;
+
+		foreach(p, 2u) {
+
+			__m128i tq = _mm_srai_epi16(_mm_add_epi16(v, _mm_set1_epi16(i16(1u - p))), 1);
+			tq = _mm_min_epi16(_mm_max_epi16(tq, _mm_setzero_si128()), _mm_set1_epi16(127));
+
+			__m128i d = _mm_sub_epi16(_mm_or_si128(_mm_slli_epi16(tq, 1), _mm_set1_epi16(i16(p))), v);
+			d = _mm_madd_epi16(d, d);
+
+			// Only the first 4 lanes are channels
+			i32 error = _mm_cvtsi128_si32(_mm_add_epi32(d, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 1, 1, 1))));
+
+			if (error < best_error) {
+				best_error = error;
+				*pbit = p;
+
+				u16 values[8u];
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(values), tq);
+				foreach(i, 4u) q[i] = values[i];
+			}
+		}
+	}
+
+	// Mode 6: one subset, RGBA 7.7.7.7 endpoints with unique p-bits and 4 bit indices
+	SV_AUX void encode_bc7(const u8* block, const u8* min, const u8* max, u8* out)
+	{
+		constexpr i32 WEIGHTS[16u] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		i32 c0[4u], c1[4u];
+
+		foreach(i, 4u) {
+			i32 inset = (i32(max[i]) - i32(min[i])) >> 5;
+			c0[i] = i32(min[i]) + inset;
+			c1[i] = i32(max[i]) - inset;
+		}
+
+		u32 q0[4u], q1[4u], p0, p1;
+		quantize_bc7_endpoint(c0, q0, &p0);
+		quantize_bc7_endpoint(c1, q1, &p1);
+
+		i32 e0[4u], e1[4u];
+		foreach(i, 4u) {
+			e0[i] = i32((q0[i] << 1u) | p0);
+			e1[i] = i32((q1[i] << 1u) | p1);
+		}
+
+		i32 palette[16u][4u];
+		foreach(k, 16u) {
+			foreach(i, 4u) {
+				palette[k][i] = ((64 - WEIGHTS[k]) * e0[i] + WEIGHTS[k] * e1[i] + 32) >> 6;
+			}
+		}
+
+		__m128i palette16[8u];
+		foreach(k, 8u) palette16[k] = palette_pair(palette[k * 2u], palette[k * 2u + 1u], true);
+
+		u32 indices[16u];
+
+		foreach(p, 16u) {
+			indices[p] = closest_palette_entry(load_pixel16(block + p * 4u, true), palette16, 16u);
+		}
+
+		// The MSB of the first index is implicitly 0
+		if (indices[0u] & 8u) {
+
+			foreach(i, 4u) std::swap(q0[i], q1[i]);
+			std::swap(p0, p1);
+
+			foreach(p, 16u) indices[p] = 15u - indices[p];
+		}
+
+		BitWriter w = {};
+
+		write_bits(w, 1u << 6u, 7u);
+
+		foreach(i, 4u) {
+			write_bits(w, q0[i], 7u);
+			write_bits(w, q1[i], 7u);
+		}
+
+		write_bits(w, p0, 1u);
+		write_bits(w, p1, 1u);
+
+		write_bits(w, indices[0u], 3u);
+		for (u32 p = 1u; p < 16u; ++p)
+			write_bits(w, indices[p], 4u);
+
+		memcpy(out, w.data, 16u);
+	}
+
+	struct EncodeTaskData {
+		const u8*          src;
+		u8*                dst;
+		u32                width;
+		u32                height;
+		u32                by_begin;
+		u32                by_end;
+		TextureCompression compression;
+	};
+
+	SV_INTERNAL void encode_task(void* data)
+	{
+		EncodeTaskData& d = *reinterpret_cast<EncodeTaskData*>(data);
+
+		u32 block_size = (d.compression == TextureCompression_BC1) ? 8u : 16u;
+		u32 blocks_x = (d.width + 3u) / 4u;
+
+		u8 block[64u];
+		u8 min[4u];
+		u8 max[4u];
+
+		for (u32 by = d.by_begin; by < d.by_end; ++by) {
+			foreach(bx, blocks_x) {
+
+				fetch_block(d.src, d.width, d.height, bx, by, block);
+				block_bounds(block, min, max);
+
+				u8* out = d.dst + (by * blocks_x + bx) * block_size;
+
+				switch (d.compression) {
+
+				case TextureCompression_BC1:
+					encode_bc1_color(block, min, max, min[3u] < 128u, out);
+					break;
+
+				case TextureCompression_BC3:
+					encode_bc4(block, 3u, min[3u], max[3u], out);
+					encode_bc1_color(block, min, max, false, out + 8u);
+					break;
+
+				case TextureCompression_BC5:
+					encode_bc4(block, 0u, min[0u], max[0u], out);
+					encode_bc4(block, 1u, min[1u], max[1u], out + 8u);
+					break;
+
+				case TextureCompression_BC7:
+					encode_bc7(block, min, max, out);
+					break;
+
+				}
+			}
+		}
+	}
+
+	/////////////////////////////////////// COOKING ///////////////////////////////////////
+
+	SV_AUX Format texture_format(const TextureCookDesc& desc)
+	{
+		switch (desc.compression) {
+
+		case TextureCompression_BC1:
+			return desc.srgb ? Format_BC1_SRGB : Format_BC1_UNORM;
+
+		case TextureCompression_BC3:
+			return desc.srgb ? Format_BC3_SRGB : Format_BC3_UNORM;
+
+		case TextureCompression_BC5:
+			return Format_BC5_UNORM;
+
+		case TextureCompression_BC7:
+			return desc.srgb ? Format_BC7_SRGB : Format_BC7_UNORM;
+
+		default:
+			return desc.srgb ? Format_R8G8B8A8_SRGB : Format_R8G8B8A8_UNORM;
+		}
+	}
+
+	bool texture_cook(const void* rgba, u32 width, u32 height, const TextureCookDesc& desc, RawList& data, Format* format, u32* mip_levels)
+	{
+		if (rgba == NULL || width == 0u || height == 0u) return false;
+
+		u32 levels = desc.mipmaps ? texture_mip_count(width, height) : 1u;
+
+		u32 widths[TEXTURE_MIP_MAX];
+		u32 heights[TEXTURE_MIP_MAX];
+		size_t offsets[TEXTURE_MIP_MAX];
+
+		// Uncompressed levels
+		RawList rgba_levels;
+		{
+			size_t size = 0u;
+			u32 w = width;
+			u32 h = height;
+
+			foreach(level, levels) {
+
+				widths[level] = w;
+				heights[level] = h;
+				offsets[level] = size;
+				size += size_t(w) * size_t(h) * 4u;
+
+				w = SV_MAX(w / 2u, 1u);
+				h = SV_MAX(h / 2u, 1u);
+			}
+
+			rgba_levels.resize(size);
+			memcpy(rgba_levels.data(), rgba, size_t(width) * size_t(height) * 4u);
+		}
+
+		TaskContext context;
+
+		// Generate the mip chain in floating point, one task for each block of rows
+		if (levels > 1u) {
+
+			u32 pixel_count = width * height;
+			f32* src = (f32*)SV_ALLOCATE_MEMORY(sizeof(f32) * 4u * pixel_count, "Texture");
+			// Every level after the first one fits in the size of level 1
+			f32* dst = (f32*)SV_ALLOCATE_MEMORY(sizeof(f32) * 4u * widths[1] * heights[1], "Texture");
+
+			for (u32 begin = 0u; begin < pixel_count; begin += TEXTURE_TASK_ROWS * width) {
+
+				ConvertTaskData d;
+				d.src = (const u8*)rgba;
+				d.dst = src;
+				d.begin = begin;
+				d.end = SV_MIN(begin + TEXTURE_TASK_ROWS * width, pixel_count);
+				d.srgb = desc.srgb;
+
+				task_dispatch(convert_task, &d, sizeof(d), &context);
+			}
+
+			task_wait(context);
+
+			for (u32 level = 1u; level < levels; ++level) {
+
+				for (u32 y = 0u; y < heights[level]; y += TEXTURE_TASK_ROWS) {
+
+					MipTaskData d;
+					d.src = src;
+					d.dst = dst;
+					d.dst_rgba = rgba_levels.data() + offsets[level];
+					d.src_width = widths[level - 1u];
+					d.src_height = heights[level - 1u];
+					d.dst_width = widths[level];
+					d.y_begin = y;
+					d.y_end = SV_MIN(y + TEXTURE_TASK_ROWS, heights[level]);
+					d.srgb = desc.srgb;
+
+					task_dispatch(mip_task, &d, sizeof(d), &context);
+				}
+
+				task_wait(context);
+				std::swap(src, dst);
+			}
+
+			SV_FREE_MEMORY(src);
+			SV_FREE_MEMORY(dst);
+		}
+
+		*format = texture_format(desc);
+		*mip_levels = levels;
+
+		if (desc.compression == TextureCompression_None) {
+
+			data.resize(rgba_levels.size());
+			memcpy(data.data(), rgba_levels.data(), rgba_levels.size());
+			return true;
+		}
+
+		// Block compression
+		size_t size = 0u;
+		size_t dst_offsets[TEXTURE_MIP_MAX];
+
+		foreach(level, levels) {
+			dst_offsets[level] = size;
+			size += graphics_image_level_size(*format, widths[level], heights[level]);
+		}
+
+		data.resize(size);
+
+		foreach(level, levels) {
+
+			u32 blocks_y = (heights[level] + 3u) / 4u;
+
+			for (u32 by = 0u; by < blocks_y; by += TEXTURE_TASK_BLOCK_ROWS) {
+
+				EncodeTaskData d;
+				d.src = rgba_levels.data() + offsets[level];
+				d.dst = data.data() + dst_offsets[level];
+				d.width = widths[level];
+				d.height = heights[level];
+				d.by_begin = by;
+				d.by_end = SV_MIN(by + TEXTURE_TASK_BLOCK_ROWS, blocks_y);
+				d.compression = desc.compression;
+
+				task_dispatch(encode_task, &d, sizeof(d), &context);
+			}
+		}
+
+		task_wait(context);
+
+		return true;
+	}
+
+	bool texture_cook_file(const char* srcpath, const char* dstpath, const TextureCookDesc& desc)
+	{
+		void* rgba;
+		u32 width;
+		u32 height;
+
+		if (!load_image(srcpath, &rgba, &width, &height)) {
+			SV_LOG_ERROR("Can't load the image '%s'", srcpath);
+			return false;
+		}
+
+		f64 begin = timer_now();
+
+		RawList data;
+		Format format;
+		u32 mip_levels;
+
+		bool res = texture_cook(rgba, width, height, desc, data, &format, &mip_levels);
+		SV_FREE_MEMORY(rgba);
+
+		if (!res) {
+			SV_LOG_ERROR("Can't cook the texture '%s'", srcpath);
+			return false;
+		}
+
+		Serializer s;
+		serialize_begin(s);
+
+		serialize_u32(s, TEXTURE_COOKED_VERSION);
+		serialize_u32(s, u32(format));
+		serialize_u32(s, width);
+		serialize_u32(s, height);
+		serialize_u32(s, mip_levels);
+		serialize_u32(s, u32(data.size()));
+		serialize_write(s, data.data(), data.size());
+
+		SV_CHECK(serialize_end(s, dstpath));
+
+		SV_LOG_INFO("Texture cooked '%s': %ux%u, %u mips, %u bytes, %.2f ms", dstpath, width, height, mip_levels, u32(data.size()), f32((timer_now() - begin) * 1000.0));
+		return true;
+	}
+
+	bool texture_cooked_read(Deserializer& d, CookedTexture& texture)
+	{
+		SV_CHECK(deserialize_assert(d, sizeof(u32) * 6u));
+
+		u32 version;
+		deserialize_u32(d, version);
+
+		if (version > TEXTURE_COOKED_VERSION) {
+			SV_LOG_ERROR("Cooked texture version %u not supported", version);
+			return false;
+		}
+
+		u32 format;
+		deserialize_u32(d, format);
+		deserialize_u32(d, texture.width);
+		deserialize_u32(d, texture.height);
+		deserialize_u32(d, texture.mip_levels);
+		deserialize_u32(d, texture.size);
+
+		texture.format = Format(format);
+
+		switch (texture.format) {
+
+		case Format_R8G8B8A8_UNORM:
+		case Format_R8G8B8A8_SRGB:
+		case Format_BC1_UNORM:
+		case Format_BC1_SRGB:
+		case Format_BC3_UNORM:
+		case Format_BC3_SRGB:
+		case Format_BC5_UNORM:
+		case Format_BC7_UNORM:
+		case Format_BC7_SRGB:
+			break;
+
+		default:
+			SV_LOG_ERROR("Cooked texture format %u not supported", format);
+			return false;
+		}
+
+		if (texture.width == 0u || texture.height == 0u || texture.width > TEXTURE_SIZE_MAX || texture.height > TEXTURE_SIZE_MAX
+			|| texture.mip_levels == 0u || texture.mip_levels > texture_mip_count(texture.width, texture.height)) {
+			
+			SV_LOG_ERROR("Invalid cooked texture size");
+			return false;
+		}
+
+		// The GPU upload finds every level from the format and the dimensions
+		u64 size = 0u;
+		u32 w = texture.width;
+		u32 h = texture.height;
+
+		foreach(level, texture.mip_levels) {
+
+			size += graphics_image_level_size(texture.format, w, h);
+			w = SV_MAX(w / 2u, 1u);
+			h = SV_MAX(h / 2u, 1u);
+		}
+
+		if (size != texture.size) {
+			SV_LOG_ERROR("Invalid cooked texture data size");
+			return false;
+		}
+
+		SV_CHECK(deserialize_assert(d, texture.size));
+
+		texture.data = d.buff.data() + d.pos;
+		d.pos += texture.size;
+
+		return true;
+	}
+
+}
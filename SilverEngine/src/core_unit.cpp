@@ -18,3 +18,4 @@
 #include "core/sound_system.cpp"
 #include "core/asset_system.cpp"
 #include "core/event_system.cpp"
+#include "core/texture.cpp"
@@ -6,6 +6,7 @@
 
 #include "core/scene.h"
 #include "core/engine.h"
+#include "core/texture.h"
 #include "core/renderer/renderer_internal.h"
 
 #include "platform/os.h"
@@ -188,12 +189,32 @@ namespace sv {
 
     static bool command_save_scene(const char** args, u32 argc) {
 
-		if (argc) {
-			SV_LOG_ERROR("This command doesn't need arguments");
+		if (argc > 1u) {
+			SV_LOG_ERROR("This command need one or zero arguments");
 			return false;
 		}
 
-		if (!save_scene()) {
+		bool res;
+
+		// Without arguments the file keeps its format
+		if (argc == 0u) res = save_scene();
+		else {
+
+			bool compress = string_equals(args[0u], "compressed");
+			
+			if (!compress && !string_equals(args[0u], "raw")) {
+				SV_LOG_ERROR("Unknown format '%s', the formats are 'raw' and 'compressed'", args[0u]);
+				return false;
+			}
+			
+			char filepath[FILEPATH_SIZE + 1u] = "assets/scenes/";
+			string_append(filepath, get_scene_name(), FILEPATH_SIZE + 1u);
+			string_append(filepath, ".scene", FILEPATH_SIZE + 1u);
+			
+			res = save_scene(filepath, compress);
+		}
+
+		if (!res) {
 			SV_LOG_ERROR("Can't save the scene");
 			return false;
 		}
@@ -233,6 +254,236 @@ namespace sv {
 		return create_entity_model(parent, args[0]);
     }
 
+    static bool command_build_pack(const char** args, u32 argc) {
+
+		if (argc < 2u) {
+			SV_LOG_ERROR("This command need the pack filepath and at least one folder");
+			return false;
+		}
+
+		if (!pack_build(args[0u], args + 1u, argc - 1u)) {
+			SV_LOG_ERROR("Can't build the pack '%s'", args[0u]);
+			return false;
+		}
+
+		return true;
+    }
+
+    static bool command_pack_benchmark(const char** args, u32 argc) {
+
+		if (argc != 1u) {
+			SV_LOG_ERROR("This command need one argument");
+			return false;
+		}
+
+		return pack_benchmark(args[0u]);
+    }
+
+    static bool command_mesh_benchmark(const char** args, u32 argc) {
+
+		if (argc != 1u) {
+			SV_LOG_ERROR("This command need the mesh folder");
+			return false;
+		}
+
+		return mesh_load_benchmark(args[0u]);
+    }
+
+    static bool command_model_benchmark(const char** args, u32 argc) {
+
+		if (argc != 1u) {
+			SV_LOG_ERROR("This command need the .obj filepath");
+			return false;
+		}
+
+		return model_load_benchmark(args[0u]);
+    }
+
+    static bool command_cook_texture(const char** args, u32 argc) {
+
+		if (argc < 2u) {
+			SV_LOG_ERROR("This command need the source and the destination filepaths");
+			return false;
+		}
+
+		TextureCookDesc desc;
+
+		for (u32 i = 2u; i < argc; ++i) {
+
+			const char* arg = args[i];
+
+			if (string_equals(arg, "none")) desc.compression = TextureCompression_None;
+			else if (string_equals(arg, "bc1")) desc.compression = TextureCompression_BC1;
+			else if (string_equals(arg, "bc3")) desc.compression = TextureCompression_BC3;
+			else if (string_equals(arg, "bc5")) desc.compression = TextureCompression_BC5;
+			else if (string_equals(arg, "bc7")) desc.compression = TextureCompression_BC7;
+			else if (string_equals(arg, "srgb")) desc.srgb = true;
+			else if (string_equals(arg, "nomips")) desc.mipmaps = false;
+			else {
+				SV_LOG_ERROR("Unknown option '%s'", arg);
+				return false;
+			}
+		}
+
+		return texture_cook_file(args[0u], args[1u], desc);
+    }
+
+    static bool command_hash_map_benchmark(const char** args, u32 argc) {
+
+		if (argc > 1u) {
+			SV_LOG_ERROR("This command need one or zero arguments");
+			return false;
+		}
+
+		if (argc == 1u) {
+
+			const char* line = args[0u];
+			i32 count;
+			
+			if (!line_read_i32(line, count, NULL, 0u) || count <= 0) {
+				SV_LOG_ERROR("Invalid entry count '%s'", args[0u]);
+				return false;
+			}
+
+			hash_map_benchmark(u32(count));
+		}
+		else {
+
+			hash_map_benchmark(10000u);
+			hash_map_benchmark(100000u);
+			hash_map_benchmark(1000000u);
+		}
+
+		return true;
+    }
+
+    static bool command_serialize_benchmark(const char** args, u32 argc) {
+
+		if (argc > 1u) {
+			SV_LOG_ERROR("This command need one or zero arguments");
+			return false;
+		}
+
+		// 12 MB by default
+		u32 count = 1000000u;
+
+		if (argc == 1u) {
+
+			const char* line = args[0u];
+			i32 value;
+			
+			if (!line_read_i32(line, value, NULL, 0u) || value <= 0) {
+				SV_LOG_ERROR("Invalid element count '%s'", args[0u]);
+				return false;
+			}
+
+			count = u32(value);
+		}
+
+		serialize_benchmark(count);
+		return true;
+    }
+
+    static bool command_compression_benchmark(const char** args, u32 argc) {
+
+		if (argc != 1u) {
+			SV_LOG_ERROR("This command need the file or the folder to compress");
+			return false;
+		}
+
+		compression_benchmark(args[0u]);
+		return true;
+    }
+
+    static bool command_scene_benchmark(const char** args, u32 argc) {
+
+		if (argc > 1u) {
+			SV_LOG_ERROR("This command need one or zero arguments");
+			return false;
+		}
+
+		u32 count = 100000u;
+
+		if (argc == 1u) {
+
+			const char* line = args[0u];
+			i32 value;
+			
+			if (!line_read_i32(line, value, NULL, 0u) || value <= 0) {
+				SV_LOG_ERROR("Invalid entity count '%s'", args[0u]);
+				return false;
+			}
+
+			count = u32(value);
+		}
+
+		scene_serialize_benchmark(count);
+		return true;
+    }
+
+    static bool command_asset_residency(const char** args, u32 argc) {
+
+		asset_residency_log();
+		return true;
+    }
+
+    static bool command_asset_budget(const char** args, u32 argc) {
+
+		if (argc != 3u) {
+			SV_LOG_ERROR("This command need the asset type and the CPU and GPU budgets in MB (0 means no budget)");
+			return false;
+		}
+
+		f32 cpu_mb;
+		f32 gpu_mb;
+		const char* cpu_line = args[1u];
+		const char* gpu_line = args[2u];
+
+		if (!line_read_f32(cpu_line, cpu_mb) || !line_read_f32(gpu_line, gpu_mb) || cpu_mb < 0.f || gpu_mb < 0.f) {
+			SV_LOG_ERROR("Invalid budget");
+			return false;
+		}
+
+		return asset_type_set_budget(args[0u], size_t(f64(cpu_mb) * 1024.0 * 1024.0), size_t(f64(gpu_mb) * 1024.0 * 1024.0));
+    }
+
+    static bool command_asset_telemetry(const char** args, u32 argc) {
+
+		u32 count = 20u;
+
+		if (argc) {
+
+			i32 value;
+			const char* line = args[0u];
+
+			if (!line_read_i32(line, value, NULL, 0u) || value < 0) {
+				SV_LOG_ERROR("Invalid asset count");
+				return false;
+			}
+
+			count = u32(value);
+		}
+
+		asset_telemetry_log(count);
+		return true;
+    }
+
+    static bool command_asset_telemetry_dump(const char** args, u32 argc) {
+
+		if (argc != 1u) {
+			SV_LOG_ERROR("This command need the output file (.csv or .json)");
+			return false;
+		}
+
+		return asset_telemetry_dump(args[0u]);
+    }
+
+    static bool command_asset_telemetry_reset(const char** args, u32 argc) {
+
+		asset_telemetry_reset();
+		return true;
+    }
+
     void _console_initialize()
     {
 		console.buff = (char*)SV_ALLOCATE_MEMORY(CONSOLE_SIZE, "Console");
@@ -252,6 +503,20 @@ namespace sv {
 		register_command("save_scene", command_save_scene);
 		register_command("clear_scene", command_clear_scene);
 		register_command("create_entity_model", command_create_entity_model);
+		register_command("build_pack", command_build_pack);
+		register_command("pack_benchmark", command_pack_benchmark);
+		register_command("cook_texture", command_cook_texture);
+		register_command("mesh_benchmark", command_mesh_benchmark);
+		register_command("model_benchmark", command_model_benchmark);
+		register_command("hash_map_benchmark", command_hash_map_benchmark);
+		register_command("serialize_benchmark", command_serialize_benchmark);
+		register_command("compression_benchmark", command_compression_benchmark);
+		register_command("scene_benchmark", command_scene_benchmark);
+		register_command("asset_residency", command_asset_residency);
+		register_command("asset_budget", command_asset_budget);
+		register_command("asset_telemetry", command_asset_telemetry);
+		register_command("asset_telemetry_dump", command_asset_telemetry_dump);
+		register_command("asset_telemetry_reset", command_asset_telemetry_reset);
 	
 		//  Recive command history from last execution
 		{
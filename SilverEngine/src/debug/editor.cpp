@@ -164,10 +164,21 @@ namespace sv {
 		CreateTagData create_tag_data;
 
 		char next_scene_name[SCENE_NAME_SIZE + 1u] = "";
+
+		// Taken when the play mode starts, restored when it ends
+		SceneSnapshot* play_snapshot = NULL;
+		// A plugin was reloaded since the game was initialized, the game is reset when the play mode starts
+		bool game_code_changed = false;
     };
 
     GlobalEditorData editor;
 
+	SV_AUX void free_play_snapshot()
+	{
+		scene_snapshot_free(editor.play_snapshot);
+		editor.play_snapshot = NULL;
+	}
+
 	SV_AUX bool is_entity_selected(Entity entity)
 	{
 		for (Entity e : editor.selected_entities)
@@ -226,6 +237,11 @@ namespace sv {
 		}
     }
 
+    SV_INTERNAL void on_plugin_reload()
+    {
+		editor.game_code_changed = true;
+    }
+
     /////////////////////////////////////////////// KEY SHORTCUTS //////////////////////////////////////
 
     SV_AUX void update_key_shortcuts()
@@ -912,6 +928,7 @@ namespace sv {
 		load_asset_from_file(editor.image, "$system/images/editor.png");
 
 		event_register("user_callbacks_initialize", show_reset_popup, 0u);
+		event_register("reload_plugin", on_plugin_reload, 0u);
 
 		dev.engine_state = EngineState_ProjectManagement;
 		_gui_load("PROJECT");
@@ -937,6 +954,7 @@ namespace sv {
 		SV_CHECK(_gui_close());
 
 		unload_asset(editor.image);
+		free_play_snapshot();
 
 		graphics_destroy(editor.offscreen_editor);
 		graphics_destroy(editor.offscreen_game);
@@ -1825,6 +1843,31 @@ namespace sv {
 						}
 					}
 
+					// The shared prefab components can be copied to the entity and edited without changing the prefab
+					Prefab prefab = get_entity_prefab(selected);
+
+					if (prefab) {
+
+						gui_separator(1);
+						gui_text("Override");
+						gui_push_id("Override");
+
+						foreach(i, count) {
+
+							CompID comp_id = CompID(i);
+
+							if (!has_prefab_component(prefab, comp_id) || get_entity_component(selected, comp_id) != get_prefab_component(prefab, comp_id))
+								continue;
+
+							if (gui_button(get_component_name(comp_id), comp_id)) {
+
+								override_entity_component(selected, comp_id);
+							}
+						}
+
+						gui_pop_id();
+					}
+
 					gui_end_popup();
 				}
 			}
@@ -2037,6 +2080,8 @@ namespace sv {
 				gui_pop_id();
 			}
 
+			gui_checkbox("Compress meshes", data.model_info.compress_meshes, 0u);
+
 			if (gui_button("Import")) {
 
 				char dst[FILEPATH_SIZE + 1u];
@@ -3255,6 +3300,8 @@ namespace sv {
 			case EngineState_ProjectManagement:
 			{
 				_engine_close_project();
+				free_play_snapshot();
+				editor.game_code_changed = false;
 				editor.selected_entities.reset();
 				exit = true;
 				engine.update_scene = false;
@@ -3268,8 +3315,23 @@ namespace sv {
 			{
 				SV_LOG_INFO("Starting edit state");
 				// TODO: Handle error
-				if (dev.engine_state != EngineState_ProjectManagement)
-					_engine_reset_game(get_scene_name());
+				if (dev.engine_state != EngineState_ProjectManagement) {
+
+					// The game is kept loaded, only the ECS is restored. The scene file is loaded if the snapshot can't be restored
+					bool restored = false;
+
+					if (editor.play_snapshot) {
+
+						event_dispatch("close_game", nullptr);
+						restored = scene_snapshot_restore(editor.play_snapshot);
+						event_dispatch("initialize_game", nullptr);
+					}
+					
+					free_play_snapshot();
+					
+					if (!restored)
+						_engine_reset_game(get_scene_name());
+				}
 				
 				//dev.draw_debug_camera = true;
 				editor.debug_draw = true;
@@ -3285,9 +3347,17 @@ namespace sv {
 			
 				if (dev.engine_state == EngineState_Edit) {
 
-					// TODO: handle error
-					save_scene();
-					_engine_reset_game(get_scene_name());
+					// The play starts from the current state of the ECS, the scene file is not saved or loaded.
+					// The snapshot is restored when the play ends
+					free_play_snapshot();
+					editor.play_snapshot = scene_snapshot_capture();
+
+					// The game is reloaded only if the code changed, the ECS is restored from the snapshot after the reload
+					if (editor.game_code_changed) {
+
+						editor.game_code_changed = false;
+						_engine_reset_game(get_scene_name(), editor.play_snapshot);
+					}
 
 					//dev.draw_debug_camera = false;
 					editor.selected_entities.reset();
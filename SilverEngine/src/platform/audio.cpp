@@ -2,6 +2,7 @@
 
 #include "utils/allocators.h"
 #include "platform/os.h"
+#include "core/asset_system.h"
 
 #include <windows.h>
 #include <xaudio2.h>
@@ -20,6 +21,9 @@ namespace sv {
     static bool load_sound_asset(void* asset, const char* name, const char* filepath);
     static bool destroy_sound_asset(void* asset, const char* name);
     static bool reload_sound_asset(void* asset, const char* name, const char* filepath);
+	static void* prepare_sound_asset(const char* filepath);
+	static bool load_prepared_sound_asset(void* asset, const char* name, const char* filepath, void* prepared);
+	static void sound_asset_size(void* asset, size_t* cpu_size, size_t* gpu_size);
 
 	struct AudioSource {
 		IXAudio2SourceVoice* source;
@@ -151,6 +155,9 @@ namespace sv {
 		desc.load_file_fn = load_sound_asset;
 		desc.free_fn = destroy_sound_asset;
 		desc.reload_file_fn = reload_sound_asset;
+		desc.prepare_file_fn = prepare_sound_asset;
+		desc.load_prepared_fn = load_prepared_sound_asset;
+		desc.size_fn = sound_asset_size;
 		desc.unused_time = 3.f;
 
 		SV_CHECK(register_asset_type(&desc));
@@ -203,12 +210,13 @@ namespace sv {
 		return true;
     }
 
-    static bool load_sound_asset(void* asset, const char* name, const char* filepath)
+    SV_AUX bool load_sound_file(SoundInternal& sound, const char* filepath)
     {
-		SoundInternal& sound = *new(asset) SoundInternal();
-
 		RawList data;
+
+		f64 begin = timer_now();
 		SV_CHECK(file_read_binary(filepath, data));
+		asset_telemetry_read(timer_now() - begin, data.size());
 
 		DWORD chunk_size;
 		DWORD chunk_position;
@@ -257,6 +265,37 @@ namespace sv {
 		return true;
     }
 
+    static bool load_sound_asset(void* asset, const char* name, const char* filepath)
+    {
+		SoundInternal& sound = *new(asset) SoundInternal();
+		return load_sound_file(sound, filepath);
+    }
+
+	static void* prepare_sound_asset(const char* filepath)
+	{
+		SoundInternal* sound = SV_ALLOCATE_STRUCT(SoundInternal, "Audio");
+
+		if (!load_sound_file(*sound, filepath)) {
+			SV_FREE_STRUCT(sound);
+			return NULL;
+		}
+
+		return sound;
+	}
+
+	static bool load_prepared_sound_asset(void* asset, const char* name, const char* filepath, void* prepared)
+	{
+		SoundInternal* data = reinterpret_cast<SoundInternal*>(prepared);
+		SoundInternal& sound = *new(asset) SoundInternal();
+
+		// Take the wave data
+		sound.wave_format = data->wave_format;
+		sound.data.swap(data->data);
+		
+		SV_FREE_STRUCT(data);
+		return true;
+	}
+
     static bool destroy_sound_asset(void* asset, const char* name)
     {
 		SoundInternal& sound = *reinterpret_cast<SoundInternal*>(asset);
@@ -264,6 +303,12 @@ namespace sv {
 		return true;
     }
 
+	static void sound_asset_size(void* asset, size_t* cpu_size, size_t* gpu_size)
+	{
+		SoundInternal& sound = *reinterpret_cast<SoundInternal*>(asset);
+		*cpu_size += sound.data.capacity();
+	}
+
     static bool reload_sound_asset(void* asset, const char* name, const char* filepath)
     {
 		SV_CHECK(destroy_sound_asset(asset, name));
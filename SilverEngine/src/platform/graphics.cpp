@@ -3,6 +3,7 @@
 #include "graphics_internal.h"
 
 #include "vulkan/graphics_vulkan.h"
+#include "null/graphics_null.h"
 #include "platform/graphics.h"
 
 namespace sv {
@@ -24,19 +25,40 @@ namespace sv {
     static List<Primitive*> primitives_to_destroy;
     static std::mutex primitives_to_destroy_mutex;
 
+    static GraphicsAPI g_RequestedAPI = GraphicsAPI_Vulkan;
+
+    void _graphics_api_request(GraphicsAPI api)
+    {
+		g_RequestedAPI = api;
+    }
+
     bool _graphics_initialize()
     {
 		bool res;
 
 		// Initialize API
-		SV_LOG_INFO("Trying to initialize vulkan device");
-		graphics_vulkan_device_prepare(g_Device);
-		res = g_Device.initialize();
+		if (g_RequestedAPI == GraphicsAPI_Null) {
+
+			SV_LOG_INFO("Trying to initialize null device");
+			graphics_null_device_prepare(g_Device);
+			res = g_Device.initialize();
+
+			if (!res) {
+				SV_LOG_ERROR("Can't initialize null device");
+			}
+			else SV_LOG_INFO("Null device initialized successfuly");
+		}
+		else {
+			
+			SV_LOG_INFO("Trying to initialize vulkan device");
+			graphics_vulkan_device_prepare(g_Device);
+			res = g_Device.initialize();
 		
-		if (!res) {
-			SV_LOG_ERROR("Can't initialize vulkan device");
+			if (!res) {
+				SV_LOG_ERROR("Can't initialize vulkan device");
+			}
+			else SV_LOG_INFO("Vulkan device initialized successfuly");
 		}
-		else SV_LOG_INFO("Vulkan device initialized successfuly");
 
 		// Create default states
 		{
@@ -373,6 +395,11 @@ namespace sv {
 		g_Device.frame_end();
     }
 
+    void graphics_device_stats(GraphicsDeviceStats* stats)
+    {
+		g_Device.stats(stats);
+    }
+
     void graphics_present_image(GPUImage* image, GPUImageLayout layout)
     {
 		g_PipelineState.present_image = image;
@@ -569,15 +596,47 @@ namespace sv {
 		case Format_BC4_SNORM:
 		case Format_BC5_UNORM:
 		case Format_BC5_SNORM:
+		case Format_BC7_UNORM:
+		case Format_BC7_SRGB:
 		default:
 			SV_LOG_INFO("Unknown format size");
 			return 0u;
 		}
     }
 
+    bool graphics_format_is_compressed(Format format)
+    {
+		return (format >= Format_BC1_UNORM && format <= Format_BC5_SNORM) || format == Format_BC7_UNORM || format == Format_BC7_SRGB;
+    }
+
+    u32 graphics_image_level_size(Format format, u32 width, u32 height)
+    {
+		switch (format)
+		{
+		case Format_BC1_UNORM:
+		case Format_BC1_SRGB:
+		case Format_BC4_UNORM:
+		case Format_BC4_SNORM:
+			return ((width + 3u) / 4u) * ((height + 3u) / 4u) * 8u;
+
+		case Format_BC2_UNORM:
+		case Format_BC2_SRGB:
+		case Format_BC3_UNORM:
+		case Format_BC3_SRGB:
+		case Format_BC5_UNORM:
+		case Format_BC5_SNORM:
+		case Format_BC7_UNORM:
+		case Format_BC7_SRGB:
+			return ((width + 3u) / 4u) * ((height + 3u) / 4u) * 16u;
+
+		default:
+			return width * height * graphics_format_size(format);
+		}
+    }
+
     GraphicsAPI graphics_api_get()
     {
-		return GraphicsAPI_Vulkan;
+		return g_Device.api;
     }
 
     ////////////////////////////////////////// PRIMITIVES /////////////////////////////////////////
@@ -655,6 +714,7 @@ namespace sv {
 		p->info.format = desc->format;
 		p->info.width = desc->width;
 		p->info.height = desc->height;
+		p->info.mip_levels = desc->mip_levels;
 		p->info.type = desc->type;
 
 		return true;
@@ -843,6 +903,12 @@ namespace sv {
 		}
     }
 
+    bool graphics_is_resident(Primitive* primitive)
+    {
+		if (primitive == nullptr) return false;
+		return g_Device.is_resident(reinterpret_cast<Primitive_internal*>(primitive));
+    }
+
     CommandList graphics_commandlist_begin()
     {
 		CommandList cmd = g_Device.commandlist_begin();
@@ -1776,6 +1842,33 @@ namespace sv {
 		g_PipelineState.graphics[cmd].flags |= GraphicsPipelineState_RenderPass;
     }
 
+    u32 graphics_pipeline_prewarm(const GraphicsPipelineDesc* descs, u32 count)
+    {
+		u32 ready = 0u;
+		GraphicsState state;
+
+		foreach(i, count) {
+
+			const GraphicsPipelineDesc& d = descs[i];
+
+			state = g_DefGraphicsState;
+			state.vertexShader = reinterpret_cast<Shader_internal*>(d.vertex_shader);
+			state.pixelShader = reinterpret_cast<Shader_internal*>(d.pixel_shader);
+			state.geometryShader = reinterpret_cast<Shader_internal*>(d.geometry_shader);
+			if (d.input_layout_state) state.inputLayoutState = reinterpret_cast<InputLayoutState_internal*>(d.input_layout_state);
+			if (d.blend_state) state.blendState = reinterpret_cast<BlendState_internal*>(d.blend_state);
+			if (d.depth_stencil_state) state.depthStencilState = reinterpret_cast<DepthStencilState_internal*>(d.depth_stencil_state);
+			if (d.rasterizer_state) state.rasterizerState = reinterpret_cast<RasterizerState_internal*>(d.rasterizer_state);
+			state.topology = d.topology;
+			state.renderPass = reinterpret_cast<RenderPass_internal*>(d.render_pass);
+
+			if (g_Device.pipeline_prewarm(state)) ++ready;
+			else SV_LOG_WARNING("Can't prewarm the pipeline %u", i);
+		}
+
+		return ready;
+    }
+
     ////////////////////////////////////////// DRAW CALLS /////////////////////////////////////////
 
     void graphics_draw(u32 vertexCount, u32 instanceCount, u32 startVertex, u32 startInstance, CommandList cmd)
@@ -203,6 +203,10 @@ namespace sv {
     typedef void(*FNP_graphics_api_event_mark)(const char*, CommandList);
     typedef void(*FNP_graphics_api_event_end)(CommandList);
 
+    typedef bool(*FNP_graphics_api_pipeline_prewarm)(GraphicsState&);
+    typedef void(*FNP_graphics_api_stats)(GraphicsDeviceStats*);
+    typedef bool(*FNP_graphics_api_is_resident)(Primitive_internal*);
+
     struct GraphicsDevice {
 
 		FNP_graphics_api_initialize	initialize;
@@ -239,6 +243,10 @@ namespace sv {
 		FNP_graphics_api_event_mark	event_mark;
 		FNP_graphics_api_event_end	event_end;
 
+		FNP_graphics_api_pipeline_prewarm pipeline_prewarm;
+		FNP_graphics_api_stats			  stats;
+		FNP_graphics_api_is_resident	  is_resident;
+
 		// TODO
 		std::unique_ptr<SizedInstanceAllocator> bufferAllocator;
 		std::mutex								bufferMutex;
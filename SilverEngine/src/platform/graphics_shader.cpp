@@ -197,6 +197,10 @@ namespace sv {
 		ShaderDesc desc;
 		desc.shaderType = shaderType;
 
+		// The null device doesn't need bytecode
+		if (graphics_api_get() == GraphicsAPI_Null)
+			return graphics_shader_create(&desc, pShader);
+
 #if SV_GFX
 		if (alwaisCompile || !bin_read(hash, data, true)) {
 #else
@@ -230,6 +234,9 @@ namespace sv {
 			ShaderDesc desc;
 			desc.shaderType = shaderType;
 
+			if (graphics_api_get() == GraphicsAPI_Null)
+				return graphics_shader_create(&desc, pShader);
+
 #if SV_GFX
 			if (alwaisCompile || !bin_read(hash, data, true)) {
 #else
@@ -0,0 +1,554 @@
+#include "defines.h"
+
+#include "graphics_null.h"
+
+#include <unordered_set>
+
+namespace sv {
+
+	/*
+	  Headless device. Primitives only keep the info stored by the graphics layer, and every
+	  command is recorded per commandlist and merged at the end of the frame.
+	*/
+
+	struct CommandListNull {
+		List<GraphicsCommand> trace;
+		GraphicsStats		  stats;
+		GraphicsDeviceStats	  device_stats;
+
+		// Hashes of the resources bound in this frame, simulates the descriptor set cache
+		std::unordered_set<u64> descriptor_sets;
+	};
+
+	struct Graphics_null {
+
+		Mutex mutexCMD;
+		u32   activeCMDCount;
+
+		CommandListNull cmd[GraphicsLimit_CommandList];
+
+		bool				  trace_enabled;
+		List<GraphicsCommand> last_trace;
+		GraphicsStats		  last_stats;
+		GraphicsStats		  total_stats;
+		GraphicsDeviceStats	  last_device_stats;
+
+		std::atomic<u64> created_bytes;
+	};
+
+    static std::unique_ptr<Graphics_null> g_Null;
+
+	SV_AUX void add_stats(GraphicsStats& dst, const GraphicsStats& src)
+	{
+		dst.draw_calls += src.draw_calls;
+		dst.dispatch_calls += src.dispatch_calls;
+		dst.vertex_count += src.vertex_count;
+		dst.index_count += src.index_count;
+		dst.instance_count += src.instance_count;
+		dst.pipeline_changes += src.pipeline_changes;
+		dst.resource_changes += src.resource_changes;
+		dst.renderpass_count += src.renderpass_count;
+		dst.buffer_updates += src.buffer_updates;
+		dst.uploaded_bytes += src.uploaded_bytes;
+		dst.barrier_count += src.barrier_count;
+		dst.blit_count += src.blit_count;
+		dst.clear_count += src.clear_count;
+		dst.commandlist_count += src.commandlist_count;
+	}
+
+	SV_AUX GraphicsCommand& record_command(GraphicsCommandType type, const void* primitive, CommandList cmd)
+	{
+		CommandListNull& c = g_Null->cmd[cmd];
+
+		GraphicsCommand& command = c.trace.emplace_back();
+		command.type = type;
+		command.cmd = cmd;
+		command.primitive = reinterpret_cast<const Primitive*>(primitive);
+		return command;
+	}
+
+	// A set for each shader stage, the sets with the same resources than other set of the frame are hits
+	SV_INTERNAL void request_descriptor_sets(const GraphicsState& state, CommandList cmd)
+	{
+		CommandListNull& c = g_Null->cmd[cmd];
+		GraphicsDeviceStats& stats = c.device_stats;
+
+		const Shader_internal* shaders[] = { state.vertexShader, state.pixelShader, state.geometryShader };
+		ShaderType types[] = { ShaderType_Vertex, ShaderType_Pixel, ShaderType_Geometry };
+
+		foreach(i, 3u) {
+
+			if (shaders[i] == NULL) continue;
+
+			ShaderType type = types[i];
+			size_t hash = 0u;
+			hash_combine(hash, size_t(shaders[i]));
+
+			foreach(j, state.constant_buffer_count[type]) hash_combine(hash, size_t(state.constant_buffers[type][j]));
+			foreach(j, state.shader_resource_count[type]) hash_combine(hash, size_t(state.shader_resources[type][j]));
+			foreach(j, state.unordered_access_view_count[type]) hash_combine(hash, size_t(state.unordered_access_views[type][j]));
+			foreach(j, state.samplersCount[type]) hash_combine(hash, size_t(state.samplers[type][j]));
+
+			++stats.descriptor_set_requests;
+
+			if (!c.descriptor_sets.insert(u64(hash)).second) {
+				++stats.descriptor_set_hits;
+			}
+			else {
+				++stats.descriptor_sets_written;
+				stats.descriptor_writes += state.constant_buffer_count[type] + state.shader_resource_count[type]
+					+ state.unordered_access_view_count[type] + state.samplersCount[type];
+			}
+		}
+	}
+
+	// The same state tracking than the real devices, without binding anything
+	SV_INTERNAL u64 update_graphics_state(CommandList cmd)
+	{
+		GraphicsState& state = graphics_state_get().graphics[cmd];
+		u64 flags = state.flags;
+
+		if (flags == 0u) return 0u;
+
+		GraphicsStats& stats = g_Null->cmd[cmd].stats;
+
+		if (flags & (
+				GraphicsPipelineState_Shader |
+				GraphicsPipelineState_InputLayoutState |
+				GraphicsPipelineState_BlendState |
+				GraphicsPipelineState_DepthStencilState |
+				GraphicsPipelineState_RasterizerState |
+				GraphicsPipelineState_Topology |
+				GraphicsPipelineState_RenderPass
+				)) {
+			++stats.pipeline_changes;
+		}
+
+		if (flags & (GraphicsPipelineState_ConstantBuffer | GraphicsPipelineState_ShaderResource | GraphicsPipelineState_UnorderedAccessView | GraphicsPipelineState_Sampler)) {
+			++stats.resource_changes;
+			request_descriptor_sets(state, cmd);
+		}
+
+		state.flags = 0u;
+		return flags;
+	}
+
+    void graphics_null_device_prepare(GraphicsDevice& device)
+    {
+		device.initialize			= graphics_null_initialize;
+		device.close				= graphics_null_close;
+		device.get				= graphics_null_get;
+		device.create				= graphics_null_create;
+		device.destroy				= graphics_null_destroy;
+		device.commandlist_begin		= graphics_null_commandlist_begin;
+		device.commandlist_last			= graphics_null_commandlist_last;
+		device.commandlist_count		= graphics_null_commandlist_count;
+		device.renderpass_begin			= graphics_null_renderpass_begin;
+		device.renderpass_end			= graphics_null_renderpass_end;
+		device.swapchain_resize			= graphics_null_swapchain_resize;
+		device.gpu_wait				= graphics_null_gpu_wait;
+		device.frame_begin			= graphics_null_frame_begin;
+		device.frame_end			= graphics_null_frame_end;
+		device.draw				    = graphics_null_draw;
+		device.draw_indexed			= graphics_null_draw_indexed;
+		device.dispatch             = graphics_null_dispatch;
+		device.image_clear			= graphics_null_image_clear;
+		device.image_blit			= graphics_null_image_blit;
+		device.buffer_update		= graphics_null_buffer_update;
+		device.barrier				= graphics_null_barrier;
+		device.event_begin			= graphics_null_event_begin;
+		device.event_mark			= graphics_null_event_mark;
+		device.event_end			= graphics_null_event_end;
+		device.pipeline_prewarm		= graphics_null_pipeline_prewarm;
+		device.stats				= graphics_null_device_stats;
+		device.is_resident			= graphics_null_is_resident;
+
+		device.bufferAllocator			= std::make_unique<SizedInstanceAllocator>(sizeof(GPUBuffer_internal), 200u);
+		device.imageAllocator			= std::make_unique<SizedInstanceAllocator>(sizeof(GPUImage_internal), 200u);
+		device.samplerAllocator			= std::make_unique<SizedInstanceAllocator>(sizeof(Sampler_internal), 200u);
+		device.shaderAllocator			= std::make_unique<SizedInstanceAllocator>(sizeof(Shader_internal), 200u);
+		device.renderPassAllocator		= std::make_unique<SizedInstanceAllocator>(sizeof(RenderPass_internal), 200u);
+		device.inputLayoutStateAllocator	= std::make_unique<SizedInstanceAllocator>(sizeof(InputLayoutState_internal), 200u);
+		device.blendStateAllocator		= std::make_unique<SizedInstanceAllocator>(sizeof(BlendState_internal), 200u);
+		device.depthStencilStateAllocator	= std::make_unique<SizedInstanceAllocator>(sizeof(DepthStencilState_internal), 200u);
+		device.rasterizerStateAllocator		= std::make_unique<SizedInstanceAllocator>(sizeof(RasterizerState_internal), 200u);
+
+		device.api = GraphicsAPI_Null;
+    }
+
+    bool graphics_null_initialize()
+    {
+		g_Null = std::make_unique<Graphics_null>();
+
+		SV_CHECK(mutex_create(g_Null->mutexCMD));
+
+		g_Null->activeCMDCount = 0u;
+		g_Null->trace_enabled = true;
+		g_Null->last_stats = {};
+		g_Null->total_stats = {};
+		g_Null->created_bytes = 0u;
+
+		foreach(i, GraphicsLimit_CommandList) {
+			g_Null->cmd[i].stats = {};
+		}
+
+		return true;
+    }
+
+    bool graphics_null_close()
+    {
+		mutex_destroy(g_Null->mutexCMD);
+		g_Null.reset();
+		return true;
+    }
+
+    void* graphics_null_get()
+    {
+		return g_Null.get();
+    }
+
+    bool graphics_null_create(GraphicsPrimitiveType type, const void* desc, Primitive_internal* ptr)
+    {
+		switch (type)
+		{
+
+		case GraphicsPrimitiveType_Buffer:
+		{
+			new(ptr) GPUBuffer_internal();
+			const GPUBufferDesc& d = *reinterpret_cast<const GPUBufferDesc*>(desc);
+			if (d.data) g_Null->created_bytes += d.size;
+		}
+		break;
+
+		case GraphicsPrimitiveType_Image:
+		{
+			new(ptr) GPUImage_internal();
+			const GPUImageDesc& d = *reinterpret_cast<const GPUImageDesc*>(desc);
+			if (d.data) g_Null->created_bytes += d.size;
+		}
+		break;
+
+		case GraphicsPrimitiveType_Shader:
+			new(ptr) Shader_internal();
+			break;
+
+		case GraphicsPrimitiveType_Sampler:
+			new(ptr) Sampler_internal();
+			break;
+
+		case GraphicsPrimitiveType_RenderPass:
+			new(ptr) RenderPass_internal();
+			break;
+
+		case GraphicsPrimitiveType_InputLayoutState:
+			new(ptr) InputLayoutState_internal();
+			break;
+
+		case GraphicsPrimitiveType_BlendState:
+			new(ptr) BlendState_internal();
+			break;
+
+		case GraphicsPrimitiveType_DepthStencilState:
+			new(ptr) DepthStencilState_internal();
+			break;
+
+		case GraphicsPrimitiveType_RasterizerState:
+			new(ptr) RasterizerState_internal();
+			break;
+
+		default:
+			return false;
+
+		}
+
+		return true;
+    }
+
+    bool graphics_null_destroy(Primitive_internal* primitive)
+    {
+		switch (primitive->type)
+		{
+		case GraphicsPrimitiveType_Buffer:
+			reinterpret_cast<GPUBuffer_internal*>(primitive)->~GPUBuffer_internal();
+			break;
+		case GraphicsPrimitiveType_Image:
+			reinterpret_cast<GPUImage_internal*>(primitive)->~GPUImage_internal();
+			break;
+		case GraphicsPrimitiveType_Sampler:
+			reinterpret_cast<Sampler_internal*>(primitive)->~Sampler_internal();
+			break;
+		case GraphicsPrimitiveType_Shader:
+			reinterpret_cast<Shader_internal*>(primitive)->~Shader_internal();
+			break;
+		case GraphicsPrimitiveType_RenderPass:
+			reinterpret_cast<RenderPass_internal*>(primitive)->~RenderPass_internal();
+			break;
+		case GraphicsPrimitiveType_InputLayoutState:
+			reinterpret_cast<InputLayoutState_internal*>(primitive)->~InputLayoutState_internal();
+			break;
+		case GraphicsPrimitiveType_BlendState:
+			reinterpret_cast<BlendState_internal*>(primitive)->~BlendState_internal();
+			break;
+		case GraphicsPrimitiveType_DepthStencilState:
+			reinterpret_cast<DepthStencilState_internal*>(primitive)->~DepthStencilState_internal();
+			break;
+		case GraphicsPrimitiveType_RasterizerState:
+			reinterpret_cast<RasterizerState_internal*>(primitive)->~RasterizerState_internal();
+			break;
+		}
+		return true;
+    }
+
+    CommandList graphics_null_commandlist_begin()
+    {
+		SV_LOCK_GUARD(g_Null->mutexCMD, lock);
+		SV_ASSERT(g_Null->activeCMDCount < GraphicsLimit_CommandList);
+
+		CommandList index = g_Null->activeCMDCount++;
+
+		CommandListNull& c = g_Null->cmd[index];
+		c.trace.reset();
+		c.stats = {};
+		c.stats.commandlist_count = 1u;
+		c.device_stats = {};
+		c.descriptor_sets.clear();
+
+		return index;
+    }
+
+    CommandList graphics_null_commandlist_last()
+    {
+		SV_LOCK_GUARD(g_Null->mutexCMD, lock);
+		SV_ASSERT(g_Null->activeCMDCount != 0);
+		return g_Null->activeCMDCount - 1u;
+    }
+
+    u32 graphics_null_commandlist_count()
+    {
+		SV_LOCK_GUARD(g_Null->mutexCMD, lock);
+		return g_Null->activeCMDCount;
+    }
+
+    void graphics_null_renderpass_begin(CommandList cmd)
+    {
+		GraphicsState& state = graphics_state_get().graphics[cmd];
+
+		GraphicsCommand& c = record_command(GraphicsCommandType_RenderPassBegin, state.renderPass, cmd);
+		c.args[0] = state.renderPass ? u32(state.renderPass->info.attachments.size()) : 0u;
+
+		++g_Null->cmd[cmd].stats.renderpass_count;
+    }
+
+    void graphics_null_renderpass_end(CommandList cmd)
+    {
+		GraphicsState& state = graphics_state_get().graphics[cmd];
+		record_command(GraphicsCommandType_RenderPassEnd, state.renderPass, cmd);
+    }
+
+    void graphics_null_swapchain_resize()
+    {
+    }
+
+    void graphics_null_gpu_wait()
+    {
+    }
+
+    void graphics_null_frame_begin()
+    {
+    }
+
+    void graphics_null_frame_end()
+    {
+		SV_LOCK_GUARD(g_Null->mutexCMD, lock);
+
+		g_Null->last_trace.reset();
+		g_Null->last_stats = {};
+		g_Null->last_stats.uploaded_bytes = g_Null->created_bytes.exchange(0u);
+
+		GraphicsDeviceStats& device_stats = g_Null->last_device_stats;
+		device_stats = {};
+
+		foreach(i, g_Null->activeCMDCount) {
+
+			CommandListNull& c = g_Null->cmd[i];
+
+			if (g_Null->trace_enabled)
+				g_Null->last_trace.insert(c.trace);
+
+			add_stats(g_Null->last_stats, c.stats);
+
+			device_stats.descriptor_set_requests += c.device_stats.descriptor_set_requests;
+			device_stats.descriptor_set_hits += c.device_stats.descriptor_set_hits;
+			device_stats.descriptor_sets_written += c.device_stats.descriptor_sets_written;
+			device_stats.descriptor_writes += c.device_stats.descriptor_writes;
+			device_stats.constant_uploads += c.device_stats.constant_uploads;
+			device_stats.constant_upload_bytes += c.device_stats.constant_upload_bytes;
+		}
+
+		add_stats(g_Null->total_stats, g_Null->last_stats);
+
+		g_Null->activeCMDCount = 0u;
+    }
+
+    void graphics_null_draw(u32 vertexCount, u32 instanceCount, u32 startVertex, u32 startInstance, CommandList cmd)
+    {
+		u64 flags = update_graphics_state(cmd);
+
+		GraphicsState& state = graphics_state_get().graphics[cmd];
+		GraphicsCommand& c = record_command(GraphicsCommandType_Draw, state.vertexShader, cmd);
+		c.state_flags = flags;
+		c.args[0] = vertexCount;
+		c.args[1] = instanceCount;
+		c.args[2] = startVertex;
+		c.args[3] = startInstance;
+
+		GraphicsStats& stats = g_Null->cmd[cmd].stats;
+		++stats.draw_calls;
+		stats.vertex_count += u64(vertexCount) * u64(instanceCount);
+		stats.instance_count += instanceCount;
+    }
+
+    void graphics_null_draw_indexed(u32 indexCount, u32 instanceCount, u32 startIndex, u32 startVertex, u32 startInstance, CommandList cmd)
+    {
+		u64 flags = update_graphics_state(cmd);
+
+		GraphicsState& state = graphics_state_get().graphics[cmd];
+		GraphicsCommand& c = record_command(GraphicsCommandType_DrawIndexed, state.vertexShader, cmd);
+		c.state_flags = flags;
+		c.args[0] = indexCount;
+		c.args[1] = instanceCount;
+		c.args[2] = startIndex;
+		c.args[3] = startVertex;
+		c.args[4] = startInstance;
+
+		GraphicsStats& stats = g_Null->cmd[cmd].stats;
+		++stats.draw_calls;
+		stats.index_count += u64(indexCount) * u64(instanceCount);
+		stats.instance_count += instanceCount;
+    }
+
+	void graphics_null_dispatch(u32 group_count_x, u32 group_count_y, u32 group_count_z, CommandList cmd)
+	{
+		ComputeState& state = graphics_state_get().compute[cmd];
+		state.update_resources = false;
+
+		GraphicsCommand& c = record_command(GraphicsCommandType_Dispatch, state.compute_shader, cmd);
+		c.args[0] = group_count_x;
+		c.args[1] = group_count_y;
+		c.args[2] = group_count_z;
+
+		++g_Null->cmd[cmd].stats.dispatch_calls;
+	}
+
+    void graphics_null_image_clear(GPUImage* image, GPUImageLayout oldLayout, GPUImageLayout newLayout, Color clearColor, float depth, u32 stencil, CommandList cmd)
+    {
+		GraphicsCommand& c = record_command(GraphicsCommandType_ImageClear, image, cmd);
+		c.args[0] = oldLayout;
+		c.args[1] = newLayout;
+		c.args[2] = stencil;
+
+		++g_Null->cmd[cmd].stats.clear_count;
+    }
+
+    void graphics_null_image_blit(GPUImage* src, GPUImage* dst, GPUImageLayout srcLayout, GPUImageLayout dstLayout, u32 count, const GPUImageBlit* imageBlit, SamplerFilter filter, CommandList cmd)
+    {
+		GraphicsCommand& c = record_command(GraphicsCommandType_ImageBlit, dst, cmd);
+		c.args[0] = srcLayout;
+		c.args[1] = dstLayout;
+		c.args[2] = count;
+		c.args[3] = filter;
+
+		++g_Null->cmd[cmd].stats.blit_count;
+    }
+
+    void graphics_null_buffer_update(GPUBuffer* buffer, GPUBufferState buffer_state, const void* data, u32 size, u32 offset, CommandList cmd)
+    {
+		GraphicsCommand& c = record_command(GraphicsCommandType_BufferUpdate, buffer, cmd);
+		c.args[0] = size;
+		c.args[1] = offset;
+		c.args[2] = buffer_state;
+
+		GraphicsStats& stats = g_Null->cmd[cmd].stats;
+		++stats.buffer_updates;
+		stats.uploaded_bytes += size;
+
+		// The real devices write the dynamic constant buffers in a ring
+		GPUBuffer_internal* b = reinterpret_cast<GPUBuffer_internal*>(buffer);
+		if (b->info.buffer_type & GPUBufferType_Constant && b->info.usage == ResourceUsage_Dynamic) {
+
+			GraphicsDeviceStats& device_stats = g_Null->cmd[cmd].device_stats;
+			++device_stats.constant_uploads;
+			device_stats.constant_upload_bytes += u64(size);
+		}
+    }
+
+    void graphics_null_barrier(const GPUBarrier* barriers, u32 count, CommandList cmd)
+    {
+		GraphicsCommand& c = record_command(GraphicsCommandType_Barrier, NULL, cmd);
+		c.args[0] = count;
+
+		g_Null->cmd[cmd].stats.barrier_count += count;
+    }
+
+    void graphics_null_event_begin(const char* name, CommandList cmd)
+    {
+		GraphicsCommand& c = record_command(GraphicsCommandType_EventBegin, NULL, cmd);
+		c.args[0] = u32(hash_string(name));
+    }
+
+    void graphics_null_event_mark(const char* name, CommandList cmd)
+    {
+		GraphicsCommand& c = record_command(GraphicsCommandType_EventMark, NULL, cmd);
+		c.args[0] = u32(hash_string(name));
+    }
+
+    void graphics_null_event_end(CommandList cmd)
+    {
+		record_command(GraphicsCommandType_EventEnd, NULL, cmd);
+    }
+
+    bool graphics_null_pipeline_prewarm(GraphicsState& state)
+    {
+		return state.vertexShader != NULL && state.renderPass != NULL;
+    }
+
+    void graphics_null_device_stats(GraphicsDeviceStats* stats)
+    {
+		SV_LOCK_GUARD(g_Null->mutexCMD, lock);
+		*stats = g_Null->last_device_stats;
+    }
+
+    bool graphics_null_is_resident(Primitive_internal* primitive)
+    {
+		return true;
+    }
+
+	////////////////////////////////////////// QUERIES ////////////////////////////////////////
+
+	bool graphics_null_stats(GraphicsStats* last_frame, GraphicsStats* total)
+	{
+		if (g_Null.get() == nullptr) return false;
+
+		SV_LOCK_GUARD(g_Null->mutexCMD, lock);
+		if (last_frame) *last_frame = g_Null->last_stats;
+		if (total) *total = g_Null->total_stats;
+		return true;
+	}
+
+	const GraphicsCommand* graphics_null_trace(u32* count)
+	{
+		if (g_Null.get() == nullptr) {
+			*count = 0u;
+			return nullptr;
+		}
+
+		*count = u32(g_Null->last_trace.size());
+		return g_Null->last_trace.data();
+	}
+
+	void graphics_null_trace_enable(bool enable)
+	{
+		if (g_Null.get()) g_Null->trace_enabled = enable;
+	}
+
+}
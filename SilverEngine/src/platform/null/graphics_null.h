@@ -0,0 +1,52 @@
+#ifndef _GRAPHICS_NULL
+#define _GRAPHICS_NULL
+
+#include "..//graphics_internal.h"
+
+namespace sv {
+
+    // DEVICE FUNCTIONS
+
+    void graphics_null_device_prepare(GraphicsDevice& device);
+
+    bool	graphics_null_initialize();
+    bool	graphics_null_close();
+    void* graphics_null_get();
+
+    bool graphics_null_create(GraphicsPrimitiveType type, const void* desc, Primitive_internal* res);
+    bool graphics_null_destroy(Primitive_internal* primitive);
+
+    CommandList graphics_null_commandlist_begin();
+    CommandList graphics_null_commandlist_last();
+    u32		graphics_null_commandlist_count();
+
+    void graphics_null_renderpass_begin(CommandList);
+    void graphics_null_renderpass_end(CommandList);
+
+    void graphics_null_swapchain_resize();
+
+    void graphics_null_gpu_wait();
+
+    void graphics_null_frame_begin();
+    void graphics_null_frame_end();
+
+    void graphics_null_draw(u32, u32, u32, u32, CommandList);
+    void graphics_null_draw_indexed(u32, u32, u32, u32, u32, CommandList);
+	void graphics_null_dispatch(u32, u32, u32, CommandList);
+
+    void graphics_null_image_clear(GPUImage*, GPUImageLayout, GPUImageLayout, Color, float, u32, CommandList);
+    void graphics_null_image_blit(GPUImage*, GPUImage*, GPUImageLayout, GPUImageLayout, u32, const GPUImageBlit*, SamplerFilter, CommandList);
+    void graphics_null_buffer_update(GPUBuffer*, GPUBufferState, const void*, u32, u32, CommandList);
+    void graphics_null_barrier(const GPUBarrier*, u32, CommandList);
+
+    void graphics_null_event_begin(const char* name, CommandList cmd);
+    void graphics_null_event_mark(const char* name, CommandList cmd);
+    void graphics_null_event_end(CommandList cmd);
+
+    bool graphics_null_pipeline_prewarm(GraphicsState& state);
+    void graphics_null_device_stats(GraphicsDeviceStats* stats);
+    bool graphics_null_is_resident(Primitive_internal* primitive);
+
+}
+
+#endif
@@ -15,11 +15,22 @@ namespace sv {
 
     bool load_image(const char* filepath_, void** pdata, u32* width, u32* height)
     {
-		char filepath[FILEPATH_SIZE + 1u];
-		filepath_resolve(filepath, filepath_);
-	
 		int w = 0, h = 0, bits = 0;
-		void* data = stbi_load(filepath, &w, &h, &bits, 4);
+		void* data;
+
+		const u8* pack_data;
+		size_t pack_size;
+		
+		if (pack_find(filepath_, &pack_data, &pack_size)) {
+
+			data = stbi_load_from_memory(pack_data, int(pack_size), &w, &h, &bits, 4);
+		}
+		else {
+			char filepath[FILEPATH_SIZE + 1u];
+			filepath_resolve(filepath, filepath_);
+	
+			data = stbi_load(filepath, &w, &h, &bits, 4);
+		}
 
 		* pdata = nullptr;
 		*width = w;
@@ -30,6 +41,20 @@ namespace sv {
 		return true;
     }
 
+    bool load_image_from_memory(const void* file_data, size_t file_size, void** pdata, u32* width, u32* height)
+    {
+		int w = 0, h = 0, bits = 0;
+		void* data = stbi_load_from_memory((const stbi_uc*)file_data, int(file_size), &w, &h, &bits, 4);
+
+		*pdata = nullptr;
+		*width = w;
+		*height = h;
+
+		if (!data) return false;
+		*pdata = data;
+		return true;
+    }
+
     // TODO: Platform specific!!
 
     ///////////////////////////////////////////////// TIMER /////////////////////////////////////////////////
@@ -13,7 +13,7 @@ namespace sv {
 		return *reinterpret_cast<Graphics_vk*>(graphics_internaldevice_get());
     }
 	
-    static VkDescriptorSet update_descriptors(const ShaderDescriptorSetLayout& layout, ShaderType shader_type, bool constant_buffers, bool shader_resources, bool unordered_access_views, bool samplers, CommandList cmd_);
+    static VkDescriptorSet update_descriptors(const ShaderDescriptorSetLayout& layout, ShaderType shader_type, bool constant_buffers, bool shader_resources, bool unordered_access_views, bool samplers, u32* dynamic_offsets, CommandList cmd_);
     static void update_graphics_state(CommandList cmd_);
 	static void update_compute_state(CommandList cmd_);
 
@@ -98,6 +98,69 @@ namespace sv {
 		return VK_SUCCESS;
     }
 
+    SV_INLINE static VkResult create_ringbuffer(StagingBuffer& buffer, VkDeviceSize size)
+    {
+		VkBufferCreateInfo buffer_info{};
+		buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		buffer_info.size = size;
+		buffer_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+
+		buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		buffer_info.queueFamilyIndexCount = 0u;
+		buffer_info.pQueueFamilyIndices = nullptr;
+
+		VmaAllocationCreateInfo alloc_info{};
+		alloc_info.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+		alloc_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		vkExt(vmaCreateBuffer(g_API->allocator, &buffer_info, &alloc_info, &buffer.buffer, &buffer.allocation, nullptr));
+
+		buffer.data = buffer.allocation->GetMappedData();
+
+		return VK_SUCCESS;
+    }
+
+    SV_INLINE static DynamicAllocation allocate_ring(u32 size, CommandList cmd)
+    {
+		VulkanRingBuffer& ring = g_API->GetFrame().ring[cmd];
+		DynamicAllocation a;
+
+		u32 alignment = u32(g_API->card.properties.limits.minUniformBufferOffsetAlignment);
+		if (alignment == 0u) alignment = 1u;
+
+		u32 offset = (ring.offset + (alignment - 1u)) & ~(alignment - 1u);
+
+		if (ring.buffer.buffer == VK_NULL_HANDLE || offset + size > ring.size) {
+
+			// The old buffer can be referenced by the commands recorded in this frame
+			if (ring.buffer.buffer != VK_NULL_HANDLE)
+				ring.retired.push_back(ring.buffer);
+
+			u32 new_size = SV_MAX(ring.size * 2u, VULKAN_RING_BUFFER_SIZE);
+			while (new_size < size) new_size *= 2u;
+
+			ring.buffer = {};
+			ring.size = 0u;
+			ring.offset = 0u;
+			offset = 0u;
+
+			if (create_ringbuffer(ring.buffer, new_size) != VK_SUCCESS) {
+				SV_LOG_ERROR("Can't allocate a constant buffer ring of %u bytes", new_size);
+				return a;
+			}
+
+			ring.size = new_size;
+		}
+
+		a.buffer = ring.buffer.buffer;
+		a.data = (u8*)ring.buffer.data + offset;
+		a.offset = offset;
+		a.frame = g_API->frameNumber;
+
+		ring.offset = offset + size;
+		return a;
+    }
+
     constexpr u32 ALLOCATOR_BLOCK_SIZE = 500000u;
 
     SV_INLINE static VulkanGPUAllocator::Buffer create_allocator_buffer(u32 size)
@@ -232,6 +295,10 @@ namespace sv {
 					sizes[i].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 					break;
 
+				case VulkanDescriptorType_UniformBufferDynamic:
+					sizes[i].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+					break;
+
 				case VulkanDescriptorType_UniformTexelBuffer:
 					sizes[i].type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
 					break;
@@ -299,11 +366,99 @@ namespace sv {
 		}
     }
 
-    void graphics_vulkan_descriptors_reset(DescriptorPool& descPool)
+    SV_AUX void descriptor_lru_remove(VulkanDescriptorSet& sets, u32 index)
+    {
+		DescriptorSetEntry& e = sets.entries[index];
+		
+		if (e.prev != u32_max) sets.entries[e.prev].next = e.next;
+		else sets.lru_first = e.next;
+		
+		if (e.next != u32_max) sets.entries[e.next].prev = e.prev;
+		else sets.lru_last = e.prev;
+
+		e.prev = u32_max;
+		e.next = u32_max;
+    }
+
+    SV_AUX void descriptor_lru_push(VulkanDescriptorSet& sets, u32 index)
+    {
+		DescriptorSetEntry& e = sets.entries[index];
+		e.prev = u32_max;
+		e.next = sets.lru_first;
+
+		if (sets.lru_first != u32_max) sets.entries[sets.lru_first].prev = index;
+		sets.lru_first = index;
+		
+		if (sets.lru_last == u32_max) sets.lru_last = index;
+    }
+
+    SV_AUX bool descriptor_key_equals(const DescriptorSetEntry& e, const DescriptorSetKey& key)
+    {
+		return e.key.size() == key.size && memcmp(e.key.data(), key.values, sizeof(u64) * key.size) == 0;
+    }
+
+    /*
+      Returns the set cached with the same resources. Otherwise returns a new or evicted
+      set and the caller has to write it.
+      The table is indexed by the hash of the key, on a collision the table points to the last written set.
+      The pools are per frame and commandlist, so a set not used in the current frame is safe to override.
+    */
+    SV_INTERNAL VkDescriptorSet request_descriptor_set(DescriptorPool& descPool, const ShaderDescriptorSetLayout& layout, const DescriptorSetKey& key, CommandList cmd, bool& cached)
     {
-		for (auto& set : descPool.sets) {
-			set.second.used = 0u;
+		VulkanDescriptorSet& sets = descPool.sets[layout.setLayout];
+		GraphicsDeviceStats& stats = g_API->stats[cmd];
+		u64 frame = g_API->frameNumber;
+		size_t hash = key.hash;
+
+		++stats.descriptor_set_requests;
+
+		auto it = sets.table.find(hash);
+		if (it != sets.table.end() && descriptor_key_equals(sets.entries[it->second], key)) {
+
+			u32 index = it->second;
+			descriptor_lru_remove(sets, index);
+			descriptor_lru_push(sets, index);
+			sets.entries[index].last_frame = frame;
+
+			++stats.descriptor_set_hits;
+			cached = true;
+			return sets.entries[index].set;
+		}
+
+		cached = false;
+		u32 index;
+
+		if (sets.entries.size() >= VULKAN_DESCRIPTOR_CACHE_SIZE && sets.entries[sets.lru_last].last_frame != frame) {
+
+			// Evict the least recently used
+			index = sets.lru_last;
+			descriptor_lru_remove(sets, index);
+
+			// The entry is not in the table if other set with the same hash replaced it
+			auto evicted = sets.table.find(sets.entries[index].hash);
+			if (evicted != sets.table.end() && evicted->second == index)
+				sets.table.erase(evicted);
+			
+			++stats.descriptor_set_evictions;
+		}
+		else {
+
+			index = u32(sets.entries.size());
+			DescriptorSetEntry& e = sets.entries.emplace_back();
+			e.set = allocate_descriptors_sets(descPool, layout);
+			e.prev = u32_max;
+			e.next = u32_max;
 		}
+
+		DescriptorSetEntry& e = sets.entries[index];
+		e.hash = hash;
+		e.key.resize(key.size);
+		memcpy(e.key.data(), key.values, sizeof(u64) * key.size);
+		e.last_frame = frame;
+		descriptor_lru_push(sets, index);
+		sets.table[hash] = index;
+		
+		return e.set;
     }
 
     void graphics_vulkan_descriptors_clear(DescriptorPool& descPool)
@@ -346,6 +501,9 @@ namespace sv {
 		device.event_begin			= graphics_vulkan_event_begin;
 		device.event_mark			= graphics_vulkan_event_mark;
 		device.event_end			= graphics_vulkan_event_end;
+		device.pipeline_prewarm		= graphics_vulkan_pipeline_prewarm;
+		device.stats				= graphics_vulkan_device_stats;
+		device.is_resident			= graphics_vulkan_is_resident;
 
 		device.bufferAllocator			= std::make_unique<SizedInstanceAllocator>(sizeof(Buffer_vk), 200u);
 		device.imageAllocator			= std::make_unique<SizedInstanceAllocator>(sizeof(Image_vk), 200u);
@@ -367,6 +525,7 @@ namespace sv {
 		SV_CHECK(mutex_create(g_API->mutexCMD));
 		SV_CHECK(mutex_create(g_API->pipeline_mutex));
 		SV_CHECK(mutex_create(g_API->IDMutex));
+		SV_CHECK(mutex_create(g_API->upload.mutex));
 
 		// Instance extensions and validation layers
 #if SV_GFX
@@ -501,6 +660,7 @@ namespace sv {
 				u32 suitability = 0u;
 
 				u32 familyindex_graphics = u32_max;
+				u32 familyindex_transfer = u32_max;
 
 				vkGetPhysicalDeviceProperties(device, &props);
 				vkGetPhysicalDeviceFeatures(device, &features);
@@ -517,9 +677,16 @@ namespace sv {
 						const VkQueueFamilyProperties& prop = props[i];
 
 						bool hasGraphics = prop.queueFlags & VK_QUEUE_GRAPHICS_BIT;
+						bool hasCompute = prop.queueFlags & VK_QUEUE_COMPUTE_BIT;
+						bool hasTransfer = prop.queueFlags & VK_QUEUE_TRANSFER_BIT;
 
 						if (hasGraphics) familyindex_graphics = i;
+
+						// The dedicated transfer queues use the DMA engines
+						if (hasTransfer && !hasGraphics && !hasCompute) familyindex_transfer = i;
 					}
+
+					if (familyindex_transfer == u32_max) familyindex_transfer = familyindex_graphics;
 				}
 
 				// Suitability
@@ -535,6 +702,7 @@ namespace sv {
 					deviceIndex = i;
 
 					g_API->card.familyIndex.graphics = familyindex_graphics;
+					g_API->card.familyIndex.transfer = familyindex_transfer;
 					g_API->card.properties = props;
 					g_API->card.memoryProps = mem_props;
 					g_API->card.features = features;
@@ -554,14 +722,15 @@ namespace sv {
 			auto& card = g_API->card;
 
 			// Queue Create Info Structs
-			constexpr u32 queueCount = 1u;
+			u32 queueCount = (card.familyIndex.transfer == card.familyIndex.graphics) ? 1u : 2u;
 			u32 queueIndices[] = {
-				card.familyIndex.graphics
+				card.familyIndex.graphics,
+				card.familyIndex.transfer
 			};
 
 			const f32 priorities = 1.f;
 
-			VkDeviceQueueCreateInfo queue_create_info[queueCount];
+			VkDeviceQueueCreateInfo queue_create_info[2u];
 			for (u32 i = 0; i < queueCount; ++i) {
 				queue_create_info[i] = {};
 				queue_create_info[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
@@ -660,6 +829,7 @@ namespace sv {
 
 			// Get Queues
 			vkGetDeviceQueue(g_API->device, card.familyIndex.graphics, 0u, &g_API->queueGraphics);
+			vkGetDeviceQueue(g_API->device, card.familyIndex.transfer, 0u, &g_API->queueTransfer);
 		}
 
 		// Create allocator
@@ -671,6 +841,11 @@ namespace sv {
 
 			vkCheck(vmaCreateAllocator(&create_info, &g_API->allocator));
 		}
+
+		// Create pipeline cache
+		if (!graphics_vulkan_pipeline_cache_create()) {
+			SV_LOG_WARNING("The pipelines will be created without cache");
+		}
 		
 		// Create frames
 		{
@@ -703,6 +878,16 @@ namespace sv {
 			}
 		}
 
+		// Create upload queue
+		{
+			VkCommandPoolCreateInfo cmdPool_info{};
+			cmdPool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			cmdPool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			cmdPool_info.queueFamilyIndex = g_API->card.familyIndex.transfer;
+
+			vkCheck(vkCreateCommandPool(g_API->device, &cmdPool_info, nullptr, &g_API->upload.commandPool));
+		}
+
 		// Create swapchain
 		SV_CHECK(graphics_vulkan_swapchain_create());
 	
@@ -722,6 +907,33 @@ namespace sv {
 		mutex_destroy(g_API->pipeline_mutex);
 		mutex_destroy(g_API->IDMutex);
 
+		// Destroy upload queue
+		{
+			VulkanUploadQueue& upload = g_API->upload;
+
+			if (upload.is_recording) {
+				vkEndCommandBuffer(upload.recording.cmd);
+				upload.in_flight.push_back(std::move(upload.recording));
+				upload.is_recording = false;
+			}
+
+			auto destroy_batch = [](VulkanUploadBatch& batch) {
+				for (StagingBuffer& buffer : batch.staging_buffers) {
+					destroy_stagingbuffer(buffer);
+				}
+				vkDestroyFence(g_API->device, batch.fence, nullptr);
+			};
+
+			for (VulkanUploadBatch& batch : upload.in_flight) destroy_batch(batch);
+			for (VulkanUploadBatch& batch : upload.free_batches) destroy_batch(batch);
+
+			upload.in_flight.clear();
+			upload.free_batches.clear();
+
+			vkDestroyCommandPool(g_API->device, upload.commandPool, nullptr);
+			mutex_destroy(upload.mutex);
+		}
+
 		// Destroy swapchain
 		graphics_vulkan_swapchain_destroy(false);
 	
@@ -731,6 +943,8 @@ namespace sv {
 		}
 		g_API->pipelines.clear();
 
+		graphics_vulkan_pipeline_cache_destroy();
+
 		// Destroy frames
 		for (u32 i = 0; i < g_API->frameCount; ++i) {
 			Frame& frame = g_API->frames[i];
@@ -753,6 +967,21 @@ namespace sv {
 
 				allocator.buffers.clear();
 			}
+
+			// Destroy constant buffer rings
+			foreach(i, GraphicsLimit_CommandList) {
+
+				VulkanRingBuffer& ring = frame.ring[i];
+
+				if (ring.buffer.buffer != VK_NULL_HANDLE)
+					destroy_stagingbuffer(ring.buffer);
+
+				for (StagingBuffer& buffer : ring.retired) {
+					destroy_stagingbuffer(buffer);
+				}
+
+				ring.retired.clear();
+			}
 		}
 
 		// Destroy VMA Allocator
@@ -849,8 +1078,13 @@ namespace sv {
 
     bool graphics_vulkan_destroy(Primitive_internal* primitive)
     {
+		// The primitive can be referenced in the upload batch that is recording
+		graphics_vulkan_upload_flush();
+		
 		vkDeviceWaitIdle(g_API->device);
 
+		graphics_vulkan_upload_update();
+
 		bool result = true;
 
 		switch (primitive->type)
@@ -1083,17 +1317,68 @@ namespace sv {
 		vkAssert(vkDeviceWaitIdle(g_API->device));
     }
 
+    void graphics_vulkan_device_stats(GraphicsDeviceStats* stats)
+    {
+		*stats = g_API->last_stats;
+    }
+
+    bool graphics_vulkan_is_resident(Primitive_internal* primitive)
+    {
+		u64 ticket = 0u;
+
+		switch (primitive->type)
+		{
+		case GraphicsPrimitiveType_Buffer:
+			ticket = reinterpret_cast<Buffer_vk*>(primitive)->upload_ticket;
+			break;
+
+		case GraphicsPrimitiveType_Image:
+			ticket = reinterpret_cast<Image_vk*>(primitive)->upload_ticket;
+			break;
+		}
+
+		return ticket <= g_API->upload.completed_ticket.load();
+    }
+
     void graphics_vulkan_frame_begin()
     {
 		f64 now = timer_now();
 
 		Frame& frame = g_API->frames[g_API->currentFrame];
 
-		// Reset Descriptors
-		for (u32 i = 0; i < GraphicsLimit_CommandList; ++i) {
-			graphics_vulkan_descriptors_reset(frame.descPool[i]);
+		// Stats
+		{
+			GraphicsDeviceStats& s = g_API->last_stats;
+			s = {};
+			
+			foreach(i, GraphicsLimit_CommandList) {
+
+				GraphicsDeviceStats& c = g_API->stats[i];
+				s.descriptor_set_requests += c.descriptor_set_requests;
+				s.descriptor_set_hits += c.descriptor_set_hits;
+				s.descriptor_sets_written += c.descriptor_sets_written;
+				s.descriptor_writes += c.descriptor_writes;
+				s.descriptor_set_evictions += c.descriptor_set_evictions;
+				s.constant_uploads += c.constant_uploads;
+				s.constant_upload_bytes += c.constant_upload_bytes;
+				c = {};
+			}
+
+			VulkanUploadQueue& upload = g_API->upload;
+			SV_LOCK_GUARD(upload.mutex, lock);
+			
+			s.async_uploads = upload.uploads;
+			s.async_upload_bytes = upload.upload_bytes;
+			upload.uploads = 0u;
+			upload.upload_bytes = 0u;
 		}
 
+		// Release the completed uploads
+		graphics_vulkan_upload_update();
+
+		// The cached descriptor sets of this frame are not in use after this number changes
+		++g_API->frameNumber;
+
 		// Reset dynamic allocator
 		{
 			// TODO: free unused memory
@@ -1130,11 +1415,25 @@ namespace sv {
 
 		vkAssert(vkWaitForFences(g_API->device, 1, &frame.fence, VK_TRUE, UINT64_MAX));
 
+		// Reset constant buffer rings, the GPU finished reading them
+		foreach(i, GraphicsLimit_CommandList) {
+
+			VulkanRingBuffer& ring = frame.ring[i];
+
+			for (StagingBuffer& buffer : ring.retired) {
+				destroy_stagingbuffer(buffer);
+			}
+
+			ring.retired.clear();
+			ring.offset = 0u;
+		}
+
 		vkAssert(vkResetCommandPool(g_API->device, frame.commandPool, 0u));
     }
 
     void graphics_vulkan_frame_end()
     {
+		graphics_vulkan_upload_flush();
 		graphics_vulkan_acquire_image();
 		graphics_vulkan_submit_commandbuffers();
 		graphics_vulkan_present();
@@ -1166,7 +1465,7 @@ namespace sv {
 		VkImageSubresourceRange range{};
 		range.aspectMask = graphics_vulkan_aspect_from_image_layout(oldLayout, image.info.format);
 		range.baseMipLevel = 0u;
-		range.levelCount = 1u;
+		range.levelCount = image.mip_levels;
 		range.baseArrayLayer = 0u;
 		range.layerCount = image.layers;
 
@@ -1314,16 +1613,33 @@ namespace sv {
     void graphics_vulkan_buffer_update(GPUBuffer* buffer_, GPUBufferState buffer_state, const void* pData, u32 size, u32 offset, CommandList cmd_)
     {
 		Buffer_vk& buffer = *reinterpret_cast<Buffer_vk*>(buffer_);
-
-		VmaAllocationInfo info;
-		vmaGetAllocationInfo(g_API->allocator, buffer.allocation, &info);
 		
 		if (buffer.info.buffer_type & GPUBufferType_Constant && buffer.info.usage == ResourceUsage_Dynamic) {
 
-			DynamicAllocation allocation = allocate_gpu(size, 256u, cmd_);
-			memcpy(allocation.data, pData, size_t(size));
+			// The whole buffer is bound with a dynamic offset, so the allocation must cover it
+			u32 alloc_size = SV_MAX(buffer.info.size, offset + size);
+
+			DynamicAllocation allocation = allocate_ring(alloc_size, cmd_);
+			if (!allocation.isValid()) return;
+
+			// Keep the content of a partial update
+			if (offset + size <= buffer.info.size) {
+				memcpy(buffer.dynamic_data + offset, pData, size_t(size));
+				memcpy(allocation.data, buffer.dynamic_data, size_t(buffer.info.size));
+			}
+			else {
+				memcpy(allocation.data, buffer.dynamic_data, size_t(buffer.info.size));
+				memcpy((u8*)allocation.data + offset, pData, size_t(size));
+			}
+
 			buffer.dynamic_allocation[cmd_] = allocation;
 
+			graphics_state_get().compute[cmd_].update_resources = true;
+
+			GraphicsDeviceStats& stats = g_API->stats[cmd_];
+			++stats.constant_uploads;
+			stats.constant_upload_bytes += u64(size);
+
 			graphics_state_get().graphics[cmd_].flags |=
 				GraphicsPipelineState_ConstantBuffer |
 				GraphicsPipelineState_Resource_VS |
@@ -1418,7 +1734,7 @@ namespace sv {
 				imageBarrier[imageBarrierCount].newLayout = graphics_vulkan_parse_image_layout(barrier.image.newLayout);
 				imageBarrier[imageBarrierCount].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 				imageBarrier[imageBarrierCount].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-				imageBarrier[imageBarrierCount].subresourceRange.levelCount = 1u;
+				imageBarrier[imageBarrierCount].subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
 				imageBarrier[imageBarrierCount].subresourceRange.baseArrayLayer = 0u;
 				imageBarrier[imageBarrierCount].subresourceRange.baseMipLevel = 0u;
 
@@ -1710,6 +2026,38 @@ namespace sv {
 		return true;
     }
 
+    SV_INTERNAL VulkanPipeline& find_pipeline(size_t hash, Shader_vk* vertex_shader, Shader_vk* pixel_shader, Shader_vk* geometry_shader)
+    {
+		// Critical Section
+		SV_LOCK_GUARD(g_API->pipeline_mutex, lock);
+		auto it = g_API->pipelines.find(hash);
+		if (it == g_API->pipelines.end()) {
+					
+			// Create New Pipeline Object
+			VulkanPipeline& p = g_API->pipelines[hash];
+		    
+			graphics_vulkan_pipeline_create(p, vertex_shader, pixel_shader, geometry_shader);
+			// TODO handle error
+			return p;
+		}
+		
+		return it->second;
+    }
+
+    bool graphics_vulkan_pipeline_prewarm(GraphicsState& state)
+    {
+		if (state.vertexShader == NULL || state.renderPass == NULL) return false;
+		
+		Shader_vk* vertex_shader = reinterpret_cast<Shader_vk*>(state.vertexShader);
+		Shader_vk* pixel_shader = reinterpret_cast<Shader_vk*>(state.pixelShader);
+		Shader_vk* geometry_shader = reinterpret_cast<Shader_vk*>(state.geometryShader);
+
+		size_t hash = graphics_vulkan_pipeline_compute_hash(state);
+		VulkanPipeline& pipeline = find_pipeline(hash, vertex_shader, pixel_shader, geometry_shader);
+
+		return graphics_vulkan_pipeline_get(pipeline, state, hash) != VK_NULL_HANDLE;
+    }
+
     static void update_graphics_state(CommandList cmd_)
     {
 		GraphicsState& state = graphics_state_get().graphics[cmd_];
@@ -1777,26 +2125,7 @@ namespace sv {
 			pipelineHash = graphics_vulkan_pipeline_compute_hash(state);
 
 			// Find Pipeline
-			VulkanPipeline* pipelinePtr = nullptr;
-			{
-				// Critical Section
-				SV_LOCK_GUARD(g_API->pipeline_mutex, lock);
-				auto it = g_API->pipelines.find(pipelineHash);
-				if (it == g_API->pipelines.end()) {
-					
-					// Create New Pipeline Object
-					VulkanPipeline& p = g_API->pipelines[pipelineHash];
-		    
-					graphics_vulkan_pipeline_create(p, vertex_shader, pixel_shader, geometry_shader);
-					// TODO handle error
-					pipelinePtr = &p;
-
-				}
-				else {
-					pipelinePtr = &it->second;
-				}
-			}
-			VulkanPipeline& pipeline = *pipelinePtr;
+			VulkanPipeline& pipeline = find_pipeline(pipelineHash, vertex_shader, pixel_shader, geometry_shader);
 
 			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_vulkan_pipeline_get(pipeline, state, pipelineHash));
 
@@ -1874,17 +2203,20 @@ namespace sv {
 
 			if (state.flags & GraphicsPipelineState_Resource_VS && state.vertexShader != NULL) {
 
-				pipeline.descriptorSets[ShaderType_Vertex] = update_descriptors(vertex_shader->layout, ShaderType_Vertex, state.flags & GraphicsPipelineState_ConstantBuffer, state.flags & GraphicsPipelineState_ShaderResource, state.flags & GraphicsPipelineState_UnorderedAccessView, state.flags & GraphicsPipelineState_Sampler, cmd_);
+				pipeline.descriptorSets[ShaderType_Vertex] = update_descriptors(vertex_shader->layout, ShaderType_Vertex, state.flags & GraphicsPipelineState_ConstantBuffer, state.flags & GraphicsPipelineState_ShaderResource, state.flags & GraphicsPipelineState_UnorderedAccessView, state.flags & GraphicsPipelineState_Sampler, pipeline.dynamicOffsets[ShaderType_Vertex], cmd_);
+				pipeline.dynamicCount[ShaderType_Vertex] = vertex_shader->layout.dynamicCount;
 				
 			}
 			if (state.flags & GraphicsPipelineState_Resource_PS && state.pixelShader != NULL) {
 
-				pipeline.descriptorSets[ShaderType_Pixel] = update_descriptors(pixel_shader->layout, ShaderType_Pixel, state.flags & GraphicsPipelineState_ConstantBuffer, state.flags & GraphicsPipelineState_ShaderResource, state.flags & GraphicsPipelineState_UnorderedAccessView, state.flags & GraphicsPipelineState_Sampler, cmd_);
+				pipeline.descriptorSets[ShaderType_Pixel] = update_descriptors(pixel_shader->layout, ShaderType_Pixel, state.flags & GraphicsPipelineState_ConstantBuffer, state.flags & GraphicsPipelineState_ShaderResource, state.flags & GraphicsPipelineState_UnorderedAccessView, state.flags & GraphicsPipelineState_Sampler, pipeline.dynamicOffsets[ShaderType_Pixel], cmd_);
+				pipeline.dynamicCount[ShaderType_Pixel] = pixel_shader->layout.dynamicCount;
 
 			}
 			if (state.flags & GraphicsPipelineState_Resource_GS && state.geometryShader != NULL) {
 
-				pipeline.descriptorSets[ShaderType_Geometry] = update_descriptors(geometry_shader->layout, ShaderType_Geometry, state.flags & GraphicsPipelineState_ConstantBuffer, state.flags & GraphicsPipelineState_ShaderResource, state.flags & GraphicsPipelineState_UnorderedAccessView, state.flags & GraphicsPipelineState_Sampler, cmd_);
+				pipeline.descriptorSets[ShaderType_Geometry] = update_descriptors(geometry_shader->layout, ShaderType_Geometry, state.flags & GraphicsPipelineState_ConstantBuffer, state.flags & GraphicsPipelineState_ShaderResource, state.flags & GraphicsPipelineState_UnorderedAccessView, state.flags & GraphicsPipelineState_Sampler, pipeline.dynamicOffsets[ShaderType_Geometry], cmd_);
+				pipeline.dynamicCount[ShaderType_Geometry] = geometry_shader->layout.dynamicCount;
 
 			}
 
@@ -1895,33 +2227,63 @@ namespace sv {
 						offset++;
 						continue;
 					}
-					vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout, offset, i - offset, &pipeline.descriptorSets[offset], 0u, nullptr);
+					bind_graphics_descriptor_sets(cmd, pipeline, offset, i);
 					offset = i + 1u;
 				}
 			}
 
 			if (offset != ShaderType_GraphicsCount) {
-				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout, offset, ShaderType_GraphicsCount - offset, &pipeline.descriptorSets[offset], 0u, nullptr);
+				bind_graphics_descriptor_sets(cmd, pipeline, offset, ShaderType_GraphicsCount);
 			}
 		}
 
 		state.flags = 0u;
     }
 
-    static VkDescriptorSet update_descriptors(const ShaderDescriptorSetLayout& layout, ShaderType shader_type, bool constant_buffers, bool shader_resources, bool unordered_access_views, bool samplers, CommandList cmd_)
+    // Binds the sets in the range [begin, end) with the dynamic offsets of its constant buffers
+    SV_INTERNAL void bind_graphics_descriptor_sets(VkCommandBuffer cmd, const VulkanPipeline& pipeline, u32 begin, u32 end)
+    {
+		u32 offsets[ShaderType_GraphicsCount * GraphicsLimit_ConstantBuffer];
+		u32 count = 0u;
+
+		for (u32 i = begin; i < end; ++i) {
+			foreach(j, pipeline.dynamicCount[i]) {
+				offsets[count++] = pipeline.dynamicOffsets[i][j];
+			}
+		}
+
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout, begin, end - begin, &pipeline.descriptorSets[begin], count, offsets);
+    }
+
+    SV_AUX void descriptor_key_add(DescriptorSetKey& key, u64 value)
+    {
+		key.values[key.size++] = value;
+		hash_combine(key.hash, value);
+    }
+
+    static VkDescriptorSet update_descriptors(const ShaderDescriptorSetLayout& layout, ShaderType shader_type, bool constant_buffers, bool shader_resources, bool unordered_access_views, bool samplers, u32* dynamic_offsets, CommandList cmd_)
     {
 		auto& state = graphics_state_get();
 		
 		VkWriteDescriptorSet write_desc[GraphicsLimit_ConstantBuffer + GraphicsLimit_ShaderResource + GraphicsLimit_UnorderedAccessView + GraphicsLimit_Sampler];
 		u32 write_count = 0u;
 
-		VkDescriptorSet desc_set = allocate_descriptors_sets(g_API->GetFrame().descPool[cmd_], layout);
+		VkDescriptorBufferInfo buffer_infos[GraphicsLimit_ConstantBuffer];
+		u32 buffer_info_count = 0u;
+
+		foreach(i, layout.dynamicCount) {
+			dynamic_offsets[i] = 0u;
+		}
+
+		// Key of the bound resources
+		DescriptorSetKey key;
 
 		for (ShaderResourceBinding binding : layout.bindings) {
 
 			switch (binding.descriptor_type) {
 				
 			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
 				if (!constant_buffers) continue;
 				else {
 				
@@ -1937,15 +2299,42 @@ namespace sv {
 					if (buffer == NULL) continue;
 					write_desc[write_count].pImageInfo = NULL;
 					write_desc[write_count].pTexelBufferView = NULL;
-						
+
+					VkDescriptorBufferInfo& info = buffer_infos[buffer_info_count++];
+					info = buffer->buffer_info;
+
 					if (buffer->info.usage == ResourceUsage_Dynamic) {
 
-						buffer->buffer_info.buffer = buffer->dynamic_allocation[cmd_].buffer;
-						buffer->buffer_info.offset = buffer->dynamic_allocation[cmd_].offset;
-						buffer->buffer_info.range = buffer->info.size;
+						// The ring memory of an older frame can be reused, so a buffer not updated in this frame uploads its last content again
+						DynamicAllocation& allocation = buffer->dynamic_allocation[cmd_];
+
+						if (!allocation.isValid() || allocation.frame != g_API->frameNumber) {
+
+							SV_ASSERT(buffer->dynamic_data != nullptr);
+							allocation = allocate_ring(buffer->info.size, cmd_);
+							if (!allocation.isValid()) {
+								--buffer_info_count;
+								continue;
+							}
+							memcpy(allocation.data, buffer->dynamic_data, size_t(buffer->info.size));
+						}
+
+						info.buffer = allocation.buffer;
+						info.offset = allocation.offset;
+						info.range = buffer->info.size;
+					}
+
+					// The offset is given when the set is bound, so the same set is valid after every update
+					if (binding.descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) {
+						dynamic_offsets[binding.dynamicIndex] = u32(info.offset);
+						info.offset = 0u;
 					}
 				
-					write_desc[write_count].pBufferInfo = &buffer->buffer_info;
+					write_desc[write_count].pBufferInfo = &info;
+
+					descriptor_key_add(key, u64(buffer->ID));
+					descriptor_key_add(key, u64(info.buffer));
+					descriptor_key_add(key, u64(info.offset));
 				}
 				break;
 
@@ -1967,6 +2356,9 @@ namespace sv {
 					write_desc[write_count].pImageInfo = &image->shader_resource_view;
 					write_desc[write_count].pBufferInfo = nullptr;
 					write_desc[write_count].pTexelBufferView = nullptr;
+
+					descriptor_key_add(key, u64(image->ID));
+					descriptor_key_add(key, u64(image->shader_resource_view.imageView));
 				}
 				break;
 				
@@ -1987,6 +2379,9 @@ namespace sv {
 					write_desc[write_count].pImageInfo = &image->unordered_access_view;
 					write_desc[write_count].pBufferInfo = nullptr;
 					write_desc[write_count].pTexelBufferView = nullptr;
+
+					descriptor_key_add(key, u64(image->ID));
+					descriptor_key_add(key, u64(image->unordered_access_view.imageView));
 				}
 				break;
 
@@ -2008,6 +2403,8 @@ namespace sv {
 					write_desc[write_count].pImageInfo = NULL;
 					write_desc[write_count].pTexelBufferView = NULL;
 					write_desc[write_count].pBufferInfo = &buffer->buffer_info;
+
+					descriptor_key_add(key, u64(buffer->ID));
 				}
 				break;
 
@@ -2029,6 +2426,8 @@ namespace sv {
 					write_desc[write_count].pImageInfo = NULL;
 					write_desc[write_count].pTexelBufferView = &buffer->srv_texel_buffer_view;
 					write_desc[write_count].pBufferInfo = NULL;
+
+					descriptor_key_add(key, u64(buffer->ID));
 				}
 				break;
 
@@ -2050,6 +2449,8 @@ namespace sv {
 					write_desc[write_count].pImageInfo = NULL;
 					write_desc[write_count].pTexelBufferView = &buffer->uav_texel_buffer_view;
 					write_desc[write_count].pBufferInfo = NULL;
+
+					descriptor_key_add(key, u64(buffer->ID));
 				}
 				break;
 
@@ -2070,28 +2471,45 @@ namespace sv {
 					write_desc[write_count].pImageInfo = &sampler->image_info;
 					write_desc[write_count].pBufferInfo = nullptr;
 					write_desc[write_count].pTexelBufferView = nullptr;
+
+					descriptor_key_add(key, u64(sampler->ID));
 				}
 				break;
 
 			default:
 				SV_ASSERT(0);
-				return desc_set;
+				return VK_NULL_HANDLE;
 			
 				
 			}
 
 			write_desc[write_count].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 			write_desc[write_count].pNext = nullptr;
-			write_desc[write_count].dstSet = desc_set;
 			write_desc[write_count].dstBinding = binding.vulkanBinding;
 			write_desc[write_count].dstArrayElement = 0u;
 			write_desc[write_count].descriptorCount = 1u;
 			write_desc[write_count].descriptorType = binding.descriptor_type;
 
+			descriptor_key_add(key, u64(binding.vulkanBinding));
+
 			++write_count;
 		}
 
-		vkUpdateDescriptorSets(g_API->device, write_count, write_desc, 0u, nullptr);
+		bool cached;
+		VkDescriptorSet desc_set = request_descriptor_set(g_API->GetFrame().descPool[cmd_], layout, key, cmd_, cached);
+
+		if (!cached) {
+			
+			foreach(i, write_count)
+				write_desc[i].dstSet = desc_set;
+			
+			vkUpdateDescriptorSets(g_API->device, write_count, write_desc, 0u, nullptr);
+
+			GraphicsDeviceStats& stats = g_API->stats[cmd_];
+			++stats.descriptor_sets_written;
+			stats.descriptor_writes += write_count;
+		}
+		
 		return desc_set;
     }
 
@@ -2118,9 +2536,10 @@ namespace sv {
 
 			state.update_resources = false;
 
-			VkDescriptorSet desc_set = update_descriptors(shader->layout, ShaderType_Compute, true, true, true, false, cmd_);
+			u32 dynamic_offsets[GraphicsLimit_ConstantBuffer];
+			VkDescriptorSet desc_set = update_descriptors(shader->layout, ShaderType_Compute, true, true, true, false, dynamic_offsets, cmd_);
 
-			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader->compute.pipeline_layout, 0u, 1u, &desc_set, 0u, nullptr);
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shader->compute.pipeline_layout, 0u, 1u, &desc_set, shader->layout.dynamicCount, dynamic_offsets);
 		}
 	}
 	
@@ -2180,6 +2599,117 @@ namespace sv {
 		return res;
     }
 
+    VkCommandBuffer graphics_vulkan_upload_begin(u64* ticket)
+    {
+		VulkanUploadQueue& upload = g_API->upload;
+
+		if (!upload.is_recording) {
+
+			VulkanUploadBatch& batch = upload.recording;
+
+			if (upload.free_batches.size()) {
+				batch = std::move(upload.free_batches.back());
+				upload.free_batches.pop_back();
+			}
+			else {
+
+				batch = VulkanUploadBatch();
+
+				VkCommandBufferAllocateInfo alloc_info{};
+				alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+				alloc_info.commandPool = upload.commandPool;
+				alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+				alloc_info.commandBufferCount = 1u;
+
+				if (vkAllocateCommandBuffers(g_API->device, &alloc_info, &batch.cmd) != VK_SUCCESS) {
+					SV_LOG_ERROR("Can't allocate Upload CommandBuffer");
+					return VK_NULL_HANDLE;
+				}
+
+				batch.fence = graphics_vulkan_fence_create(false);
+			}
+
+			VkCommandBufferBeginInfo begin_info{};
+			begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			begin_info.pInheritanceInfo = nullptr;
+
+			if (vkBeginCommandBuffer(batch.cmd, &begin_info) != VK_SUCCESS) {
+				SV_LOG_ERROR("Can't begin Upload CommandBuffer");
+				upload.free_batches.push_back(std::move(batch));
+				return VK_NULL_HANDLE;
+			}
+
+			batch.ticket = upload.next_ticket++;
+			upload.is_recording = true;
+		}
+
+		*ticket = upload.recording.ticket;
+		return upload.recording.cmd;
+    }
+
+    void graphics_vulkan_upload_flush()
+    {
+		VulkanUploadQueue& upload = g_API->upload;
+		SV_LOCK_GUARD(upload.mutex, lock);
+
+		if (!upload.is_recording) return;
+		upload.is_recording = false;
+
+		VulkanUploadBatch& batch = upload.recording;
+
+		vkAssert(vkEndCommandBuffer(batch.cmd));
+
+		VkSubmitInfo submit_info{};
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.waitSemaphoreCount = 0u;
+		submit_info.commandBufferCount = 1u;
+		submit_info.pCommandBuffers = &batch.cmd;
+		submit_info.signalSemaphoreCount = 0u;
+
+		// The transfer queue can be the graphics queue, only submitted from the render thread
+		vkAssert(vkQueueSubmit(g_API->queueTransfer, 1u, &submit_info, batch.fence));
+
+		upload.in_flight.push_back(std::move(batch));
+    }
+
+    void graphics_vulkan_upload_update()
+    {
+		VulkanUploadQueue& upload = g_API->upload;
+		SV_LOCK_GUARD(upload.mutex, lock);
+
+		// The batches are executed in submission order
+		u32 completed = 0u;
+
+		for (VulkanUploadBatch& batch : upload.in_flight) {
+
+			if (vkGetFenceStatus(g_API->device, batch.fence) != VK_SUCCESS)
+				break;
+
+			for (StagingBuffer& buffer : batch.staging_buffers) {
+				destroy_stagingbuffer(buffer);
+			}
+			batch.staging_buffers.clear();
+
+			vkAssert(vkResetFences(g_API->device, 1u, &batch.fence));
+
+			upload.completed_ticket.store(batch.ticket);
+			upload.free_batches.push_back(std::move(batch));
+			++completed;
+		}
+
+		if (completed) {
+
+			List<VulkanUploadBatch> in_flight;
+
+			for (size_t i = completed; i < upload.in_flight.size(); ++i) {
+				in_flight.push_back(std::move(upload.in_flight[i]));
+			}
+
+			upload.in_flight = std::move(in_flight);
+		}
+    }
+
     void graphics_vulkan_buffer_copy(VkCommandBuffer cmd, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize size)
     {
 		VkBufferCopy copy_info{};
@@ -2189,7 +2719,7 @@ namespace sv {
 		vkCmdCopyBuffer(cmd, srcBuffer, dstBuffer, 1u, &copy_info);
     }
 
-    VkResult graphics_vulkan_imageview_create(VkImage image, VkFormat format, VkImageViewType viewType, VkImageAspectFlags aspectFlags, u32 layerCount, VkImageView& view)
+    VkResult graphics_vulkan_imageview_create(VkImage image, VkFormat format, VkImageViewType viewType, VkImageAspectFlags aspectFlags, u32 layerCount, VkImageView& view, u32 levelCount)
     {
 		VkImageViewCreateInfo create_info{};
 		create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -2203,7 +2733,7 @@ namespace sv {
 		create_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
 		create_info.subresourceRange.aspectMask = aspectFlags;
 		create_info.subresourceRange.baseMipLevel = 0u;
-		create_info.subresourceRange.levelCount = 1u;
+		create_info.subresourceRange.levelCount = levelCount;
 		create_info.subresourceRange.baseArrayLayer = 0u;
 		create_info.subresourceRange.layerCount = layerCount;
 
@@ -2332,9 +2862,16 @@ namespace sv {
     {
 		VkBufferUsageFlags bufferUsage = 0u;		
 
+		buffer.ID = g_API->GetID();
+
 		// Special case: It uses dynamic memory from an allocator
 		if (desc.usage == ResourceUsage_Dynamic && buffer.info.buffer_type & GPUBufferType_Constant)
 		{
+			buffer.dynamic_data = (u8*)SV_ALLOCATE_MEMORY(desc.size, "Graphics");
+			if (buffer.dynamic_data == nullptr) return false;
+
+			if (desc.data) memcpy(buffer.dynamic_data, desc.data, size_t(desc.size));
+			else memset(buffer.dynamic_data, 0, size_t(desc.size));
 			return true;
 		}
 
@@ -2365,6 +2902,9 @@ namespace sv {
 
 		bufferUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
+		bool async_upload = desc.async_upload && desc.data;
+		u32 families[] = { g_API->card.familyIndex.graphics, g_API->card.familyIndex.transfer };
+
 		// Create Buffer
 		{
 			VkBufferCreateInfo buffer_info{};
@@ -2377,6 +2917,16 @@ namespace sv {
 			buffer_info.queueFamilyIndexCount = 0u;
 			buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+			// Written in the transfer family and read in the graphics family.
+			// The uploads don't record queue family ownership transfers (release and acquire barriers),
+			// so the sharing mode must be CONCURRENT when the families are different. With EXCLUSIVE the
+			// content is undefined in the graphics family
+			if (async_upload && families[0] != families[1]) {
+				buffer_info.pQueueFamilyIndices = families;
+				buffer_info.queueFamilyIndexCount = 2u;
+				buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			}
+
 			VmaAllocationCreateInfo alloc_info{};
 			alloc_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
@@ -2384,7 +2934,32 @@ namespace sv {
 		}
 
 		// Set data
-		if (desc.data) {
+		if (async_upload) {
+
+			StagingBuffer staging_buffer;
+
+			vkCheck(create_stagingbuffer(staging_buffer, desc.size));
+			memcpy(staging_buffer.data, desc.data, desc.size);
+
+			VulkanUploadQueue& upload = g_API->upload;
+			SV_LOCK_GUARD(upload.mutex, lock);
+
+			VkCommandBuffer cmd = graphics_vulkan_upload_begin(&buffer.upload_ticket);
+
+			if (cmd == VK_NULL_HANDLE) {
+				destroy_stagingbuffer(staging_buffer);
+				return false;
+			}
+
+			// The buffer is not used until the batch fence is signaled, so it doesn't need barriers.
+			// There is no ownership transfer, the buffer is CONCURRENT if the families are different
+			graphics_vulkan_buffer_copy(cmd, staging_buffer.buffer, buffer.buffer, 0u, 0u, desc.size);
+
+			upload.recording.staging_buffers.push_back(staging_buffer);
+			++upload.uploads;
+			upload.upload_bytes += desc.size;
+		}
+		else if (desc.data) {
 			
 			VkCommandBuffer cmd;
 			vkCheck(graphics_vulkan_singletimecmb_begin(&cmd));
@@ -2491,6 +3066,38 @@ namespace sv {
 		return true;
     }
 
+    // Copies all the mip levels from a tightly packed buffer
+    SV_AUX void copy_image_levels(VkCommandBuffer cmd, VkBuffer buffer, const Image_vk& image, const GPUImageDesc& desc, VkImageAspectFlags aspect)
+    {
+		VkBufferImageCopy copy_info[16u];
+		SV_ASSERT(image.mip_levels <= 16u);
+
+		u32 offset = 0u;
+		u32 width = desc.width;
+		u32 height = desc.height;
+
+		foreach(level, image.mip_levels) {
+
+			VkBufferImageCopy& copy = copy_info[level];
+			copy = {};
+			copy.bufferOffset = offset;
+			copy.bufferRowLength = 0u;
+			copy.bufferImageHeight = 0u;
+			copy.imageSubresource.aspectMask = aspect;
+			copy.imageSubresource.baseArrayLayer = 0u;
+			copy.imageSubresource.layerCount = 1u;
+			copy.imageSubresource.mipLevel = level;
+			copy.imageOffset = { 0, 0, 0 };
+			copy.imageExtent = { width, height, 1u };
+
+			offset += graphics_image_level_size(desc.format, width, height);
+			width = SV_MAX(width / 2u, 1u);
+			height = SV_MAX(height / 2u, 1u);
+		}
+
+		vkCmdCopyBufferToImage(cmd, buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, image.mip_levels, copy_info);
+    }
+
     bool graphics_vulkan_image_create(Image_vk& image, const GPUImageDesc& desc)
     {
 		VkImageType imageType = VK_IMAGE_TYPE_2D;
@@ -2498,6 +3105,10 @@ namespace sv {
 		VkImageUsageFlags imageUsage = 0u;
 		VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D;
 		u32 image_flags = 0u;
+
+		// TODO: Async cubemaps
+		bool async_upload = desc.async_upload && desc.data && !(desc.type & GPUImageType_CubeMap);
+		u32 families[] = { g_API->card.familyIndex.graphics, g_API->card.familyIndex.transfer };
 		
 		{
 			if (desc.type & GPUImageType_RenderTarget) {
@@ -2516,7 +3127,11 @@ namespace sv {
 				image_flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
 				image.layers = 6u;
 				view_type = VK_IMAGE_VIEW_TYPE_CUBE;
+
+				// The faces are given as one level each
+				image.mip_levels = 1u;
 			}
+			else image.mip_levels = SV_MIN(SV_MAX(desc.mip_levels, 1u), 16u);
 		}
 
 		// Create Image
@@ -2537,7 +3152,16 @@ namespace sv {
 			create_info.queueFamilyIndexCount = 0u;
 			create_info.pQueueFamilyIndices = nullptr;
 			create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			create_info.mipLevels = 1u;
+			create_info.mipLevels = image.mip_levels;
+
+			// Required by the uploads, they change the layout in the transfer family without queue family
+			// ownership transfers. An EXCLUSIVE image would need a release barrier in the transfer queue
+			// and an acquire barrier in the graphics queue
+			if (async_upload && families[0] != families[1]) {
+				create_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+				create_info.queueFamilyIndexCount = 2u;
+				create_info.pQueueFamilyIndices = families;
+			}
 
 			VmaAllocationCreateInfo alloc_info{};
 			alloc_info.requiredFlags = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -2546,30 +3170,41 @@ namespace sv {
 		}
 
 		// Set Data
-		VkCommandBuffer cmd;
-
-		vkCheck(graphics_vulkan_singletimecmb_begin(&cmd));
-		
-		if (desc.data) {
+		if (async_upload) {
 
 			VkImageAspectFlags aspect = graphics_vulkan_aspect_from_image_layout(desc.layout, desc.format);
 
+			StagingBuffer staging_buffer;
+
+			vkCheck(create_stagingbuffer(staging_buffer, desc.size));
+			memcpy(staging_buffer.data, desc.data, desc.size);
+
+			VulkanUploadQueue& upload = g_API->upload;
+			SV_LOCK_GUARD(upload.mutex, lock);
+
+			VkCommandBuffer cmd = graphics_vulkan_upload_begin(&image.upload_ticket);
+
+			if (cmd == VK_NULL_HANDLE) {
+				destroy_stagingbuffer(staging_buffer);
+				return false;
+			}
+
 			// Memory barrier to set the image transfer dst layout
 			VkImageMemoryBarrier memBarrier{};
 			memBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			memBarrier.srcAccessMask = graphics_vulkan_access_from_image_layout(GPUImageLayout_Undefined);
+			memBarrier.srcAccessMask = 0u;
 			memBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			memBarrier.oldLayout = graphics_vulkan_parse_image_layout(GPUImageLayout_Undefined);
+			memBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 			memBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 			memBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			memBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 			memBarrier.image = image.image;
 			memBarrier.subresourceRange.aspectMask = aspect;
 			memBarrier.subresourceRange.layerCount = image.layers;
-			memBarrier.subresourceRange.levelCount = 1u;
+			memBarrier.subresourceRange.levelCount = image.mip_levels;
 
 			vkCmdPipelineBarrier(cmd,
-								 graphics_vulkan_stage_from_image_layout(GPUImageLayout_Undefined),
+								 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
 								 VK_PIPELINE_STAGE_TRANSFER_BIT,
 								 0u,
 								 0u,
@@ -2579,73 +3214,21 @@ namespace sv {
 								 1u,
 								 &memBarrier);
 
-			StagingBuffer staging_buffer;
-
-			// Create staging buffer and copy desc.pData
-			if (desc.type & GPUImageType_CubeMap) {
+			// Copy buffer to image
+			copy_image_levels(cmd, staging_buffer.buffer, image, desc, aspect);
 
-				create_stagingbuffer(staging_buffer, desc.size * 6u);
-
-				u8** images = (u8 * *)desc.data;
-
-				foreach(i, 6u) {
-					
-					u32 k = i;
-
-					if (k == 0u) k = 4u;
-					else if (k == 1u) k = 5u;
-					else if (k == 4u) k = 0u;
-					else if (k == 5u) k = 1u;
-
-					memcpy((u8*)staging_buffer.data + desc.size * k, images[i], desc.size);
-				}
-
-				foreach(i, 6u) {
-
-					// Copy buffer to image
-					VkBufferImageCopy copy_info{};
-					copy_info.bufferOffset = desc.size * i;
-					copy_info.bufferRowLength = 0u;
-					copy_info.bufferImageHeight = 0u;
-					copy_info.imageSubresource.aspectMask = aspect;
-					copy_info.imageSubresource.baseArrayLayer = i;
-					copy_info.imageSubresource.layerCount = 1u;
-					copy_info.imageSubresource.mipLevel = 0u;
-					copy_info.imageOffset = { 0, 0, 0 };
-					copy_info.imageExtent = { desc.width, desc.height, 1u };
-
-					vkCmdCopyBufferToImage(cmd, staging_buffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1u, &copy_info);
-				}
-			}
-			else {
-
-				create_stagingbuffer(staging_buffer, desc.size);
-				memcpy(staging_buffer.data, desc.data, desc.size);
-
-				// Copy buffer to image
-				VkBufferImageCopy copy_info{};
-				copy_info.bufferOffset = 0u;
-				copy_info.bufferRowLength = 0u;
-				copy_info.bufferImageHeight = 0u;
-				copy_info.imageSubresource.aspectMask = aspect;
-				copy_info.imageSubresource.baseArrayLayer = 0u;
-				copy_info.imageSubresource.layerCount = 1u;
-				copy_info.imageSubresource.mipLevel = 0u;
-				copy_info.imageOffset = { 0, 0, 0 };
-				copy_info.imageExtent = { desc.width, desc.height, 1u };
-
-				vkCmdCopyBufferToImage(cmd, staging_buffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1u, &copy_info);
-			}
-			
-			// Set the layout to desc.layout
+			// Set the layout to desc.layout, the transfer queue can't wait for the graphics stages.
+			// The image is not used until the batch fence is signaled, the signal makes the writes available.
+			// This is not a release barrier: the queue family indices are ignored because the image is
+			// CONCURRENT when the families are different
 			memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			memBarrier.dstAccessMask = graphics_vulkan_access_from_image_layout(desc.layout);
+			memBarrier.dstAccessMask = 0u;
 			memBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 			memBarrier.newLayout = graphics_vulkan_parse_image_layout(desc.layout);
 
 			vkCmdPipelineBarrier(cmd,
 								 VK_PIPELINE_STAGE_TRANSFER_BIT,
-								 graphics_vulkan_stage_from_image_layout(desc.layout),
+								 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
 								 0u,
 								 0u,
 								 nullptr,
@@ -2654,40 +3237,142 @@ namespace sv {
 								 1u,
 								 &memBarrier);
 
-			vkCheck(graphics_vulkan_singletimecmb_end(cmd));
-
-			vkCheck(destroy_stagingbuffer(staging_buffer));
+			upload.recording.staging_buffers.push_back(staging_buffer);
+			++upload.uploads;
+			upload.upload_bytes += desc.size;
 		}
 		else {
 
-			VkImageMemoryBarrier memBarrier{};
-			memBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			memBarrier.srcAccessMask = graphics_vulkan_access_from_image_layout(GPUImageLayout_Undefined);
-			memBarrier.dstAccessMask = graphics_vulkan_access_from_image_layout(desc.layout);
-			memBarrier.oldLayout = graphics_vulkan_parse_image_layout(GPUImageLayout_Undefined);
-			memBarrier.newLayout = graphics_vulkan_parse_image_layout(desc.layout);
-			memBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			memBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			memBarrier.image = image.image;
-			memBarrier.subresourceRange.aspectMask = graphics_vulkan_aspect_from_image_layout(desc.layout, desc.format);
-			memBarrier.subresourceRange.layerCount = image.layers;
-			memBarrier.subresourceRange.levelCount = 1u;
+			VkCommandBuffer cmd;
 
-			vkCmdPipelineBarrier(cmd,
-								 graphics_vulkan_stage_from_image_layout(GPUImageLayout_Undefined),
-								 graphics_vulkan_stage_from_image_layout(desc.layout),
-								 0u,
-								 0u,
-								 nullptr,
-								 0u,
-								 nullptr,
-								 1u,
-								 &memBarrier);
+			vkCheck(graphics_vulkan_singletimecmb_begin(&cmd));
+		
+			if (desc.data) {
+
+				VkImageAspectFlags aspect = graphics_vulkan_aspect_from_image_layout(desc.layout, desc.format);
+
+				// Memory barrier to set the image transfer dst layout
+				VkImageMemoryBarrier memBarrier{};
+				memBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				memBarrier.srcAccessMask = graphics_vulkan_access_from_image_layout(GPUImageLayout_Undefined);
+				memBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				memBarrier.oldLayout = graphics_vulkan_parse_image_layout(GPUImageLayout_Undefined);
+				memBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				memBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				memBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				memBarrier.image = image.image;
+				memBarrier.subresourceRange.aspectMask = aspect;
+				memBarrier.subresourceRange.layerCount = image.layers;
+				memBarrier.subresourceRange.levelCount = image.mip_levels;
+
+				vkCmdPipelineBarrier(cmd,
+									 graphics_vulkan_stage_from_image_layout(GPUImageLayout_Undefined),
+									 VK_PIPELINE_STAGE_TRANSFER_BIT,
+									 0u,
+									 0u,
+									 nullptr,
+									 0u,
+									 nullptr,
+									 1u,
+									 &memBarrier);
+
+				StagingBuffer staging_buffer;
+
+				// Create staging buffer and copy desc.pData
+				if (desc.type & GPUImageType_CubeMap) {
+
+					create_stagingbuffer(staging_buffer, desc.size * 6u);
+
+					u8** images = (u8 * *)desc.data;
+
+					foreach(i, 6u) {
+					
+						u32 k = i;
 
-			vkCheck(graphics_vulkan_singletimecmb_end(cmd));
-		}
+						if (k == 0u) k = 4u;
+						else if (k == 1u) k = 5u;
+						else if (k == 4u) k = 0u;
+						else if (k == 5u) k = 1u;
+
+						memcpy((u8*)staging_buffer.data + desc.size * k, images[i], desc.size);
+					}
+
+					foreach(i, 6u) {
+
+						// Copy buffer to image
+						VkBufferImageCopy copy_info{};
+						copy_info.bufferOffset = desc.size * i;
+						copy_info.bufferRowLength = 0u;
+						copy_info.bufferImageHeight = 0u;
+						copy_info.imageSubresource.aspectMask = aspect;
+						copy_info.imageSubresource.baseArrayLayer = i;
+						copy_info.imageSubresource.layerCount = 1u;
+						copy_info.imageSubresource.mipLevel = 0u;
+						copy_info.imageOffset = { 0, 0, 0 };
+						copy_info.imageExtent = { desc.width, desc.height, 1u };
+
+						vkCmdCopyBufferToImage(cmd, staging_buffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1u, &copy_info);
+					}
+				}
+				else {
 
-		// TODO: MipMapping
+					create_stagingbuffer(staging_buffer, desc.size);
+					memcpy(staging_buffer.data, desc.data, desc.size);
+
+					// Copy buffer to image
+					copy_image_levels(cmd, staging_buffer.buffer, image, desc, aspect);
+				}
+			
+				// Set the layout to desc.layout
+				memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				memBarrier.dstAccessMask = graphics_vulkan_access_from_image_layout(desc.layout);
+				memBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				memBarrier.newLayout = graphics_vulkan_parse_image_layout(desc.layout);
+
+				vkCmdPipelineBarrier(cmd,
+									 VK_PIPELINE_STAGE_TRANSFER_BIT,
+									 graphics_vulkan_stage_from_image_layout(desc.layout),
+									 0u,
+									 0u,
+									 nullptr,
+									 0u,
+									 nullptr,
+									 1u,
+									 &memBarrier);
+
+				vkCheck(graphics_vulkan_singletimecmb_end(cmd));
+
+				vkCheck(destroy_stagingbuffer(staging_buffer));
+			}
+			else {
+
+				VkImageMemoryBarrier memBarrier{};
+				memBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				memBarrier.srcAccessMask = graphics_vulkan_access_from_image_layout(GPUImageLayout_Undefined);
+				memBarrier.dstAccessMask = graphics_vulkan_access_from_image_layout(desc.layout);
+				memBarrier.oldLayout = graphics_vulkan_parse_image_layout(GPUImageLayout_Undefined);
+				memBarrier.newLayout = graphics_vulkan_parse_image_layout(desc.layout);
+				memBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				memBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				memBarrier.image = image.image;
+				memBarrier.subresourceRange.aspectMask = graphics_vulkan_aspect_from_image_layout(desc.layout, desc.format);
+				memBarrier.subresourceRange.layerCount = image.layers;
+				memBarrier.subresourceRange.levelCount = image.mip_levels;
+
+				vkCmdPipelineBarrier(cmd,
+									 graphics_vulkan_stage_from_image_layout(GPUImageLayout_Undefined),
+									 graphics_vulkan_stage_from_image_layout(desc.layout),
+									 0u,
+									 0u,
+									 nullptr,
+									 0u,
+									 nullptr,
+									 1u,
+									 &memBarrier);
+
+				vkCheck(graphics_vulkan_singletimecmb_end(cmd));
+			}
+		}
 
 		// Create Render Target View
 		if (desc.type & GPUImageType_RenderTarget) {
@@ -2711,7 +3396,7 @@ namespace sv {
 			}
 			else {
 
-				vkCheck(graphics_vulkan_imageview_create(image.image, format, view_type, VK_IMAGE_ASPECT_COLOR_BIT, image.layers, image.shader_resource_view.imageView));
+				vkCheck(graphics_vulkan_imageview_create(image.image, format, view_type, VK_IMAGE_ASPECT_COLOR_BIT, image.layers, image.shader_resource_view.imageView, image.mip_levels));
 				image.shader_resource_view.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 			}
 
@@ -2748,6 +3433,8 @@ namespace sv {
 
     bool graphics_vulkan_sampler_create(Sampler_vk& sampler, const SamplerDesc& desc)
     {
+		sampler.ID = g_API->GetID();
+
 		VkSamplerCreateInfo create_info{};
 		create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
 
@@ -2763,15 +3450,14 @@ namespace sv {
 		// TODO: Border Color
 		create_info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
 
-		// TODO: MipMapping
-		create_info.mipLodBias;
-		create_info.mipmapMode;
+		create_info.mipLodBias = 0.f;
+		create_info.mipmapMode = (desc.minFilter == SamplerFilter_Linear) ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
 
 		create_info.anisotropyEnable;
 		create_info.maxAnisotropy;
 
-		create_info.minLod;
-		create_info.maxLod;
+		create_info.minLod = 0.f;
+		create_info.maxLod = VK_LOD_CLAMP_NONE;
 
 		vkCheck(vkCreateSampler(g_API->device, &create_info, nullptr, &sampler.sampler));
 
@@ -2830,6 +3516,12 @@ namespace sv {
 			auto& uniforms = sr.uniform_buffers;
 
 			u32 last_index = (u32)bindings.size();
+
+			// Bind with dynamic offsets while the device limits allows it, the graphics stages share the pipeline layout
+			u32 max_dynamic = g_API->card.properties.limits.maxDescriptorSetUniformBuffersDynamic;
+			if (desc.shaderType != ShaderType_Compute) max_dynamic /= 3u;
+
+			bool dynamic = uniforms.size() <= max_dynamic;
 			
 			if (!uniforms.empty()) {
 
@@ -2845,7 +3537,7 @@ namespace sv {
 					bindings.emplace_back();
 					VkDescriptorSetLayoutBinding& binding = bindings.back();
 					binding.binding = comp.get_decoration(uniform.id, spv::Decoration::DecorationBinding);
-					binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+					binding.descriptorType = dynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 					binding.descriptorCount = 1u;
 					binding.stageFlags = graphics_vulkan_parse_shadertype(desc.shaderType);
 					binding.pImmutableSamplers = nullptr;
@@ -2860,7 +3552,7 @@ namespace sv {
 				}
 			}
 
-			shader.layout.count[VulkanDescriptorType_UniformBuffer] = u32(bindings.size()) - last_index;
+			shader.layout.count[dynamic ? VulkanDescriptorType_UniformBufferDynamic : VulkanDescriptorType_UniformBuffer] = u32(bindings.size()) - last_index;
 		}
 
 		// Shader Resources
@@ -3005,11 +3697,13 @@ namespace sv {
 			srb.descriptor_type = binding.descriptorType;
 			srb.vulkanBinding = binding.binding;
 			srb.userBinding = binding.binding;
+			srb.dynamicIndex = u32_max;
 
 			switch (binding.descriptorType)
 			{
 
 			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
 				srb.userBinding -= 0u;
 				break;
 
@@ -3033,6 +3727,23 @@ namespace sv {
 			}
 		}
 
+		// Dynamic offsets are consumed in binding order
+		shader.layout.dynamicCount = 0u;
+
+		for (ShaderResourceBinding& srb : shader.layout.bindings) {
+
+			if (srb.descriptor_type != VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) continue;
+
+			srb.dynamicIndex = 0u;
+
+			for (const ShaderResourceBinding& other : shader.layout.bindings) {
+				if (other.descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC && other.vulkanBinding < srb.vulkanBinding)
+					++srb.dynamicIndex;
+			}
+
+			++shader.layout.dynamicCount;
+		}
+
 		// Create set layout
 		{
 			VkDescriptorSetLayoutCreateInfo create_info{};
@@ -3072,7 +3783,7 @@ namespace sv {
 			
 			info.layout = shader.compute.pipeline_layout;
 
-			vkCheck(vkCreateComputePipelines(g_API->device, VK_NULL_HANDLE, 1, &info, NULL, &shader.compute.pipeline));
+			vkCheck(vkCreateComputePipelines(g_API->device, g_API->pipeline_cache, 1, &info, NULL, &shader.compute.pipeline));
 		}
 
 		return true;
@@ -3185,6 +3896,12 @@ namespace sv {
 
     bool graphics_vulkan_buffer_destroy(Buffer_vk& buffer)
     {
+		if (buffer.dynamic_data) {
+			SV_FREE_MEMORY(buffer.dynamic_data);
+			buffer.dynamic_data = nullptr;
+			return true;
+		}
+
 		vmaDestroyBuffer(g_API->allocator, buffer.buffer, buffer.allocation);
 		if (buffer.srv_texel_buffer_view) {
 			vkDestroyBufferView(g_API->device, buffer.srv_texel_buffer_view, NULL);
@@ -43,6 +43,10 @@ namespace sv {
     void graphics_vulkan_event_mark(const char* name, CommandList cmd);
     void graphics_vulkan_event_end(CommandList cmd);
 
+    bool graphics_vulkan_pipeline_prewarm(GraphicsState& state);
+    void graphics_vulkan_device_stats(GraphicsDeviceStats* stats);
+    bool graphics_vulkan_is_resident(Primitive_internal* primitive);
+
 }
 
 #endif
@@ -99,6 +103,8 @@ namespace sv {
     constexpr u32 VULKAN_MAX_DESCRIPTOR_SETS = 100u;
     constexpr u32 VULKAN_MAX_DESCRIPTOR_TYPES = 32u;
     constexpr u32 VULKAN_DESCRIPTOR_ALLOC_COUNT = 10u;
+    constexpr u32 VULKAN_DESCRIPTOR_CACHE_SIZE = 256u; // Per layout, commandlist and frame
+    constexpr u32 VULKAN_RING_BUFFER_SIZE = 256u * 1024u; // Initial size of the constant buffer rings
     constexpr f64 VULKAN_UNUSED_OBJECTS_TIMECHECK = 30.0;
     constexpr f64 VULKAN_UNUSED_OBJECTS_LIFETIME = 10.0;
 
@@ -121,10 +127,41 @@ namespace sv {
 		List<Buffer> buffers;
     };
 
+    // Persistently mapped linear allocator used by the dynamic constant buffers.
+    // The buffers are bound using dynamic offsets, so an update is only a pointer bump plus a memcpy
+    struct VulkanRingBuffer {
+		StagingBuffer		buffer;
+		u32					size = 0u;
+		u32					offset = 0u;
+		List<StagingBuffer> retired; // Replaced by a bigger buffer, released when the frame is reused
+    };
+
+    // Staging copies recorded by the async uploads, submitted to the transfer queue once per frame
+    struct VulkanUploadBatch {
+		VkCommandBuffer     cmd = VK_NULL_HANDLE;
+		VkFence             fence = VK_NULL_HANDLE;
+		List<StagingBuffer> staging_buffers;
+		u64                 ticket = 0u;
+    };
+
+    struct VulkanUploadQueue {
+		VkCommandPool           commandPool = VK_NULL_HANDLE;
+		Mutex                   mutex;
+		VulkanUploadBatch       recording;
+		bool                    is_recording = false;
+		List<VulkanUploadBatch> in_flight; // Sorted by ticket
+		List<VulkanUploadBatch> free_batches;
+		u64                     next_ticket = 1u;
+		std::atomic<u64>        completed_ticket = 0u;
+		u32                     uploads = 0u;
+		u64                     upload_bytes = 0u;
+    };
+
     struct DynamicAllocation {
 		VkBuffer buffer = VK_NULL_HANDLE;
 		void* data = nullptr;
 		u32 offset = 0u;
+		u64 frame = 0u;
 
 		SV_INLINE bool isValid() const noexcept { return buffer != VK_NULL_HANDLE && data != nullptr; }
     };
@@ -133,6 +170,7 @@ namespace sv {
 
 	enum VulkanDescriptorType : u32 {
 		VulkanDescriptorType_UniformBuffer,
+		VulkanDescriptorType_UniformBufferDynamic,
 		VulkanDescriptorType_UniformTexelBuffer,
 		VulkanDescriptorType_SampledImage,
 		VulkanDescriptorType_StorageBuffer,
@@ -148,9 +186,34 @@ namespace sv {
 		u32 sets;
     };
 
+    // Bound resources of a set: the resource ID, the handles, the offsets and the binding of each write.
+    // A hash match is a hit only if the keys are equal
+    constexpr u32 VULKAN_DESCRIPTOR_KEY_SIZE = (GraphicsLimit_ConstantBuffer + GraphicsLimit_ShaderResource + GraphicsLimit_UnorderedAccessView + GraphicsLimit_Sampler) * 4u;
+
+    struct DescriptorSetKey {
+		u64    values[VULKAN_DESCRIPTOR_KEY_SIZE];
+		u32    size = 0u;
+		size_t hash = 0u;
+    };
+
+    struct DescriptorSetEntry {
+		VkDescriptorSet set;
+		size_t			hash;
+		List<u64>		key;
+		u64				last_frame;
+		u32				prev;
+		u32				next;
+    };
+
     struct VulkanDescriptorSet {
 		List<VkDescriptorSet>	sets;
 		u32			used = 0u;
+
+		// Sets cached by the hash of the bound resources, sorted by usage (LRU)
+		List<DescriptorSetEntry>		entries;
+		std::unordered_map<size_t, u32> table;
+		u32 lru_first = u32_max;
+		u32 lru_last = u32_max;
     };
 
     struct DescriptorPool {
@@ -163,11 +226,13 @@ namespace sv {
 		VkDescriptorType descriptor_type;
 		u32				 vulkanBinding;
 		u32				 userBinding;
+		u32				 dynamicIndex; // Index in the dynamic offsets array, sorted by binding
     };
     struct ShaderDescriptorSetLayout {
 		VkDescriptorSetLayout setLayout;
 		List<ShaderResourceBinding> bindings;
 		u32 count[VulkanDescriptorType_MaxEnum];
+		u32 dynamicCount;
     };
 
     // PIPELINE
@@ -186,6 +251,8 @@ namespace sv {
 		VkPipelineLayout	             layout = VK_NULL_HANDLE;
 		ThickHashTable<VkPipeline, 100u> pipelines;
 		VkDescriptorSet		             descriptorSets[ShaderType_GraphicsCount] = {};
+		u32				                 dynamicOffsets[ShaderType_GraphicsCount][GraphicsLimit_ConstantBuffer] = {};
+		u32				                 dynamicCount[ShaderType_GraphicsCount] = {};
 		f64			                     lastUsage;
     };
 
@@ -196,6 +263,9 @@ namespace sv {
     bool graphics_vulkan_pipeline_destroy(VulkanPipeline& pipeline);
     VkPipeline graphics_vulkan_pipeline_get(VulkanPipeline& pipeline, GraphicsState& state, size_t hash);
 
+    bool graphics_vulkan_pipeline_cache_create();
+    void graphics_vulkan_pipeline_cache_destroy(); // Saves the cache in the system bin
+
     // PRIMITIVES
 
     // Buffer
@@ -206,6 +276,9 @@ namespace sv {
 		VkBufferView            srv_texel_buffer_view;
 		VkBufferView            uav_texel_buffer_view;
 		DynamicAllocation		dynamic_allocation[GraphicsLimit_CommandList];
+		u8*						dynamic_data = nullptr; // CPU copy of a dynamic constant buffer, uploaded again when it is bound in a new frame
+		u64						ID;
+		u64						upload_ticket = 0u; // Resident when the upload queue completes this ticket
     };
     // Image
     struct Image_vk : public GPUImage_internal {
@@ -216,12 +289,15 @@ namespace sv {
 		VkDescriptorImageInfo	shader_resource_view = {};
 		VkDescriptorImageInfo	unordered_access_view = {};
 		u32						layers = 1u;
+		u32						mip_levels = 1u;
 		u64						ID;
+		u64						upload_ticket = 0u;
     };
     // Sampler
     struct Sampler_vk : public Sampler_internal {
 		VkSampler				sampler = VK_NULL_HANDLE;
 		VkDescriptorImageInfo	image_info;
+		u64						ID;
     };
     // Shader
     struct Shader_vk : public Shader_internal {
@@ -269,6 +345,7 @@ namespace sv {
 		VkFence				fence;
 		DescriptorPool		descPool[GraphicsLimit_CommandList];
 		VulkanGPUAllocator	allocator[GraphicsLimit_CommandList];
+		VulkanRingBuffer	ring[GraphicsLimit_CommandList];
     };
 
     struct SwapChain_vk {
@@ -309,6 +386,7 @@ namespace sv {
 
 			struct {
 				u32 graphics = UINT32_MAX;
+				u32 transfer = UINT32_MAX; // Dedicated transfer family if exists, graphics otherwise
 
 				SV_INLINE bool IsComplete() const noexcept { return graphics != u32_max; }
 
@@ -332,6 +410,9 @@ namespace sv {
 		List<const char*> deviceValidationLayers;
 
 		VkQueue queueGraphics = VK_NULL_HANDLE;
+		VkQueue queueTransfer = VK_NULL_HANDLE;
+
+		VulkanUploadQueue upload;
 	
 		f64 lastTime = 0.0;
 
@@ -350,9 +431,14 @@ namespace sv {
 
 		VkRenderPass activeRenderPass[GraphicsLimit_CommandList];
 
+		u64 frameNumber = 0u;
+		GraphicsDeviceStats stats[GraphicsLimit_CommandList];
+		GraphicsDeviceStats last_stats;
+
 		// TODO
 		std::unordered_map<u64, VulkanPipeline>        pipelines;
 		Mutex			                               pipeline_mutex;
+		VkPipelineCache                                pipeline_cache = VK_NULL_HANDLE;
 
 		u64 IDCount = 0u;
 		Mutex IDMutex;
@@ -366,8 +452,13 @@ namespace sv {
     VkResult graphics_vulkan_singletimecmb_begin(VkCommandBuffer* pCmd);
     VkResult graphics_vulkan_singletimecmb_end(VkCommandBuffer cmd);
 
+    // Returns the command buffer of the current upload batch, the upload mutex must be locked
+    VkCommandBuffer graphics_vulkan_upload_begin(u64* ticket);
+    void graphics_vulkan_upload_flush();
+    void graphics_vulkan_upload_update(); // Releases the completed batches
+
     void graphics_vulkan_buffer_copy(VkCommandBuffer cmd, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize size);
-    VkResult graphics_vulkan_imageview_create(VkImage image, VkFormat format, VkImageViewType viewType, VkImageAspectFlags aspectFlags, u32 layerCount, VkImageView& view);
+    VkResult graphics_vulkan_imageview_create(VkImage image, VkFormat format, VkImageViewType viewType, VkImageAspectFlags aspectFlags, u32 layerCount, VkImageView& view, u32 levelCount = 1u);
 
     VkSemaphore graphics_vulkan_semaphore_create();
     VkFence graphics_vulkan_fence_create(bool sign);
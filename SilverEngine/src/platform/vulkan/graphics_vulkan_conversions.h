@@ -168,6 +168,12 @@ namespace sv {
 		case Format_BC5_SNORM:
 			return VK_FORMAT_BC5_SNORM_BLOCK;
 
+		case Format_BC7_UNORM:
+			return VK_FORMAT_BC7_UNORM_BLOCK;
+
+		case Format_BC7_SRGB:
+			return VK_FORMAT_BC7_SRGB_BLOCK;
+
 		case Format_B8G8R8A8_UNORM:
 			return VK_FORMAT_B8G8R8A8_UNORM;
 
@@ -345,6 +351,12 @@ namespace sv {
 		case VK_FORMAT_BC5_SNORM_BLOCK:
 			return Format_BC5_SNORM;
 
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+			return Format_BC7_UNORM;
+
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			return Format_BC7_SRGB;
+
 		case VK_FORMAT_B8G8R8A8_UNORM:
 			return Format_B8G8R8A8_UNORM;
 
@@ -29,6 +29,89 @@ namespace sv {
 		return hash;
     }
 
+    constexpr const char* PIPELINE_CACHE_BIN_NAME = "VulkanPipelineCache";
+
+    bool graphics_vulkan_pipeline_cache_create()
+    {
+		Graphics_vk& gfx = graphics_vulkan_device_get();
+
+		RawList data;
+		size_t hash = hash_string(PIPELINE_CACHE_BIN_NAME);
+
+		VkPipelineCacheCreateInfo create_info{};
+		create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		create_info.flags = 0u;
+
+		if (bin_read(hash, data, true)) {
+
+			// The header must match with the current driver, otherwise the data is useless
+			const VkPhysicalDeviceProperties& props = gfx.card.properties;
+			bool valid = data.size() >= 16u + VK_UUID_SIZE;
+
+			if (valid) {
+				u32 header[4];
+				memcpy(header, data.data(), sizeof(u32) * 4u);
+
+				valid = header[0] >= 16u + VK_UUID_SIZE
+					&& header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+					&& header[2] == props.vendorID
+					&& header[3] == props.deviceID
+					&& memcmp(data.data() + 16u, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+			}
+
+			if (valid) {
+				create_info.initialDataSize = data.size();
+				create_info.pInitialData = data.data();
+			}
+			else SV_LOG_WARNING("The pipeline cache is outdated");
+		}
+
+		VkResult res = vkCreatePipelineCache(gfx.device, &create_info, nullptr, &gfx.pipeline_cache);
+
+		// Try again without the initial data
+		if (res != VK_SUCCESS && create_info.pInitialData != nullptr) {
+
+			create_info.initialDataSize = 0u;
+			create_info.pInitialData = nullptr;
+			res = vkCreatePipelineCache(gfx.device, &create_info, nullptr, &gfx.pipeline_cache);
+		}
+
+		if (res != VK_SUCCESS) {
+			SV_LOG_ERROR("Can't create the pipeline cache");
+			gfx.pipeline_cache = VK_NULL_HANDLE;
+			return false;
+		}
+
+		if (create_info.pInitialData)
+			SV_LOG_INFO("Pipeline cache loaded: %zu bytes", create_info.initialDataSize);
+
+		return true;
+    }
+
+    void graphics_vulkan_pipeline_cache_destroy()
+    {
+		Graphics_vk& gfx = graphics_vulkan_device_get();
+
+		if (gfx.pipeline_cache == VK_NULL_HANDLE) return;
+
+		size_t size = 0u;
+		if (vkGetPipelineCacheData(gfx.device, gfx.pipeline_cache, &size, nullptr) == VK_SUCCESS && size) {
+
+			RawList data;
+			data.resize(size);
+			
+			if (vkGetPipelineCacheData(gfx.device, gfx.pipeline_cache, &size, data.data()) == VK_SUCCESS) {
+
+				if (!bin_write(hash_string(PIPELINE_CACHE_BIN_NAME), data.data(), size, true)) {
+					SV_LOG_ERROR("Can't save the pipeline cache");
+				}
+			}
+		}
+
+		vkDestroyPipelineCache(gfx.device, gfx.pipeline_cache, nullptr);
+		gfx.pipeline_cache = VK_NULL_HANDLE;
+    }
+
     bool graphics_vulkan_pipeline_create(VulkanPipeline& p, Shader_vk* pVertexShader, Shader_vk* pPixelShader, Shader_vk* pGeometryShader)
     {
 		Graphics_vk& gfx = graphics_vulkan_device_get();
@@ -307,7 +390,7 @@ namespace sv {
 			create_info.renderPass = renderPass.renderPass;
 			create_info.subpass = 0u;
 
-			vkAssert(vkCreateGraphicsPipelines(gfx.device, VK_NULL_HANDLE, 1u, &create_info, nullptr, &res));
+			vkAssert(vkCreateGraphicsPipelines(gfx.device, gfx.pipeline_cache, 1u, &create_info, nullptr, &res));
 			pipeline.pipelines[hash] = res;
 		}
 		else {
@@ -9,6 +9,7 @@
 #include <iostream>
 
 #include "core/engine.h"
+#include "platform/graphics.h"
 
 namespace sv {
 
@@ -343,6 +344,13 @@ int main(int argc, char* argv[])
     platform.resize_request = false;
     platform.state = WindowState_Windowed;
 
+    for (int i = 1; i < argc; ++i) {
+
+		// Headless device for automated runs
+		if (strcmp(argv[i], "-null_graphics") == 0)
+			_graphics_api_request(GraphicsAPI_Null);
+    }
+
     engine_main();
 
     if (platform.user_lib)
@@ -546,6 +554,14 @@ namespace sv {
 
     bool file_read_binary(const char* filepath_, u8** pdata, size_t* psize)
     {
+		const u8* pack_data;
+		if (pack_find(filepath_, &pack_data, psize)) {
+
+			*pdata = (u8*)SV_ALLOCATE_MEMORY(*psize, "Unknown");
+			memcpy(*pdata, pack_data, *psize);
+			return true;
+		}
+		
 		char filepath[MAX_PATH];
 		filepath_resolve(filepath, filepath_);
 	
@@ -569,7 +585,7 @@ namespace sv {
 		return true;
     }
 
-    bool file_read_binary(const char* filepath_, RawList& data)
+    SV_AUX bool file_read_loose(const char* filepath_, RawList& data)
     {
 		char filepath[MAX_PATH];
 		filepath_resolve(filepath, filepath_);
@@ -591,9 +607,32 @@ namespace sv {
 		CloseHandle(file);
 		return true;
     }
+
+    bool file_read_binary(const char* filepath, RawList& data)
+    {
+		const u8* pack_data;
+		size_t size;
+		if (pack_find(filepath, &pack_data, &size)) {
+
+			data.resize(size);
+			memcpy(data.data(), pack_data, size);
+			return true;
+		}
+
+		return file_read_loose(filepath, data);
+    }
     
     bool file_read_text(const char* filepath_, char** pstr, size_t* psize)
     {
+		const u8* pack_data;
+		if (pack_find(filepath_, &pack_data, psize)) {
+
+			*pstr = (char*)SV_ALLOCATE_MEMORY(*psize + 1u, "Unknown");
+			memcpy(*pstr, pack_data, *psize);
+			(*pstr)[*psize] = '\0';
+			return true;
+		}
+		
 		char filepath[MAX_PATH];
 		filepath_resolve(filepath, filepath_);
 	
@@ -616,11 +655,8 @@ namespace sv {
 		return true;
     }
 
-    bool file_read_text(const char* filepath_, String& str)
+    bool file_read_text(const char* filepath, String& str)
     {
-		char filepath[MAX_PATH];
-		filepath_resolve(filepath, filepath_);
-	
 		char* buff;
 		size_t size;
 		if (file_read_text(filepath, &buff, &size)) {
@@ -663,6 +699,85 @@ namespace sv {
 		return true;
     }
     
+    bool file_map(const char* filepath_, FileMapping& mapping)
+    {
+		mapping = {};
+		
+		const u8* pack_data;
+		size_t pack_size;
+		if (pack_find(filepath_, &pack_data, &pack_size)) {
+
+			mapping.data = pack_data;
+			mapping.size = pack_size;
+			return true;
+		}
+		
+		char filepath[MAX_PATH];
+		filepath_resolve(filepath, filepath_);
+
+		HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		GetFileSizeEx(file, &size);
+
+		// Empty files can't be mapped
+		if (size.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0u, 0u, NULL);
+		if (map == NULL) {
+			CloseHandle(file);
+			return false;
+		}
+
+		const u8* data = (const u8*)MapViewOfFile(map, FILE_MAP_READ, 0u, 0u, 0u);
+		if (data == NULL) {
+			CloseHandle(map);
+			CloseHandle(file);
+			return false;
+		}
+
+		mapping.data = data;
+		mapping.size = size_t(size.QuadPart);
+		mapping._file = u64(file);
+		mapping._mapping = u64(map);
+		return true;
+    }
+
+    void file_unmap(FileMapping& mapping)
+    {
+		// The pack memory is not owned
+		if (mapping._mapping) {
+			
+			UnmapViewOfFile(mapping.data);
+			CloseHandle(HANDLE(mapping._mapping));
+			CloseHandle(HANDLE(mapping._file));
+		}
+
+		mapping = {};
+    }
+
+    void file_prefetch(const FileMapping& mapping)
+    {
+		// Reads a byte per page
+		const volatile u8* it = mapping.data;
+		const volatile u8* end = mapping.data + mapping.size;
+
+		u8 value = 0u;
+		
+		while (it < end) {
+			value += *it;
+			it += 4096u;
+		}
+
+		(void)value;
+    }
+    
     bool file_write_binary(const char* filepath_, const u8* data, size_t size, bool append, bool recursive)
     {
 		char filepath[MAX_PATH];
@@ -691,6 +806,85 @@ namespace sv {
 		return true;
     }
     
+    bool file_writer_open(FileWriter& writer, const char* filepath_, bool recursive)
+    {
+		writer = {};
+		
+		char filepath[MAX_PATH];
+		filepath_resolve(filepath, filepath_);
+	
+		HANDLE file = CreateFile(filepath, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	
+		if (file == INVALID_HANDLE_VALUE) {
+	    
+			if (recursive) {
+		
+				if (!create_path(filepath)) return false;
+
+				file = CreateFile(filepath, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+				if (file == INVALID_HANDLE_VALUE) return false;
+			}
+			else return false;
+		}
+
+		writer._handle = u64(file);
+		return true;
+    }
+
+    SV_AUX bool write_file_handle(HANDLE file, const void* data, size_t size)
+    {
+		const u8* it = (const u8*)data;
+
+		// WriteFile is limited to 4 GB per call
+		while (size) {
+
+			DWORD write = DWORD(SV_MIN(size, size_t(0x40000000u)));
+			DWORD written = 0u;
+			
+			if (!WriteFile(file, it, write, &written, NULL) || written != write)
+				return false;
+
+			it += write;
+			size -= write;
+		}
+
+		return true;
+    }
+
+    bool file_writer_write(FileWriter& writer, const void* data, size_t size)
+    {
+		if (writer._handle == 0u) return false;
+		return write_file_handle(HANDLE(writer._handle), data, size);
+    }
+
+    bool file_writer_write_at(FileWriter& writer, size_t offset, const void* data, size_t size)
+    {
+		if (writer._handle == 0u) return false;
+		
+		HANDLE file = HANDLE(writer._handle);
+
+		LARGE_INTEGER pos;
+		pos.QuadPart = LONGLONG(offset);
+		
+		if (!SetFilePointerEx(file, pos, NULL, FILE_BEGIN)) return false;
+		
+		bool res = write_file_handle(file, data, size);
+
+		pos.QuadPart = 0;
+		SetFilePointerEx(file, pos, NULL, FILE_END);
+		
+		return res;
+    }
+
+    void file_writer_close(FileWriter& writer)
+    {
+		if (writer._handle) {
+			CloseHandle(HANDLE(writer._handle));
+		}
+
+		writer = {};
+    }
+    
     bool file_write_text(const char* filepath_, const char* str, size_t size, bool append, bool recursive)
     {
 		char filepath[MAX_PATH];
@@ -788,8 +982,22 @@ namespace sv {
 		return true;
     }
 
+    bool file_rename(const char* srcpath_, const char* dstpath_)
+    {
+		char srcpath[MAX_PATH];
+		char dstpath[MAX_PATH];
+		filepath_resolve(srcpath, srcpath_);
+		filepath_resolve(dstpath, dstpath_);
+
+		return MoveFileExA(srcpath, dstpath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    }
+
     bool file_exists(const char* filepath_)
     {
+		const u8* pack_data;
+		size_t pack_size;
+		if (pack_find(filepath_, &pack_data, &pack_size)) return true;
+		
 		char filepath[MAX_PATH];
 		filepath_resolve(filepath, filepath_);
 	
@@ -923,7 +1131,24 @@ namespace sv {
     {
 		char filepath[BIN_PATH_SIZE + 1u];
 		bin_filepath(filepath, hash, system);
-		return file_read_binary(filepath, data);
+		
+		if (!file_read_binary(filepath, data))
+			return false;
+
+		if (data_is_compressed(data.data(), data.size())) {
+
+			RawList raw;
+			
+			if (!decompress_data(data.data(), data.size(), raw)) {
+				SV_LOG_ERROR("The compressed bin '%s' is corrupted", filepath);
+				return false;
+			}
+
+			data.clear();
+			data.write_back(raw.data(), raw.size());
+		}
+
+		return true;
     }
     
     bool bin_read(u64 hash, Deserializer& deserializer, bool system)
@@ -933,20 +1158,427 @@ namespace sv {
 		return deserialize_begin(deserializer, filepath);
     }
 
+    // The bin files are always compressed, bin_read accepts the raw ones written before
     bool bin_write(u64 hash, const void* data, size_t size, bool system)
     {
 		char filepath[BIN_PATH_SIZE + 1u];
 		bin_filepath(filepath, hash, system);
-		return file_write_binary(filepath, (u8*)data, size);
+
+		RawList compressed;
+		compress_data(data, size, compressed);
+		
+		return file_write_binary(filepath, compressed.data(), compressed.size());
     }
     
     bool bin_write(u64 hash, Serializer& serializer, bool system)
     {
 		char filepath[BIN_PATH_SIZE + 1u];
 		bin_filepath(filepath, hash, system);
+		serializer.compress = true;
 		return serialize_end(serializer, filepath);
     }
 
+    //////////////////////////////// PACK FILES ////////////////////////////
+
+    constexpr u32 PACK_MAGIC = 0x4B505653; // SVPK
+    constexpr u32 PACK_VERSION = 0u;
+
+    struct PackHeader {
+		u32 magic;
+		u32 version;
+		u32 entry_count;
+		u32 names_size;
+		u64 toc_offset;
+		u64 names_offset;
+    };
+
+    struct PackEntry {
+		u64 hash;
+		u64 offset;
+		u64 size;
+		u32 compression;
+		u32 name_offset; // Compared after a hash match
+    };
+
+    struct Pack {
+		HANDLE           file;
+		HANDLE           mapping;
+		const u8*        data;
+		size_t           size;
+		const PackEntry* entries;
+		u32              entry_count;
+		const char*      names;
+		u32              names_size;
+    };
+
+    struct PackState {
+		Pack             packs[PACK_MAX];
+		std::atomic<u32> pack_count = 0u;
+    };
+
+    static PackState pack_state;
+
+    SV_AUX u64 pack_hash(const char* filepath)
+    {
+		// Same hash for '/' and '\\'
+		size_t hash = 0u;
+		
+		while (*filepath != '\0') {
+
+			char c = *filepath;
+			if (c == '\\') c = '/';
+			
+			hash_combine(hash, size_t(c));
+			++filepath;
+		}
+		
+		return u64(hash);
+    }
+
+    SV_AUX const PackEntry* pack_find_entry(const Pack& pack, u64 hash)
+    {
+		u32 begin = 0u;
+		u32 end = pack.entry_count;
+
+		while (begin < end) {
+
+			u32 mid = begin + (end - begin) / 2u;
+			const PackEntry& entry = pack.entries[mid];
+
+			if (entry.hash == hash) return &entry;
+			if (entry.hash < hash) begin = mid + 1u;
+			else end = mid;
+		}
+
+		return NULL;
+    }
+
+    SV_AUX bool pack_name_equals(const Pack& pack, const PackEntry& entry, const char* filepath)
+    {
+		const char* name = pack.names + entry.name_offset;
+		const char* end = pack.names + pack.names_size;
+
+		while (name < end) {
+
+			char c0 = *name;
+			char c1 = *filepath;
+			if (c0 == '\\') c0 = '/';
+			if (c1 == '\\') c1 = '/';
+
+			if (c0 != c1) return false;
+			if (c0 == '\0') return true;
+
+			++name;
+			++filepath;
+		}
+
+		return false;
+    }
+
+    SV_AUX bool pack_open(Pack& pack, const char* filepath_)
+    {
+		char filepath[MAX_PATH];
+		filepath_resolve(filepath, filepath_);
+
+		pack.file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+		if (pack.file == INVALID_HANDLE_VALUE) {
+			SV_LOG_ERROR("Can't open the pack '%s'", filepath_);
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		GetFileSizeEx(pack.file, &size);
+		pack.size = size_t(size.QuadPart);
+
+		if (pack.size < sizeof(PackHeader)) {
+			SV_LOG_ERROR("Invalid pack '%s'", filepath_);
+			CloseHandle(pack.file);
+			return false;
+		}
+		
+		pack.mapping = CreateFileMappingA(pack.file, NULL, PAGE_READONLY, 0u, 0u, NULL);
+		if (pack.mapping == NULL) {
+			SV_LOG_ERROR("Can't map the pack '%s'", filepath_);
+			CloseHandle(pack.file);
+			return false;
+		}
+
+		pack.data = (const u8*)MapViewOfFile(pack.mapping, FILE_MAP_READ, 0u, 0u, 0u);
+		if (pack.data == NULL) {
+			SV_LOG_ERROR("Can't map the pack '%s'", filepath_);
+			CloseHandle(pack.mapping);
+			CloseHandle(pack.file);
+			return false;
+		}
+
+		const PackHeader* header = (const PackHeader*)pack.data;
+
+		bool valid = header->magic == PACK_MAGIC && header->version == PACK_VERSION
+			&& header->toc_offset + u64(header->entry_count) * sizeof(PackEntry) <= pack.size
+			&& header->names_offset + header->names_size <= pack.size;
+
+		// Every payload and name is inside the file, the lookups don't check it again
+		if (valid) {
+
+			const PackEntry* entries = (const PackEntry*)(pack.data + header->toc_offset);
+
+			foreach(i, header->entry_count) {
+
+				const PackEntry& entry = entries[i];
+
+				if (entry.offset > pack.size || entry.size > pack.size - entry.offset || entry.name_offset >= header->names_size) {
+					valid = false;
+					break;
+				}
+			}
+		}
+
+		if (!valid) {
+			SV_LOG_ERROR("Invalid pack '%s'", filepath_);
+			UnmapViewOfFile(pack.data);
+			CloseHandle(pack.mapping);
+			CloseHandle(pack.file);
+			return false;
+		}
+
+		pack.entries = (const PackEntry*)(pack.data + header->toc_offset);
+		pack.entry_count = header->entry_count;
+		pack.names = (const char*)(pack.data + header->names_offset);
+		pack.names_size = header->names_size;
+
+		return true;
+    }
+
+    SV_AUX void pack_close(Pack& pack)
+    {
+		UnmapViewOfFile(pack.data);
+		CloseHandle(pack.mapping);
+		CloseHandle(pack.file);
+		SV_ZERO_MEMORY(&pack, sizeof(Pack));
+    }
+
+    bool pack_mount(const char* pack_filepath)
+    {
+		u32 count = pack_state.pack_count.load();
+		
+		if (count >= PACK_MAX) {
+			SV_LOG_ERROR("Can't mount the pack '%s', the limit is %u", pack_filepath, PACK_MAX);
+			return false;
+		}
+
+		SV_CHECK(pack_open(pack_state.packs[count], pack_filepath));
+
+		// The pack is visible when is completely initialized
+		pack_state.pack_count.store(count + 1u);
+
+		SV_LOG_INFO("Pack mounted: '%s', %u files", pack_filepath, pack_state.packs[count].entry_count);
+		return true;
+    }
+
+    void pack_unmount_all()
+    {
+		u32 count = pack_state.pack_count.load();
+		pack_state.pack_count.store(0u);
+
+		foreach(i, count) {
+			pack_close(pack_state.packs[i]);
+		}
+    }
+
+    bool pack_find(const char* filepath, const u8** pdata, size_t* psize)
+    {
+		u32 count = pack_state.pack_count.load();
+		if (count == 0u) return false;
+
+		u64 hash = pack_hash(filepath);
+
+		// The last mounted packs have priority
+		for (u32 i = count; i-- > 0u;) {
+
+			const Pack& pack = pack_state.packs[i];
+			const PackEntry* entry = pack_find_entry(pack, hash);
+
+			// The hash can collide with a file that is not in the pack
+			if (entry && entry->compression == PackCompression_None && pack_name_equals(pack, *entry, filepath)) {
+
+				*pdata = pack.data + entry->offset;
+				*psize = size_t(entry->size);
+				return true;
+			}
+		}
+
+		return false;
+    }
+
+    struct PackFile {
+		char filepath[FILEPATH_SIZE + 1u];
+		u64  hash;
+		u64  size;
+    };
+
+    SV_AUX void pack_collect_files(const char* folder, List<PackFile>& files)
+    {
+		FolderIterator it;
+		FolderElement e;
+
+		if (folder_iterator_begin(folder, &it, &e)) {
+
+			do {
+
+				if (string_equals(e.name, ".") || string_equals(e.name, "..")) continue;
+
+				char filepath[FILEPATH_SIZE + 1u];
+				string_copy(filepath, folder, FILEPATH_SIZE + 1u);
+				
+				size_t size = string_size(filepath);
+				if (size && filepath[size - 1u] != '/') string_append(filepath, "/", FILEPATH_SIZE + 1u);
+				string_append(filepath, e.name, FILEPATH_SIZE + 1u);
+
+				if (e.is_file) {
+
+					PackFile& file = files.emplace_back();
+					string_copy(file.filepath, filepath, FILEPATH_SIZE + 1u);
+					file.hash = pack_hash(filepath);
+				}
+				else pack_collect_files(filepath, files);
+			}
+			while (folder_iterator_next(&it, &e));
+
+			folder_iterator_close(&it);
+		}
+    }
+
+    SV_AUX u64 pack_align(u64 offset)
+    {
+		return (offset + u64(PACK_ALIGNMENT - 1u)) & ~u64(PACK_ALIGNMENT - 1u);
+    }
+
+    bool pack_build(const char* pack_filepath, const char** folders, u32 folder_count)
+    {
+		List<PackFile> files;
+
+		foreach(i, folder_count) {
+			pack_collect_files(folders[i], files);
+		}
+
+		std::sort(files.data(), files.data() + files.size(), [](const PackFile& f0, const PackFile& f1) {
+			return f0.hash < f1.hash;
+		});
+
+		for (size_t i = 1u; i < files.size(); ++i) {
+			if (files[i].hash == files[i - 1u].hash) {
+				SV_LOG_ERROR("Can't build the pack '%s', hash collision between '%s' and '%s'", pack_filepath, files[i].filepath, files[i - 1u].filepath);
+				return false;
+			}
+		}
+
+		u32 entry_count = u32(files.size());
+
+		List<PackEntry> entries;
+		entries.resize(entry_count);
+
+		RawList names;
+
+		foreach(i, entry_count) {
+
+			PackEntry& entry = entries[i];
+			entry.hash = files[i].hash;
+			entry.compression = PackCompression_None;
+			entry.name_offset = u32(names.size());
+
+			names.write_back(files[i].filepath, string_size(files[i].filepath) + 1u);
+		}
+
+		PackHeader header;
+		header.magic = PACK_MAGIC;
+		header.version = PACK_VERSION;
+		header.entry_count = entry_count;
+		header.names_size = u32(names.size());
+		header.toc_offset = sizeof(PackHeader);
+		header.names_offset = header.toc_offset + u64(entry_count) * sizeof(PackEntry);
+
+		RawList buff;
+		RawList data;
+		u64 offset = pack_align(header.names_offset + header.names_size);
+
+		buff.resize(size_t(offset));
+		
+		// Payloads
+		foreach(i, entry_count) {
+
+			PackEntry& entry = entries[i];
+			
+			if (!file_read_loose(files[i].filepath, data)) {
+				SV_LOG_ERROR("Can't read '%s'", files[i].filepath);
+				return false;
+			}
+
+			entry.offset = offset;
+			entry.size = u64(data.size());
+
+			offset = pack_align(offset + entry.size);
+			buff.resize(size_t(offset));
+
+			if (data.size()) memcpy(buff.data() + entry.offset, data.data(), data.size());
+		}
+
+		memcpy(buff.data(), &header, sizeof(PackHeader));
+		if (entry_count) memcpy(buff.data() + header.toc_offset, entries.data(), entry_count * sizeof(PackEntry));
+		if (names.size()) memcpy(buff.data() + header.names_offset, names.data(), names.size());
+
+		SV_CHECK(file_write_binary(pack_filepath, buff.data(), buff.size()));
+
+		SV_LOG_INFO("Pack '%s' built: %u files, %zu bytes", pack_filepath, entry_count, buff.size());
+		return true;
+    }
+
+    bool pack_benchmark(const char* pack_filepath)
+    {
+		// Packed
+		f64 begin = timer_now();
+
+		Pack pack;
+		SV_CHECK(pack_open(pack, pack_filepath));
+		
+		RawList data;
+		u64 packed_bytes = 0u;
+		
+		foreach(i, pack.entry_count) {
+
+			const PackEntry& entry = pack.entries[i];
+			data.resize(size_t(entry.size));
+			memcpy(data.data(), pack.data + entry.offset, size_t(entry.size));
+			packed_bytes += entry.size;
+		}
+
+		f64 packed_time = timer_now() - begin;
+
+		// Loose
+		begin = timer_now();
+
+		u64 loose_bytes = 0u;
+		u32 loose_count = 0u;
+		
+		foreach(i, pack.entry_count) {
+
+			const char* filepath = pack.names + pack.entries[i].name_offset;
+
+			if (file_read_loose(filepath, data)) {
+				loose_bytes += data.size();
+				++loose_count;
+			}
+		}
+
+		f64 loose_time = timer_now() - begin;
+
+		SV_LOG_INFO("Pack benchmark '%s'", pack_filepath);
+		SV_LOG_INFO("Packed: %u files, %zu bytes, %.2f ms", pack.entry_count, size_t(packed_bytes), f32(packed_time * 1000.0));
+		SV_LOG_INFO("Loose:  %u files, %zu bytes, %.2f ms", loose_count, size_t(loose_bytes), f32(loose_time * 1000.0));
+
+		pack_close(pack);
+		return true;
+    }
+
     //////////////////////////////// MULTITHREADING ////////////////////////////
 
     bool mutex_create(Mutex& mutex)
@@ -974,6 +1606,325 @@ namespace sv {
 		ReleaseMutex((HANDLE)mutex._handle);
     }
 
+	// TASK SYSTEM
+
+	constexpr u32 TASK_THREAD_MAX = 16u;
+	constexpr u32 TASK_QUEUE_SIZE = 1024u;
+
+	struct Task {
+		TaskFn       fn;
+		TaskContext* context;
+		u8           data[TASK_DATA_SIZE];
+	};
+
+	struct TaskSystem {
+		HANDLE            threads[TASK_THREAD_MAX];
+		u32               thread_count = 0u;
+		HANDLE            semaphore = NULL;
+		Mutex             mutex;
+		Task              queue[TASK_QUEUE_SIZE];
+		u32               queue_begin = 0u;
+		u32               queue_count = 0u;
+		std::atomic<bool> running = false;
+	};
+
+	static TaskSystem* task_system = NULL;
+
+	SV_INTERNAL bool task_pop(Task& task)
+	{
+		SV_LOCK_GUARD(task_system->mutex, lock);
+
+		if (task_system->queue_count == 0u) return false;
+
+		task = task_system->queue[task_system->queue_begin];
+		task_system->queue_begin = (task_system->queue_begin + 1u) % TASK_QUEUE_SIZE;
+		--task_system->queue_count;
+		return true;
+	}
+
+	SV_INTERNAL void task_execute(Task& task)
+	{
+		task.fn(task.data);
+		if (task.context) task.context->completed.fetch_add(1u);
+	}
+
+	SV_INTERNAL DWORD WINAPI task_thread(LPVOID)
+	{
+		while (true) {
+
+			WaitForSingleObject(task_system->semaphore, INFINITE);
+
+			if (!task_system->running.load()) break;
+
+			// The task can be executed by a waiting thread
+			Task task;
+			if (task_pop(task)) task_execute(task);
+		}
+		
+		return 0u;
+	}
+
+	bool _task_initialize()
+	{
+		task_system = SV_ALLOCATE_STRUCT(TaskSystem, "TaskSystem");
+
+		SV_CHECK(mutex_create(task_system->mutex));
+
+		task_system->semaphore = CreateSemaphoreA(NULL, 0, LONG(TASK_QUEUE_SIZE + TASK_THREAD_MAX), NULL);
+		if (task_system->semaphore == NULL) return false;
+
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+
+		// The main thread is also executing tasks while waiting
+		u32 thread_count = (info.dwNumberOfProcessors > 1u) ? u32(info.dwNumberOfProcessors - 1u) : 1u;
+		thread_count = SV_MIN(thread_count, TASK_THREAD_MAX);
+
+		task_system->running = true;
+
+		foreach(i, thread_count) {
+
+			HANDLE thread = CreateThread(NULL, 0u, task_thread, NULL, 0u, NULL);
+			if (thread == NULL) break;
+
+			task_system->threads[task_system->thread_count++] = thread;
+		}
+
+		SV_LOG_INFO("Task system initialized with %u threads", task_system->thread_count);
+		return task_system->thread_count != 0u;
+	}
+
+	void _task_close()
+	{
+		if (task_system) {
+
+			// Execute the remaining tasks
+			Task task;
+			while (task_pop(task)) task_execute(task);
+
+			task_system->running = false;
+			ReleaseSemaphore(task_system->semaphore, LONG(task_system->thread_count), NULL);
+
+			if (task_system->thread_count)
+				WaitForMultipleObjects(task_system->thread_count, task_system->threads, TRUE, INFINITE);
+
+			foreach(i, task_system->thread_count) {
+				CloseHandle(task_system->threads[i]);
+			}
+
+			CloseHandle(task_system->semaphore);
+			mutex_destroy(task_system->mutex);
+
+			SV_FREE_STRUCT(task_system);
+			task_system = NULL;
+		}
+	}
+
+	void task_dispatch(TaskFn fn, const void* data, u32 size, TaskContext* context)
+	{
+		SV_ASSERT(size <= TASK_DATA_SIZE);
+
+		Task task;
+		task.fn = fn;
+		task.context = context;
+		if (size) memcpy(task.data, data, size);
+
+		if (context) context->submitted.fetch_add(1u);
+
+		bool queued = false;
+
+		if (task_system && task_system->running.load()) {
+
+			SV_LOCK_GUARD(task_system->mutex, lock);
+
+			if (task_system->queue_count < TASK_QUEUE_SIZE) {
+
+				u32 index = (task_system->queue_begin + task_system->queue_count) % TASK_QUEUE_SIZE;
+				task_system->queue[index] = task;
+				++task_system->queue_count;
+				queued = true;
+			}
+		}
+
+		if (queued) ReleaseSemaphore(task_system->semaphore, 1, NULL);
+		else task_execute(task);
+	}
+
+	void task_wait(TaskContext& context)
+	{
+		while (task_running(context)) {
+
+			Task task;
+			if (task_pop(task)) task_execute(task);
+			else SwitchToThread();
+		}
+	}
+
+	bool task_running(const TaskContext& context)
+	{
+		return context.completed.load() < context.submitted.load();
+	}
+
+	u32 task_thread_count()
+	{
+		return task_system ? task_system->thread_count : 0u;
+	}
+
+	// FILE WATCHER
+
+	constexpr u32 FILE_WATCHER_BUFFER_SIZE = 64u * 1024u;
+
+	struct FileWatchEntry {
+		char filepath[FILEPATH_SIZE + 1u];
+	};
+
+	struct FileWatcher {
+		HANDLE               folder;
+		HANDLE               thread;
+		HANDLE               stop_event;
+		Mutex                mutex;
+		List<FileWatchEntry> queue;
+		DWORD                buffer[FILE_WATCHER_BUFFER_SIZE / sizeof(DWORD)];
+	};
+
+	SV_INTERNAL void file_watcher_push(FileWatcher* watcher, const FILE_NOTIFY_INFORMATION* info)
+	{
+		FileWatchEntry entry;
+		
+		i32 size = WideCharToMultiByte(CP_UTF8, 0, info->FileName, i32(info->FileNameLength / sizeof(WCHAR)), entry.filepath, FILEPATH_SIZE, NULL, NULL);
+		if (size <= 0) return;
+		
+		entry.filepath[size] = '\0';
+
+		foreach(i, size) {
+			if (entry.filepath[i] == '\\') entry.filepath[i] = '/';
+		}
+
+		SV_LOCK_GUARD(watcher->mutex, lock);
+
+		for (const FileWatchEntry& e : watcher->queue) {
+			if (string_equals(e.filepath, entry.filepath)) return;
+		}
+
+		watcher->queue.push_back(entry);
+	}
+
+	SV_INTERNAL DWORD WINAPI file_watcher_thread(LPVOID data)
+	{
+		FileWatcher* watcher = reinterpret_cast<FileWatcher*>(data);
+
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		if (overlapped.hEvent == NULL) return 0u;
+
+		HANDLE events[] = { overlapped.hEvent, watcher->stop_event };
+		constexpr DWORD FILTER = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+		while (true) {
+
+			ResetEvent(overlapped.hEvent);
+
+			if (!ReadDirectoryChangesW(watcher->folder, watcher->buffer, FILE_WATCHER_BUFFER_SIZE, TRUE, FILTER, NULL, &overlapped, NULL)) {
+				SV_LOG_ERROR("Can't read the directory changes, the file watcher is stopped");
+				break;
+			}
+
+			DWORD res = WaitForMultipleObjects(2u, events, FALSE, INFINITE);
+
+			if (res != WAIT_OBJECT_0) {
+				CancelIo(watcher->folder);
+				WaitForSingleObject(overlapped.hEvent, INFINITE);
+				break;
+			}
+
+			DWORD bytes;
+			if (!GetOverlappedResult(watcher->folder, &overlapped, &bytes, FALSE)) break;
+
+			if (bytes == 0u) {
+				SV_LOG_WARNING("The file watcher buffer overflowed, some changes are lost");
+				continue;
+			}
+
+			const u8* it = reinterpret_cast<const u8*>(watcher->buffer);
+
+			while (true) {
+
+				const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(it);
+
+				if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+					file_watcher_push(watcher, info);
+
+				if (info->NextEntryOffset == 0u) break;
+				it += info->NextEntryOffset;
+			}
+		}
+
+		CloseHandle(overlapped.hEvent);
+		return 0u;
+	}
+
+	FileWatcher* file_watcher_create(const char* folder_)
+	{
+		char folder[MAX_PATH];
+		filepath_resolve(folder, folder_);
+
+		if (folder[0] == '\0') strcpy(folder, ".");
+
+		HANDLE handle = CreateFileA(folder, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+
+		if (handle == INVALID_HANDLE_VALUE) {
+			SV_LOG_ERROR("Can't open the folder '%s' to watch it", folder);
+			return NULL;
+		}
+
+		FileWatcher* watcher = SV_ALLOCATE_STRUCT(FileWatcher, "FileWatcher");
+		watcher->folder = handle;
+		watcher->stop_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+		if (watcher->stop_event == NULL || !mutex_create(watcher->mutex)) {
+			file_watcher_destroy(watcher);
+			return NULL;
+		}
+
+		watcher->thread = CreateThread(NULL, 0u, file_watcher_thread, watcher, 0u, NULL);
+
+		if (watcher->thread == NULL) {
+			file_watcher_destroy(watcher);
+			return NULL;
+		}
+
+		return watcher;
+	}
+
+	void file_watcher_destroy(FileWatcher* watcher)
+	{
+		if (watcher == NULL) return;
+
+		if (watcher->thread) {
+
+			SetEvent(watcher->stop_event);
+			WaitForSingleObject(watcher->thread, INFINITE);
+			CloseHandle(watcher->thread);
+		}
+
+		if (watcher->stop_event) CloseHandle(watcher->stop_event);
+		if (mutex_valid(watcher->mutex)) mutex_destroy(watcher->mutex);
+		CloseHandle(watcher->folder);
+
+		SV_FREE_STRUCT(watcher);
+	}
+
+	bool file_watcher_pop(FileWatcher* watcher, char* filepath)
+	{
+		SV_LOCK_GUARD(watcher->mutex, lock);
+
+		if (watcher->queue.empty()) return false;
+
+		string_copy(filepath, watcher->queue.back().filepath, FILEPATH_SIZE + 1u);
+		watcher->queue.pop_back();
+		return true;
+	}
+
 	// DYNAMIC LIBRARIES
 
 	Library library_load(const char* filepath_)
@@ -12,4 +12,5 @@
 #include "platform/graphics_shader.cpp"
 #include "platform/vulkan/graphics_vulkan.cpp"
 #include "platform/vulkan/graphics_vulkan_pipeline.cpp"
+#include "platform/null/graphics_null.cpp"
 
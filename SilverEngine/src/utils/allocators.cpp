@@ -1,6 +1,7 @@
 #include "utils/allocators.h"
 
 #include "debug/console.h"
+#include "platform/os.h"
 
 namespace sv {
 
@@ -386,4 +387,89 @@ namespace sv {
 
 		return nextCount;
     }
+
+    /////////////////////////////////////// HASH MAP BENCHMARK ///////////////////////////////////////////
+
+    constexpr u32 BENCHMARK_KEY_SIZE = 32u;
+
+    SV_AUX f32 benchmark_ns(f64 begin, u32 count)
+    {
+		return f32((timer_now() - begin) * 1000000000.0 / f64(count));
+    }
+
+    template<typename Map>
+    SV_INTERNAL void benchmark_u64(const char* name, Map& map, const u64* keys, u32 count)
+    {
+		f64 t = timer_now();
+		foreach(i, count) map[keys[i]] = keys[i];
+		f32 insert = benchmark_ns(t, count);
+
+		u64 sum = 0u;
+		t = timer_now();
+		foreach(i, count) sum += *map.find(keys[i]);
+		f32 hit = benchmark_ns(t, count);
+
+		u32 found = 0u;
+		t = timer_now();
+		foreach(i, count) found += map.find(keys[i] ^ 0x5555555555555555ull) ? 1u : 0u;
+		f32 miss = benchmark_ns(t, count);
+
+		SV_LOG_INFO("%s: insert %.1f ns, hit %.1f ns, miss %.1f ns (%u, %u)", name, insert, hit, miss, u32(sum & 0xFF), found);
+    }
+
+    template<typename Map>
+    SV_INTERNAL void benchmark_string(const char* name, Map& map, const char* keys, u32 count)
+    {
+		f64 t = timer_now();
+		foreach(i, count) map[keys + i * BENCHMARK_KEY_SIZE] = i;
+		f32 insert = benchmark_ns(t, count);
+
+		u32 sum = 0u;
+		t = timer_now();
+		foreach(i, count) sum += *map.find(keys + i * BENCHMARK_KEY_SIZE);
+		f32 hit = benchmark_ns(t, count);
+
+		SV_LOG_INFO("%s: insert %.1f ns, hit %.1f ns (%u)", name, insert, hit, sum & 0xFF);
+    }
+
+    void hash_map_benchmark(u32 count)
+    {
+		SV_LOG_INFO("Hash map benchmark, %u entries", count);
+
+		u64* keys = (u64*)SV_ALLOCATE_MEMORY(sizeof(u64) * count, "Benchmark");
+		char* strings = (char*)SV_ALLOCATE_MEMORY(size_t(BENCHMARK_KEY_SIZE) * count, "Benchmark");
+
+		// Splitmix64
+		u64 seed = 0x9E3779B97F4A7C15ull;
+		foreach(i, count) {
+			u64 z = (seed += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+			keys[i] = (z ^ (z >> 31u)) | 1u;
+
+			sprintf(strings + i * BENCHMARK_KEY_SIZE, "assets/textures/tex_%u.png", i);
+		}
+
+		{
+			HashMap<u64, u64> map;
+			benchmark_u64("HashMap u64", map, keys, count);
+		}
+		{
+			ThickHashTable<u64, 2000u>* map = SV_ALLOCATE_STRUCT(ThickHashTable<u64, 2000u>, "Benchmark");
+			benchmark_u64("ThickHashTable u64", *map, keys, count);
+			SV_FREE_STRUCT(map);
+		}
+		{
+			HashMap<const char*, u32> map;
+			benchmark_string("HashMap string", map, strings, count);
+		}
+		{
+			ThickHashTable<u32, 2000u>* map = SV_ALLOCATE_STRUCT(ThickHashTable<u32, 2000u>, "Benchmark");
+			benchmark_string("ThickHashTable string", *map, strings, count);
+			SV_FREE_STRUCT(map);
+		}
+
+		SV_FREE_MEMORY(keys);
+		SV_FREE_MEMORY(strings);
+    }
 }
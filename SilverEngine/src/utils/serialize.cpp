@@ -146,29 +146,183 @@ namespace sv {
 
     //////////////////////////////////// SERIALIZER /////////////////
 
+    struct SerializerStream {
+		FileWriter        file;
+		RawList           back; // Chunk written by the I/O task
+		TaskContext       context;
+		bool              async = false;
+		std::atomic<bool> failed = false;
+    };
+
+    SV_AUX void swap_raw_list(RawList& l0, RawList& l1)
+    {
+		std::swap(l0._data, l1._data);
+		std::swap(l0._size, l1._size);
+		std::swap(l0._capacity, l1._capacity);
+    }
+
+    SV_INTERNAL void stream_write_task(void* data)
+    {
+		SerializerStream* stream = *reinterpret_cast<SerializerStream**>(data);
+
+		if (!file_writer_write(stream->file, stream->back.data(), stream->back.size()))
+			stream->failed = true;
+    }
+
+    SV_AUX void stream_write(SerializerStream& stream, const void* data, size_t size)
+    {
+		if (!file_writer_write(stream.file, data, size))
+			stream.failed = true;
+    }
+
+    SV_AUX void stream_flush(Serializer& s)
+    {
+		SerializerStream& stream = *reinterpret_cast<SerializerStream*>(s._stream);
+
+		size_t size = s.buff.size();
+		if (size == 0u) return;
+
+		if (stream.async) {
+
+			// Only one chunk in flight, the memory is bounded to two chunks
+			task_wait(stream.context);
+
+			swap_raw_list(s.buff, stream.back);
+
+			SerializerStream* ptr = &stream;
+			task_dispatch(stream_write_task, &ptr, sizeof(SerializerStream*), &stream.context);
+		}
+		else stream_write(stream, s.buff.data(), size);
+
+		s._flushed += size;
+		s.buff.reset();
+    }
+
     void serialize_begin(Serializer& s)
     {
 		s.buff.reset();
+		s._flushed = 0u;
 	
 		// TODO: move to .cpp
 		serialize_version(s, engine.version);
 		serialize_u32(s, Serializer::VERSION);
     }
 
+    bool serialize_begin_stream(Serializer& s, const char* filepath, bool async, size_t chunk_size)
+    {
+		if (s._stream) serialize_end(s, NULL);
+		
+		SerializerStream* stream = SV_ALLOCATE_STRUCT(SerializerStream, "Serializer");
+
+		if (!file_writer_open(stream->file, filepath)) {
+			SV_LOG_ERROR("Can't open the file '%s' to serialize", filepath);
+			SV_FREE_STRUCT(stream);
+			return false;
+		}
+
+		stream->async = async;
+		chunk_size = SV_MAX(chunk_size, size_t(1024u));
+
+		s.buff.clear();
+		s.buff.reserve(chunk_size);
+		
+		if (async) stream->back.reserve(chunk_size);
+		
+		s._stream = stream;
+		s._flushed = 0u;
+		
+		serialize_version(s, engine.version);
+		serialize_u32(s, Serializer::VERSION);
+		return true;
+    }
+
+    void _serialize_stream_write(Serializer& s, const void* data, size_t size)
+    {
+		SerializerStream& stream = *reinterpret_cast<SerializerStream*>(s._stream);
+
+		stream_flush(s);
+
+		if (size <= s.buff.capacity()) {
+			s.buff.write_back(data, size);
+		}
+		else {
+
+			// Bigger than a chunk, written directly after the pending one
+			if (stream.async) task_wait(stream.context);
+			
+			stream_write(stream, data, size);
+			s._flushed += size;
+		}
+    }
+
+    void serialize_patch(Serializer& s, size_t pos, const void* data, size_t size)
+    {
+		SV_ASSERT(pos + size <= serialize_size(s));
+
+		const u8* src = (const u8*)data;
+
+		// Flushed bytes
+		if (pos < s._flushed) {
+
+			SerializerStream& stream = *reinterpret_cast<SerializerStream*>(s._stream);
+			if (stream.async) task_wait(stream.context);
+
+			size_t write = SV_MIN(size, s._flushed - pos);
+			
+			if (!file_writer_write_at(stream.file, pos, src, write))
+				stream.failed = true;
+
+			pos += write;
+			src += write;
+			size -= write;
+		}
+
+		if (size) {
+			memcpy(s.buff.data() + (pos - s._flushed), src, size);
+		}
+    }
+
     bool serialize_end(Serializer& s, const char* filepath)
     {
+		if (s._stream) {
+
+			SerializerStream* stream = reinterpret_cast<SerializerStream*>(s._stream);
+
+			stream_flush(s);
+			if (stream->async) task_wait(stream->context);
+
+			bool res = !stream->failed;
+			
+			file_writer_close(stream->file);
+			SV_FREE_STRUCT(stream);
+			
+			s._stream = NULL;
+			s._flushed = 0u;
+			s.buff.clear();
+
+			return res;
+		}
+		
+		if (s.compress) {
+
+			RawList data;
+			compress_data(s.buff.data(), s.buff.size(), data);
+			return file_write_binary(filepath, data.data(), data.size(), false);
+		}
+		
 		return file_write_binary(filepath, s.buff.data(), s.buff.size(), false);
     }
 
     //////////////////////////////////// DESERIALIZER /////////////////
 
-    bool deserialize_begin(Deserializer& d, const char* filepath)
+    SV_AUX bool deserialize_header(Deserializer& d)
     {
-		SV_CHECK(file_read_binary(filepath, d.buff));
-	
 		d.pos = 0u;
 
-		SV_CHECK(deserialize_assert(d, sizeof(Version) + sizeof(u32)));
+		if (!deserialize_assert(d, sizeof(Version) + sizeof(u32))) {
+			deserialize_end(d);
+			return false;
+		}
 
 		deserialize_version(d, d.engine_version);
 		deserialize_u32(d, d.serializer_version);
@@ -180,10 +334,760 @@ namespace sv {
 
 		return true;
     }
+
+    SV_AUX bool deserialize_decompress(Deserializer& d, const u8* data, size_t size, const char* filepath)
+    {
+		RawList raw;
+
+		if (!decompress_data(data, size, raw)) {
+			SV_LOG_ERROR("The compressed file '%s' is corrupted", filepath);
+			return false;
+		}
+
+		swap_raw_list(d.buff, raw);
+		return true;
+    }
+
+    bool deserialize_begin(Deserializer& d, const char* filepath)
+    {
+		if (d._mapping || d._view) deserialize_end(d);
+		
+		SV_CHECK(file_read_binary(filepath, d.buff));
+
+		if (data_is_compressed(d.buff.data(), d.buff.size())) {
+
+			if (!deserialize_decompress(d, d.buff.data(), d.buff.size(), filepath)) {
+				deserialize_end(d);
+				return false;
+			}
+		}
+		
+		return deserialize_header(d);
+    }
+
+    bool deserialize_begin_mapped(Deserializer& d, const char* filepath, bool prefetch)
+    {
+		deserialize_end(d);
+
+		FileMapping* mapping = SV_ALLOCATE_STRUCT(FileMapping, "Deserializer");
+
+		if (!file_map(filepath, *mapping)) {
+			SV_FREE_STRUCT(mapping);
+			return false;
+		}
+
+		// The compressed files are decompressed to an owned buffer, the mapping is not needed anymore
+		if (data_is_compressed(mapping->data, mapping->size)) {
+
+			bool res = deserialize_decompress(d, mapping->data, mapping->size, filepath);
+			
+			file_unmap(*mapping);
+			SV_FREE_STRUCT(mapping);
+
+			if (!res) {
+				deserialize_end(d);
+				return false;
+			}
+			
+			return deserialize_header(d);
+		}
+
+		if (prefetch) file_prefetch(*mapping);
+
+		// The RawList doesn't own the memory, deserialize_end detaches it before clearing
+		d.buff._data = const_cast<u8*>(mapping->data);
+		d.buff._size = mapping->size;
+		d.buff._capacity = mapping->size;
+		d._mapping = mapping;
+
+		return deserialize_header(d);
+    }
+    
+    void deserialize_begin_view(Deserializer& d, const void* data, size_t size)
+    {
+		deserialize_end(d);
+
+		d.buff._data = (u8*)data;
+		d.buff._size = size;
+		d.buff._capacity = size;
+		d.pos = 0u;
+		d._view = true;
+    }
     
     void deserialize_end(Deserializer& d)
     {
+		// The memory is not owned
+		bool external = d._mapping || d._view;
+		
+		if (d._mapping) {
+
+			FileMapping* mapping = reinterpret_cast<FileMapping*>(d._mapping);
+			file_unmap(*mapping);
+			SV_FREE_STRUCT(mapping);
+			d._mapping = NULL;
+		}
+
+		if (external) {
+			
+			d.buff._data = nullptr;
+			d.buff._size = 0u;
+			d.buff._capacity = 0u;
+			d._view = false;
+		}
+		
 		d.buff.clear();
     }
-    
+
+	SV_AUX void log_throughput(const char* name, size_t bytes, f64 time)
+	{
+		f64 mb = f64(bytes) / (1024.0 * 1024.0);
+		SV_LOG_INFO("%s: %.2f ms, %.1f MB/s", name, f32(time * 1000.0), f32(mb / SV_MAX(time, 0.000001)));
+	}
+
+	void serialize_benchmark(u32 count)
+	{
+		SV_LOG_INFO("Serialize benchmark, %u v3_f32 (%.2f MB)", count, f32(f64(sizeof(v3_f32) * count) / (1024.0 * 1024.0)));
+
+		List<v3_f32> src;
+		src.resize(count);
+
+		foreach(i, count) {
+			src[i] = v3_f32(f32(i), f32(i) * 0.5f, -f32(i));
+		}
+
+		size_t bytes = sizeof(v3_f32) * size_t(count);
+		f64 begin;
+
+		// Per element, as the arrays were serialized before
+		{
+			Serializer s;
+			s.buff.reserve(bytes + sizeof(u32));
+			
+			begin = timer_now();
+			
+			serialize_u32(s, count);
+			foreach(i, count) {
+				serialize_f32(s, src[i].x);
+				serialize_f32(s, src[i].y);
+				serialize_f32(s, src[i].z);
+			}
+			
+			log_throughput("Write per element", bytes, timer_now() - begin);
+
+			Deserializer d;
+			d.buff.write_back(s.buff.data(), s.buff.size());
+			d.pos = 0u;
+
+			List<v3_f32> dst;
+
+			begin = timer_now();
+
+			u32 c;
+			deserialize_u32(d, c);
+			dst.resize(c);
+			
+			foreach(i, c) {
+				deserialize_f32(d, dst[i].x);
+				deserialize_f32(d, dst[i].y);
+				deserialize_f32(d, dst[i].z);
+			}
+
+			log_throughput("Read per element", bytes, timer_now() - begin);
+		}
+
+		// Bulk
+		{
+			Serializer s;
+			s.buff.reserve(bytes + sizeof(u32));
+			
+			begin = timer_now();
+			serialize_v3_f32_array(s, src);
+			log_throughput("Write bulk", bytes, timer_now() - begin);
+
+			Deserializer d;
+			d.buff.write_back(s.buff.data(), s.buff.size());
+			d.pos = 0u;
+
+			List<v3_f32> dst;
+
+			begin = timer_now();
+			bool res = deserialize_v3_f32_array(d, dst);
+			log_throughput("Read bulk", bytes, timer_now() - begin);
+
+			if (!res || dst.size() != src.size() || (count && memcmp(dst.data(), src.data(), bytes) != 0)) {
+				SV_LOG_ERROR("The bulk array doesn't match the source");
+			}
+
+			// Truncated file
+			d.pos = 0u;
+			d.buff.resize(d.buff.size() / 2u);
+
+			if (count && deserialize_v3_f32_array(d, dst)) {
+				SV_LOG_ERROR("The truncated array is not detected");
+			}
+		}
+	}
+
+	//////////////////////////////////// COMPRESSION /////////////////
+
+	constexpr u32 COMPRESSION_MAGIC = 0x5A435653; // SVCZ
+	constexpr u32 COMPRESSION_VERSION = 0u;
+	constexpr u32 COMPRESSION_CHUNK_RAW = SV_BIT(31); // The chunk is stored without compression
+
+	struct CompressionHeader {
+		u32 magic;
+		u32 version;
+		u32 chunk_size;
+		u32 chunk_count;
+		u64 size;
+	};
+
+	// LZ4 block format constants
+	constexpr u32 LZ4_MIN_MATCH = 4u;
+	constexpr u32 LZ4_MF_LIMIT = 12u; // The last match starts before the last 12 bytes
+	constexpr u32 LZ4_LAST_LITERALS = 5u; // The last 5 bytes are always literals
+	constexpr u32 LZ4_MAX_OFFSET = 65535u;
+	constexpr u32 LZ4_HASH_BITS = 12u;
+
+	SV_AUX u32 lz4_read32(const u8* p)
+	{
+		u32 n;
+		memcpy(&n, p, sizeof(u32));
+		return n;
+	}
+
+	SV_AUX u32 lz4_hash(u32 seq)
+	{
+		return (seq * 2654435761u) >> (32u - LZ4_HASH_BITS);
+	}
+
+	SV_AUX u8* lz4_write_length(u8* op, size_t length)
+	{
+		while (length >= 255u) {
+			*op++ = 255u;
+			length -= 255u;
+		}
+		*op++ = u8(length);
+		return op;
+	}
+
+	SV_AUX bool lz4_read_length(const u8*& ip, const u8* end, size_t& length)
+	{
+		u8 b;
+		
+		do {
+			if (ip >= end) return false;
+			b = *ip++;
+			length += b;
+		}
+		while (b == 255u);
+
+		return true;
+	}
+
+	// Writes a sequence of literals followed by a match, without match for the last literals
+	SV_AUX bool lz4_write_sequence(u8*& op, u8* end, const u8* literals, size_t literal_count, size_t offset, size_t match_length)
+	{
+		size_t max_size = 1u + literal_count + literal_count / 255u + 1u + 2u + match_length / 255u + 1u;
+		if (max_size > size_t(end - op)) return false;
+		
+		u8* token = op++;
+		*token = u8(SV_MIN(literal_count, size_t(15u)) << 4u);
+
+		if (literal_count >= 15u)
+			op = lz4_write_length(op, literal_count - 15u);
+
+		memcpy(op, literals, literal_count);
+		op += literal_count;
+
+		if (match_length) {
+
+			*op++ = u8(offset);
+			*op++ = u8(offset >> 8u);
+
+			size_t length = match_length - LZ4_MIN_MATCH;
+			*token |= u8(SV_MIN(length, size_t(15u)));
+
+			if (length >= 15u)
+				op = lz4_write_length(op, length - 15u);
+		}
+
+		return true;
+	}
+
+	size_t compress_bound(size_t size)
+	{
+		return size + size / 255u + 16u;
+	}
+
+	size_t compress_block(const void* src_, size_t size, void* dst_, size_t capacity)
+	{
+		const u8* src = (const u8*)src_;
+		const u8* end = src + size;
+		const u8* ip = src;
+		const u8* anchor = src;
+		
+		u8* op = (u8*)dst_;
+		u8* op_end = op + capacity;
+
+		if (size > LZ4_MF_LIMIT) {
+			
+			u32 table[1u << LZ4_HASH_BITS] = {};
+			
+			const u8* match_limit = end - LZ4_MF_LIMIT;
+			const u8* extend_limit = end - LZ4_LAST_LITERALS;
+			u32 misses = 0u;
+
+			while (ip < match_limit) {
+
+				u32 seq = lz4_read32(ip);
+				u32 h = lz4_hash(seq);
+				const u8* ref = src + table[h];
+				table[h] = u32(ip - src);
+
+				if (ref >= ip || size_t(ip - ref) > LZ4_MAX_OFFSET || lz4_read32(ref) != seq) {
+
+					// Skips faster in incompressible data
+					ip += 1u + (misses++ >> 6u);
+					continue;
+				}
+
+				misses = 0u;
+
+				while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+					--ip;
+					--ref;
+				}
+
+				const u8* match_end = ip + LZ4_MIN_MATCH;
+				const u8* r = ref + LZ4_MIN_MATCH;
+
+				while (match_end < extend_limit && *match_end == *r) {
+					++match_end;
+					++r;
+				}
+
+				if (!lz4_write_sequence(op, op_end, anchor, ip - anchor, ip - ref, match_end - ip))
+					return 0u;
+
+				ip = match_end;
+				anchor = ip;
+
+				if (ip - 2 < match_limit)
+					table[lz4_hash(lz4_read32(ip - 2))] = u32(ip - 2 - src);
+			}
+		}
+
+		if (!lz4_write_sequence(op, op_end, anchor, end - anchor, 0u, 0u))
+			return 0u;
+
+		return size_t(op - (u8*)dst_);
+	}
+
+	bool decompress_block(const void* src, size_t size, void* dst, size_t dst_size)
+	{
+		const u8* ip = (const u8*)src;
+		const u8* end = ip + size;
+		u8* op = (u8*)dst;
+		u8* op_end = op + dst_size;
+
+		while (ip < end) {
+
+			u8 token = *ip++;
+
+			size_t literal_count = token >> 4u;
+			if (literal_count == 15u && !lz4_read_length(ip, end, literal_count))
+				return false;
+
+			if (literal_count > size_t(end - ip) || literal_count > size_t(op_end - op))
+				return false;
+
+			memcpy(op, ip, literal_count);
+			ip += literal_count;
+			op += literal_count;
+
+			// Last literals
+			if (ip == end) break;
+
+			if (end - ip < 2) return false;
+
+			size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8u);
+			ip += 2u;
+
+			if (offset == 0u || offset > size_t(op - (u8*)dst))
+				return false;
+
+			size_t match_length = token & 15u;
+			if (match_length == 15u && !lz4_read_length(ip, end, match_length))
+				return false;
+
+			match_length += LZ4_MIN_MATCH;
+
+			if (match_length > size_t(op_end - op))
+				return false;
+
+			const u8* match = op - offset;
+
+			if (offset >= match_length) {
+				memcpy(op, match, match_length);
+				op += match_length;
+			}
+			else {
+				// Overlapped, repeats the last bytes
+				foreach(i, match_length)
+					*op++ = *match++;
+			}
+		}
+
+		return op == op_end;
+	}
+
+	bool data_is_compressed(const void* data, size_t size)
+	{
+		if (size < sizeof(CompressionHeader)) return false;
+
+		u32 magic;
+		memcpy(&magic, data, sizeof(u32));
+		return magic == COMPRESSION_MAGIC;
+	}
+
+	struct CompressionTaskData {
+		const u8* src;
+		u8*       dst;
+		u32       src_size;
+		u32       dst_size;
+		u32*      result; // Compressed size, 0 if the chunk is stored raw or the decompression failed
+	};
+
+	SV_INTERNAL void compress_task(void* data)
+	{
+		CompressionTaskData& d = *reinterpret_cast<CompressionTaskData*>(data);
+		*d.result = u32(compress_block(d.src, d.src_size, d.dst, d.dst_size));
+	}
+
+	SV_INTERNAL void decompress_task(void* data)
+	{
+		CompressionTaskData& d = *reinterpret_cast<CompressionTaskData*>(data);
+		*d.result = decompress_block(d.src, d.src_size, d.dst, d.dst_size) ? 1u : 0u;
+	}
+
+	void compress_data(const void* data_, size_t size, RawList& dst, size_t chunk_size)
+	{
+		const u8* data = (const u8*)data_;
+		
+		chunk_size = SV_MAX(chunk_size, size_t(1024u));
+		chunk_size = SV_MIN(chunk_size, size_t(COMPRESSION_CHUNK_RAW - 1u));
+
+		u32 chunk_count = u32((size + chunk_size - 1u) / chunk_size);
+		size_t bound = compress_bound(chunk_size);
+
+		RawList temp;
+		temp.resize(bound * chunk_count);
+
+		List<u32> sizes;
+		sizes.resize(chunk_count);
+
+		TaskContext context;
+
+		foreach(i, chunk_count) {
+
+			CompressionTaskData d;
+			d.src = data + size_t(i) * chunk_size;
+			d.dst = temp.data() + size_t(i) * bound;
+			d.src_size = u32(SV_MIN(chunk_size, size - size_t(i) * chunk_size));
+			d.dst_size = u32(bound);
+			d.result = sizes.data() + i;
+
+			if (chunk_count == 1u) compress_task(&d);
+			else task_dispatch(compress_task, &d, sizeof(d), &context);
+		}
+
+		task_wait(context);
+
+		CompressionHeader header;
+		header.magic = COMPRESSION_MAGIC;
+		header.version = COMPRESSION_VERSION;
+		header.chunk_size = u32(chunk_size);
+		header.chunk_count = chunk_count;
+		header.size = u64(size);
+
+		dst.reset();
+		dst.write_back(&header, sizeof(CompressionHeader));
+
+		// The chunks that don't get smaller are stored raw
+		foreach(i, chunk_count) {
+
+			u32 raw_size = u32(SV_MIN(chunk_size, size - size_t(i) * chunk_size));
+			u32 entry = (sizes[i] == 0u || sizes[i] >= raw_size) ? (raw_size | COMPRESSION_CHUNK_RAW) : sizes[i];
+			dst.write_back(&entry, sizeof(u32));
+		}
+
+		foreach(i, chunk_count) {
+
+			u32 raw_size = u32(SV_MIN(chunk_size, size - size_t(i) * chunk_size));
+			
+			if (sizes[i] == 0u || sizes[i] >= raw_size)
+				dst.write_back(data + size_t(i) * chunk_size, raw_size);
+			else
+				dst.write_back(temp.data() + size_t(i) * bound, sizes[i]);
+		}
+	}
+
+	SV_AUX bool decompress_chunks(const void* data_, size_t size, RawList& dst, bool parallel)
+	{
+		const u8* data = (const u8*)data_;
+		
+		if (!data_is_compressed(data, size)) return false;
+
+		CompressionHeader header;
+		memcpy(&header, data, sizeof(CompressionHeader));
+
+		if (header.version != COMPRESSION_VERSION || header.chunk_size == 0u || header.chunk_size >= COMPRESSION_CHUNK_RAW)
+			return false;
+
+		// The LZ4 blocks can't expand the data more than 255 times
+		if (header.size / 255u > u64(size))
+			return false;
+
+		if (u64(header.chunk_count) != (header.size + header.chunk_size - 1u) / header.chunk_size)
+			return false;
+
+		size_t table_size = sizeof(u32) * size_t(header.chunk_count);
+		if (size - sizeof(CompressionHeader) < table_size) return false;
+
+		const u8* table = data + sizeof(CompressionHeader);
+		const u8* src = table + table_size;
+		const u8* end = data + size;
+
+		dst.reset();
+		dst.resize(size_t(header.size));
+
+		List<u32> results;
+		results.resize(header.chunk_count);
+
+		TaskContext context;
+		bool res = true;
+
+		foreach(i, header.chunk_count) {
+
+			u32 entry;
+			memcpy(&entry, table + i * sizeof(u32), sizeof(u32));
+
+			bool raw = entry & COMPRESSION_CHUNK_RAW;
+			u32 src_size = entry & ~COMPRESSION_CHUNK_RAW;
+			u32 dst_size = u32(SV_MIN(u64(header.chunk_size), header.size - u64(i) * header.chunk_size));
+			u8* chunk_dst = dst.data() + size_t(i) * header.chunk_size;
+
+			if (size_t(end - src) < src_size) {
+				res = false;
+				break;
+			}
+
+			if (raw) {
+				
+				if (src_size != dst_size) {
+					res = false;
+					break;
+				}
+				
+				memcpy(chunk_dst, src, src_size);
+				results[i] = 1u;
+			}
+			else {
+
+				CompressionTaskData d;
+				d.src = src;
+				d.dst = chunk_dst;
+				d.src_size = src_size;
+				d.dst_size = dst_size;
+				d.result = results.data() + i;
+
+				if (parallel && header.chunk_count > 1u) task_dispatch(decompress_task, &d, sizeof(d), &context);
+				else decompress_task(&d);
+			}
+
+			src += src_size;
+		}
+
+		task_wait(context);
+
+		if (res) {
+			foreach(i, header.chunk_count) {
+				if (results[i] == 0u) res = false;
+			}
+		}
+
+		if (!res) dst.clear();
+		return res;
+	}
+
+	bool decompress_data(const void* data, size_t size, RawList& dst)
+	{
+		return decompress_chunks(data, size, dst, true);
+	}
+
+	bool file_is_compressed(const char* filepath)
+	{
+		FileMapping mapping;
+		if (!file_map(filepath, mapping)) return false;
+
+		bool res = data_is_compressed(mapping.data, mapping.size);
+		file_unmap(mapping);
+		return res;
+	}
+
+	struct CompressionBenchmarkResult {
+		u32 file_count = 0u;
+		u64 raw_size = 0u;
+		u64 compressed_size = 0u;
+		f64 compress_time = 0.0;
+		f64 parallel_time = 0.0;
+		f64 serial_time = 0.0;
+	};
+
+	SV_AUX bool compression_benchmark_file(const char* filepath, CompressionBenchmarkResult& result)
+	{
+		RawList file;
+
+		if (!file_read_binary(filepath, file)) {
+			SV_LOG_ERROR("Can't read the file '%s'", filepath);
+			return false;
+		}
+
+		RawList raw;
+
+		if (data_is_compressed(file.data(), file.size())) {
+
+			if (!decompress_data(file.data(), file.size(), raw)) {
+				SV_LOG_ERROR("The compressed file '%s' is corrupted", filepath);
+				return false;
+			}
+		}
+		else swap_raw_list(raw, file);
+
+		RawList compressed;
+		
+		f64 begin = timer_now();
+		compress_data(raw.data(), raw.size(), compressed);
+		f64 compress_time = timer_now() - begin;
+
+		RawList data;
+
+		begin = timer_now();
+		decompress_chunks(compressed.data(), compressed.size(), data, false);
+		f64 serial_time = timer_now() - begin;
+
+		begin = timer_now();
+		bool res = decompress_chunks(compressed.data(), compressed.size(), data, true);
+		f64 parallel_time = timer_now() - begin;
+
+		if (!res || data.size() != raw.size() || memcmp(data.data(), raw.data(), raw.size()) != 0) {
+			SV_LOG_ERROR("The decompressed data of '%s' doesn't match the source", filepath);
+			return false;
+		}
+
+		++result.file_count;
+		result.raw_size += raw.size();
+		result.compressed_size += compressed.size();
+		result.compress_time += compress_time;
+		result.parallel_time += parallel_time;
+		result.serial_time += serial_time;
+		return true;
+	}
+
+	SV_AUX void log_compression_benchmark(const char* name, const CompressionBenchmarkResult& result)
+	{
+		constexpr f64 MB = 1024.0 * 1024.0;
+		
+		f64 raw_size = f64(result.raw_size) / MB;
+		f64 compressed_size = f64(result.compressed_size) / MB;
+
+		SV_LOG_INFO("'%s' (%u files): %.2f MB -> %.2f MB, ratio %.2f", name, result.file_count, f32(raw_size), f32(compressed_size), f32(raw_size / SV_MAX(compressed_size, 0.000001)));
+		SV_LOG_INFO("Compress %.2f ms, decompress %.2f ms (%.2f ms in one thread)", f32(result.compress_time * 1000.0), f32(result.parallel_time * 1000.0), f32(result.serial_time * 1000.0));
+
+		// Network mount, HDD and SSD
+		const f64 read_speeds[] = { 30.0, 120.0, 500.0 };
+
+		for (f64 speed : read_speeds) {
+
+			f64 raw_load = raw_size / speed;
+			f64 compressed_load = compressed_size / speed + result.parallel_time;
+			
+			SV_LOG_INFO("%.0f MB/s: raw %.2f ms, compressed %.2f ms", f32(speed), f32(raw_load * 1000.0), f32(compressed_load * 1000.0));
+		}
+	}
+
+	// The file types saved by the engine, the bin files are always compressed
+	constexpr const char* COMPRESSION_BENCHMARK_EXTENSIONS[] = { "scene", "prefab", "mesh" };
+	constexpr u32 COMPRESSION_BENCHMARK_TYPES = SV_ARRAY_SIZE(COMPRESSION_BENCHMARK_EXTENSIONS);
+
+	SV_AUX void compression_benchmark_folder(const char* folder, CompressionBenchmarkResult* results)
+	{
+		FolderIterator it;
+		FolderElement e;
+
+		if (folder_iterator_begin(folder, &it, &e)) {
+
+			do {
+
+				if (string_equals(e.name, ".") || string_equals(e.name, "..")) continue;
+
+				char filepath[FILEPATH_SIZE + 1u];
+				string_copy(filepath, folder, FILEPATH_SIZE + 1u);
+				
+				size_t size = string_size(filepath);
+				if (size && filepath[size - 1u] != '/') string_append(filepath, "/", FILEPATH_SIZE + 1u);
+				string_append(filepath, e.name, FILEPATH_SIZE + 1u);
+
+				if (e.is_file) {
+
+					if (e.extension == NULL) continue;
+
+					foreach(i, COMPRESSION_BENCHMARK_TYPES) {
+						if (string_equals(e.extension, COMPRESSION_BENCHMARK_EXTENSIONS[i]))
+							compression_benchmark_file(filepath, results[i]);
+					}
+				}
+				else compression_benchmark_folder(filepath, results);
+			}
+			while (folder_iterator_next(&it, &e));
+
+			folder_iterator_close(&it);
+		}
+	}
+
+	void compression_benchmark(const char* filepath)
+	{
+		FolderIterator it;
+		FolderElement e;
+
+		if (folder_iterator_begin(filepath, &it, &e)) {
+
+			folder_iterator_close(&it);
+
+			CompressionBenchmarkResult results[COMPRESSION_BENCHMARK_TYPES];
+			compression_benchmark_folder(filepath, results);
+
+			bool empty = true;
+
+			foreach(i, COMPRESSION_BENCHMARK_TYPES) {
+
+				if (results[i].file_count == 0u) continue;
+
+				char name[20u] = ".";
+				string_append(name, COMPRESSION_BENCHMARK_EXTENSIONS[i], 20u);
+				
+				log_compression_benchmark(name, results[i]);
+				empty = false;
+			}
+
+			if (empty) SV_LOG_ERROR("There are no scenes, prefabs or meshes in '%s'", filepath);
+			return;
+		}
+
+		CompressionBenchmarkResult result;
+		
+		if (compression_benchmark_file(filepath, result))
+			log_compression_benchmark(filepath, result);
+	}
 }